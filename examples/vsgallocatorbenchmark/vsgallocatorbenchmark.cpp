@@ -0,0 +1,111 @@
+/* <editor-fold desc="MIT License">
+
+Copyright(c) 2024 Robert Osfield
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"), to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+</editor-fold> */
+
+#include <vsg/core/IntrusiveAllocator.h>
+#include <vsg/threading/Latch.h>
+#include <vsg/utils/CommandLine.h>
+
+#include <algorithm>
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <thread>
+#include <vector>
+
+// Measures the throughput of vsg::allocate()/vsg::deallocate() as the number of threads increases from 1 to N.
+// Each thread repeatedly allocates a batch of small allocations of random size and affinity, then deallocates them in random order.
+// Run with --no-thread-cache to compare against the IntrusiveAllocator with its per thread caches disabled.
+
+struct Allocation
+{
+    void* ptr;
+    std::size_t size;
+};
+
+static void run(size_t iterations, size_t batchSize, size_t maximumSize, unsigned seed)
+{
+    std::mt19937 generator(seed);
+    std::uniform_int_distribution<size_t> sizeDistribution(8, maximumSize);
+    std::uniform_int_distribution<int> affinityDistribution(vsg::ALLOCATOR_AFFINITY_OBJECTS, vsg::ALLOCATOR_AFFINITY_NODES);
+
+    std::vector<Allocation> allocations(batchSize);
+    for (size_t i = 0; i < iterations; ++i)
+    {
+        for (auto& allocation : allocations)
+        {
+            allocation.size = sizeDistribution(generator);
+            allocation.ptr = vsg::allocate(allocation.size, static_cast<vsg::AllocatorAffinity>(affinityDistribution(generator)));
+            *static_cast<char*>(allocation.ptr) = 1;
+        }
+
+        std::shuffle(allocations.begin(), allocations.end(), generator);
+
+        for (auto& allocation : allocations)
+        {
+            vsg::deallocate(allocation.ptr, allocation.size);
+        }
+    }
+}
+
+int main(int argc, char** argv)
+{
+    vsg::CommandLine arguments(&argc, argv);
+
+    size_t maximumThreads = std::max(std::thread::hardware_concurrency(), 1u);
+    size_t iterations = 1000;
+    size_t batchSize = 1000;
+    size_t maximumSize = 256;
+    arguments.read({"--threads", "-t"}, maximumThreads);
+    arguments.read({"--iterations", "-i"}, iterations);
+    arguments.read({"--batch", "-b"}, batchSize);
+    arguments.read({"--size", "-s"}, maximumSize);
+    bool disableThreadCache = arguments.read("--no-thread-cache");
+
+    if (arguments.errors()) return arguments.writeErrorMessages(std::cerr);
+
+    auto intrusiveAllocator = dynamic_cast<vsg::IntrusiveAllocator*>(vsg::Allocator::instance().get());
+    if (intrusiveAllocator && disableThreadCache) intrusiveAllocator->threadCacheMaximumAllocationSize = 0;
+
+    std::cout << "threads, time (ms), allocations/deallocation pairs per second, speed up" << std::endl;
+
+    double singleThreadedRate = 0.0;
+    for (size_t numThreads = 1; numThreads <= maximumThreads; ++numThreads)
+    {
+        auto ready = vsg::Latch::create(static_cast<int>(numThreads));
+        auto start = vsg::Latch::create(1);
+
+        std::vector<std::thread> threads;
+        for (size_t t = 0; t < numThreads; ++t)
+        {
+            threads.emplace_back([&, t]() {
+                ready->count_down();
+                start->wait();
+                run(iterations, batchSize, maximumSize, static_cast<unsigned>(t));
+            });
+        }
+
+        ready->wait();
+        auto startTime = std::chrono::steady_clock::now();
+        start->count_down();
+
+        for (auto& thread : threads) thread.join();
+
+        double duration = std::chrono::duration<double>(std::chrono::steady_clock::now() - startTime).count();
+        double rate = static_cast<double>(numThreads * iterations * batchSize) / duration;
+        if (numThreads == 1) singleThreadedRate = rate;
+
+        std::cout << numThreads << ", " << std::fixed << std::setprecision(1) << duration * 1000.0 << ", " << std::setprecision(0) << rate << ", " << std::setprecision(2) << rate / singleThreadedRate << std::endl;
+    }
+
+    return 0;
+}
@@ -0,0 +1,113 @@
+/* <editor-fold desc="MIT License">
+
+Copyright(c) 2024 Robert Osfield
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"), to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+</editor-fold> */
+
+#include <vsg/core/Array.h>
+#include <vsg/core/Value.h>
+#include <vsg/io/Options.h>
+#include <vsg/io/VSG.h>
+#include <vsg/nodes/Group.h>
+#include <vsg/nodes/MatrixTransform.h>
+#include <vsg/utils/CommandLine.h>
+
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <sstream>
+#include <string>
+
+// Measures the time taken to load a scene graph from .vsgt text compared to the same scene graph in .vsgb, read from memory so that file I/O isn't included.
+// The scene is a Group of MatrixTransforms with random matrices, each with vec3 and uint arrays and a string as user objects.
+// The loaded .vsgt scene is written back to text to check that the parser produces the same objects as were written.
+
+using Clock = std::chrono::steady_clock;
+
+static std::string write(const vsg::Object* object, vsg::ref_ptr<const vsg::Options> options)
+{
+    std::ostringstream str(std::ios::out | std::ios::binary);
+    vsg::VSG::create()->write(object, str, options);
+    return str.str();
+}
+
+static vsg::ref_ptr<vsg::Object> read(const std::string& data, double& duration)
+{
+    auto start = Clock::now();
+    auto object = vsg::VSG::create()->read(reinterpret_cast<const uint8_t*>(data.data()), data.size());
+    duration += std::chrono::duration<double, std::chrono::milliseconds::period>(Clock::now() - start).count();
+    return object;
+}
+
+int main(int argc, char** argv)
+{
+    vsg::CommandLine arguments(&argc, argv);
+
+    size_t numTransforms = arguments.value<size_t>(10000, {"--transforms", "-t"});
+    size_t numVertices = arguments.value<size_t>(64, {"--vertices", "-v"});
+    size_t numRuns = arguments.value<size_t>(5, {"--runs", "-r"});
+    unsigned seed = arguments.value<unsigned>(1, "--seed");
+
+    if (arguments.errors()) return arguments.writeErrorMessages(std::cerr);
+
+    std::mt19937 generator(seed);
+    std::uniform_real_distribution<float> distribution(-1000.0f, 1000.0f);
+
+    auto scene = vsg::Group::create();
+    for (size_t i = 0; i < numTransforms; ++i)
+    {
+        auto transform = vsg::MatrixTransform::create(vsg::translate(double(distribution(generator)), double(distribution(generator)), double(distribution(generator))) * vsg::rotate(double(distribution(generator)), vsg::dvec3(0.0, 0.0, 1.0)));
+
+        auto vertices = vsg::vec3Array::create(numVertices);
+        for (auto& v : *vertices) v.set(distribution(generator), distribution(generator), distribution(generator));
+
+        auto indices = vsg::uintArray::create(numVertices * 3);
+        for (size_t j = 0; j < indices->size(); ++j) indices->set(j, static_cast<uint32_t>(j % numVertices));
+
+        transform->setObject("vertices", vertices);
+        transform->setObject("indices", indices);
+        transform->setValue("name", std::string("transform \"") + std::to_string(i) + "\"");
+        scene->addChild(transform);
+    }
+
+    auto binaryOptions = vsg::Options::create();
+    binaryOptions->extensionHint = ".vsgb";
+
+    std::string text = write(scene.get(), {});
+    std::string binary = write(scene.get(), binaryOptions);
+
+    double textDuration = 0.0, binaryDuration = 0.0;
+    for (size_t run = 0; run < numRuns; ++run)
+    {
+        auto textScene = read(text, textDuration);
+        auto binaryScene = read(binary, binaryDuration);
+
+        if (!textScene || !binaryScene)
+        {
+            std::cerr << "Failed to read scene." << std::endl;
+            return 1;
+        }
+
+        if (run == 0 && write(textScene.get(), {}) != text)
+        {
+            std::cerr << "Scene read from .vsgt doesn't match the scene written." << std::endl;
+            return 1;
+        }
+    }
+
+    double textSize = double(text.size()) / (1024.0 * 1024.0);
+    double binarySize = double(binary.size()) / (1024.0 * 1024.0);
+    std::cout << std::fixed << std::setprecision(2);
+    std::cout << std::setw(8) << "" << std::setw(12) << "size MB" << std::setw(12) << "read ms" << std::setw(12) << "MB/s" << std::endl;
+    std::cout << std::setw(8) << ".vsgt" << std::setw(12) << textSize << std::setw(12) << textDuration / numRuns << std::setw(12) << textSize * 1000.0 * numRuns / textDuration << std::endl;
+    std::cout << std::setw(8) << ".vsgb" << std::setw(12) << binarySize << std::setw(12) << binaryDuration / numRuns << std::setw(12) << binarySize * 1000.0 * numRuns / binaryDuration << std::endl;
+
+    return 0;
+}
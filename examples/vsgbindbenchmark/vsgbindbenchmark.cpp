@@ -0,0 +1,150 @@
+/* <editor-fold desc="MIT License">
+
+Copyright(c) 2024 Robert Osfield
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"), to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+</editor-fold> */
+
+#include <vsg/app/RecordTraversal.h>
+#include <vsg/commands/Command.h>
+#include <vsg/nodes/Bin.h>
+#include <vsg/state/StateCommand.h>
+#include <vsg/utils/CommandLine.h>
+#include <vsg/vk/CommandBuffer.h>
+#include <vsg/vk/CommandPool.h>
+#include <vsg/vk/Device.h>
+#include <vsg/vk/Instance.h>
+#include <vsg/vk/State.h>
+
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <vector>
+
+// Counts the StateCommands that vsg::State binds when recording a Bin of draws that share a small number of pipelines (slot 0)
+// and descriptor sets (slot 1), comparing NO_SORT with STATE_SORT.
+// The StateCommands and draws only count their calls so no Vulkan commands are recorded, but a Device is still created
+// to allocate the CommandBuffer that vsg::State records to.
+
+class CountingStateCommand : public vsg::Inherit<vsg::StateCommand, CountingStateCommand>
+{
+public:
+    explicit CountingStateCommand(uint32_t in_slot) :
+        Inherit(in_slot) {}
+
+    mutable uint64_t count = 0;
+
+    void record(vsg::CommandBuffer&) const override { ++count; }
+};
+
+class CountingDraw : public vsg::Inherit<vsg::Command, CountingDraw>
+{
+public:
+    mutable uint64_t count = 0;
+
+    void record(vsg::CommandBuffer&) const override { ++count; }
+};
+
+template<class T>
+uint64_t sumCounts(const std::vector<vsg::ref_ptr<T>>& objects)
+{
+    uint64_t total = 0;
+    for (auto& object : objects)
+    {
+        total += object->count;
+        object->count = 0;
+    }
+    return total;
+}
+
+int main(int argc, char** argv)
+{
+    vsg::CommandLine arguments(&argc, argv);
+
+    size_t numElements = arguments.value<size_t>(100000, {"--elements", "-n"});
+    size_t numPipelines = arguments.value<size_t>(8, {"--pipelines", "-p"});
+    size_t numDescriptorSets = arguments.value<size_t>(256, {"--descriptor-sets", "-d"});
+    size_t numFrames = arguments.value<size_t>(10, {"--frames", "-f"});
+    unsigned seed = arguments.value<unsigned>(1, "--seed");
+
+    if (arguments.errors()) return arguments.writeErrorMessages(std::cerr);
+
+    auto instance = vsg::Instance::create(vsg::Names{}, vsg::Names{});
+    auto physicalDevice = instance->getPhysicalDevice(VK_QUEUE_GRAPHICS_BIT);
+    if (!physicalDevice)
+    {
+        std::cerr << "No Vulkan PhysicalDevice with graphics queue available." << std::endl;
+        return 1;
+    }
+
+    int queueFamily = physicalDevice->getQueueFamily(VK_QUEUE_GRAPHICS_BIT);
+    vsg::QueueSettings queueSettings{vsg::QueueSetting{queueFamily, {1.0f}}};
+    auto device = vsg::Device::create(physicalDevice, queueSettings, vsg::Names{}, vsg::Names{});
+    auto commandPool = vsg::CommandPool::create(device, queueFamily);
+    auto commandBuffer = commandPool->allocate();
+
+    std::vector<vsg::ref_ptr<CountingStateCommand>> pipelines;
+    for (size_t i = 0; i < numPipelines; ++i) pipelines.push_back(CountingStateCommand::create(0));
+
+    std::vector<vsg::ref_ptr<CountingStateCommand>> descriptorSets;
+    for (size_t i = 0; i < numDescriptorSets; ++i) descriptorSets.push_back(CountingStateCommand::create(1));
+
+    std::vector<vsg::ref_ptr<CountingDraw>> draws;
+    draws.push_back(CountingDraw::create());
+
+    std::cout << numElements << " draws, " << numPipelines << " pipelines, " << numDescriptorSets << " descriptor sets, "
+              << numElements * 2 << " StateCommands pushed per frame" << std::endl;
+    std::cout << std::setw(12) << "sort" << std::setw(16) << "binds/frame" << std::setw(16) << "draws/frame" << std::setw(16) << "ms/frame" << std::endl;
+
+    for (auto sortOrder : {vsg::Bin::NO_SORT, vsg::Bin::STATE_SORT})
+    {
+        auto recordTraversal = vsg::RecordTraversal::create();
+        auto state = recordTraversal->getState();
+        state->_commandBuffer = commandBuffer;
+
+        // the same random sequence of state for each sort order
+        std::mt19937 generator(seed);
+        std::uniform_int_distribution<size_t> pipelineDistribution(0, numPipelines - 1);
+        std::uniform_int_distribution<size_t> descriptorSetDistribution(0, numDescriptorSets - 1);
+        std::uniform_real_distribution<double> distanceDistribution(1.0, 1000.0);
+
+        auto bin = vsg::Bin::create(0, sortOrder);
+        for (size_t i = 0; i < numElements; ++i)
+        {
+            state->stateStacks[0].push(pipelines[pipelineDistribution(generator)]);
+            state->stateStacks[1].push(descriptorSets[descriptorSetDistribution(generator)]);
+            bin->add(state, distanceDistribution(generator), draws.front().get());
+            state->stateStacks[1].pop();
+            state->stateStacks[0].pop();
+        }
+
+        sumCounts(pipelines);
+        sumCounts(descriptorSets);
+        sumCounts(draws);
+
+        auto start = std::chrono::steady_clock::now();
+        for (size_t frame = 0; frame < numFrames; ++frame)
+        {
+            state->resetLastRecorded();
+            bin->traverse(*recordTraversal);
+        }
+        auto duration = std::chrono::duration<double, std::chrono::milliseconds::period>(std::chrono::steady_clock::now() - start).count();
+
+        uint64_t binds = sumCounts(pipelines) + sumCounts(descriptorSets);
+        uint64_t numDraws = sumCounts(draws);
+
+        std::cout << std::setw(12) << (sortOrder == vsg::Bin::STATE_SORT ? "STATE_SORT" : "NO_SORT")
+                  << std::setw(16) << binds / numFrames << std::setw(16) << numDraws / numFrames
+                  << std::setw(16) << duration / static_cast<double>(numFrames) << std::endl;
+
+        state->_commandBuffer = {};
+    }
+
+    return 0;
+}
@@ -0,0 +1,175 @@
+/* <editor-fold desc="MIT License">
+
+Copyright(c) 2024 Robert Osfield
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"), to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+</editor-fold> */
+
+#include <vsg/io/DatabasePager.h>
+#include <vsg/threading/atomics.h>
+#include <vsg/utils/CommandLine.h>
+
+#include <algorithm>
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+#include <limits>
+#include <list>
+#include <mutex>
+#include <random>
+#include <vector>
+
+// Measures the cost of the DatabaseQueue operations used by the DatabasePager when a large number of PagedLOD requests are queued.
+//   add     - queue all the requests with random priorities.
+//   update  - raise the priority of a fraction of the requests with exchange_if_greater() as done by the RecordTraversal for repeat requests.
+//   remove  - remove the requests that weren't traversed in the last frame, as done by DatabasePager::updateSceneGraph().
+//   take    - take the remaining requests one at a time in priority order, as done by the read threads.
+// The DatabaseQueue is compared against a std::list that is scanned for the highest priority request by each take, as used prior to the indexed heap.
+
+using Clock = std::chrono::steady_clock;
+
+static double milliseconds(Clock::time_point start)
+{
+    return std::chrono::duration<double, std::chrono::milliseconds::period>(Clock::now() - start).count();
+}
+
+// reference implementation of the DatabaseQueue operations using a std::list that is scanned for the highest priority request
+struct ListQueue
+{
+    std::mutex mutex;
+    std::list<vsg::ref_ptr<vsg::PagedLOD>> nodes;
+
+    void add(vsg::ref_ptr<vsg::PagedLOD> plod)
+    {
+        std::scoped_lock lock(mutex);
+        nodes.push_back(plod);
+    }
+
+    void updatePriority(const vsg::PagedLOD*)
+    {
+        // the priority is read when scanning the list
+    }
+
+    template<class Predicate>
+    void take_if(Predicate predicate)
+    {
+        std::scoped_lock lock(mutex);
+        nodes.remove_if([&](const vsg::ref_ptr<vsg::PagedLOD>& plod) { return predicate(*plod); });
+    }
+
+    size_t size()
+    {
+        std::scoped_lock lock(mutex);
+        return nodes.size();
+    }
+
+    vsg::ref_ptr<vsg::PagedLOD> take_when_available()
+    {
+        std::scoped_lock lock(mutex);
+        if (nodes.empty()) return {};
+
+        auto itr = std::max_element(nodes.begin(), nodes.end(), [](const vsg::ref_ptr<vsg::PagedLOD>& lhs, const vsg::ref_ptr<vsg::PagedLOD>& rhs) { return lhs->priority < rhs->priority; });
+        auto plod = *itr;
+        nodes.erase(itr);
+        return plod;
+    }
+};
+
+struct Timings
+{
+    double add = 0.0;
+    double update = 0.0;
+    double remove = 0.0;
+    double take = 0.0;
+};
+
+template<class Queue>
+bool run(Queue& queue, const std::vector<vsg::ref_ptr<vsg::PagedLOD>>& plods, const std::vector<double>& priorities, const std::vector<double>& updates, uint64_t frameCount, Timings& timings)
+{
+    for (size_t i = 0; i < plods.size(); ++i) plods[i]->priority = priorities[i];
+
+    auto start = Clock::now();
+    for (auto& plod : plods) queue.add(plod);
+    timings.add += milliseconds(start);
+
+    start = Clock::now();
+    for (size_t i = 0; i < plods.size(); ++i)
+    {
+        if (updates[i] > 0.0 && vsg::exchange_if_greater(plods[i]->priority, updates[i])) queue.updatePriority(plods[i].get());
+    }
+    timings.update += milliseconds(start);
+
+    start = Clock::now();
+    queue.take_if([frameCount](const vsg::PagedLOD& plod) { return plod.frameHighResLastUsed.load() < frameCount; });
+    timings.remove += milliseconds(start);
+
+    // the requests must be taken in order of decreasing priority
+    bool ordered = true;
+    double previousPriority = std::numeric_limits<double>::max();
+    start = Clock::now();
+    // DatabaseQueue::take_when_available() waits for a request to be added when empty, so only take the queued requests
+    for (size_t numQueued = queue.size(); numQueued > 0; --numQueued)
+    {
+        double priority = queue.take_when_available()->priority;
+        if (priority > previousPriority) ordered = false;
+        previousPriority = priority;
+    }
+    timings.take += milliseconds(start);
+
+    return ordered;
+}
+
+int main(int argc, char** argv)
+{
+    vsg::CommandLine arguments(&argc, argv);
+
+    size_t numRequests = arguments.value<size_t>(10000, {"--requests", "-n"});
+    size_t numRuns = arguments.value<size_t>(5, {"--runs", "-r"});
+    double updateRatio = arguments.value<double>(0.1, {"--update", "-u"});
+    double staleRatio = arguments.value<double>(0.1, {"--stale", "-s"});
+    unsigned seed = arguments.value<unsigned>(1, "--seed");
+
+    if (arguments.errors()) return arguments.writeErrorMessages(std::cerr);
+
+    std::mt19937 generator(seed);
+    std::uniform_real_distribution<double> priorityDistribution(0.0, 1.0);
+    std::uniform_real_distribution<double> ratioDistribution(0.0, 1.0);
+
+    // the requests that are stale weren't traversed in the current frame
+    const uint64_t frameCount = 10;
+    std::vector<vsg::ref_ptr<vsg::PagedLOD>> plods(numRequests);
+    std::vector<double> priorities(numRequests);
+    std::vector<double> updates(numRequests, 0.0);
+    for (size_t i = 0; i < numRequests; ++i)
+    {
+        plods[i] = vsg::PagedLOD::create();
+        plods[i]->frameHighResLastUsed = (ratioDistribution(generator) < staleRatio) ? frameCount - 1 : frameCount;
+        priorities[i] = priorityDistribution(generator);
+        if (ratioDistribution(generator) < updateRatio) updates[i] = priorities[i] + priorityDistribution(generator);
+    }
+
+    auto status = vsg::ActivityStatus::create();
+    auto databaseQueue = vsg::DatabaseQueue::create(status);
+    ListQueue listQueue;
+
+    Timings heapTimings, listTimings;
+    for (size_t runNum = 0; runNum < numRuns; ++runNum)
+    {
+        if (!run(*databaseQueue, plods, priorities, updates, frameCount, heapTimings)) std::cerr << "DatabaseQueue requests not taken in priority order." << std::endl;
+        if (!run(listQueue, plods, priorities, updates, frameCount, listTimings)) std::cerr << "std::list requests not taken in priority order." << std::endl;
+    }
+
+    std::cout << numRequests << " requests, mean of " << numRuns << " runs" << std::endl;
+    std::cout << std::setw(16) << "" << std::setw(12) << "add ms" << std::setw(12) << "update ms" << std::setw(12) << "remove ms" << std::setw(12) << "take ms" << std::endl;
+    for (auto& [name, timings] : {std::make_pair("DatabaseQueue", heapTimings), std::make_pair("std::list", listTimings)})
+    {
+        std::cout << std::setw(16) << name << std::setw(12) << timings.add / numRuns << std::setw(12) << timings.update / numRuns << std::setw(12) << timings.remove / numRuns << std::setw(12) << timings.take / numRuns << std::endl;
+    }
+
+    return 0;
+}
@@ -0,0 +1,94 @@
+/* <editor-fold desc="MIT License">
+
+Copyright(c) 2024 Robert Osfield
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"), to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+</editor-fold> */
+
+#include <vsg/io/ObjectFactory.h>
+#include <vsg/utils/CommandLine.h>
+
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+// Measures the cost of creating the objects read from a binary file via vsg::ObjectFactory, with the classes drawn at random from a typical scene graph mix.
+//   by name      - ObjectFactory::create(className) for every object, as done when every object is written with its class name.
+//   by TypeID    - ObjectFactory::create(TypeID) for every object.
+//   resolved     - the create function looked up once per class table entry with getCreateFunction(), then called for every object, as done by BinaryInput.
+
+template<typename F>
+double time(size_t numObjects, F create)
+{
+    auto start = std::chrono::steady_clock::now();
+    size_t numCreated = 0;
+    for (size_t i = 0; i < numObjects; ++i)
+    {
+        if (create(i)) ++numCreated;
+    }
+    auto duration = std::chrono::duration<double, std::chrono::milliseconds::period>(std::chrono::steady_clock::now() - start).count();
+    if (numCreated != numObjects) std::cerr << "Only created " << numCreated << " of " << numObjects << " objects." << std::endl;
+    return duration;
+}
+
+int main(int argc, char** argv)
+{
+    vsg::CommandLine arguments(&argc, argv);
+
+    size_t numObjects = arguments.value<size_t>(1000000, {"--objects", "-n"});
+    size_t numRuns = arguments.value<size_t>(5, {"--runs", "-r"});
+    unsigned seed = arguments.value<unsigned>(1, "--seed");
+
+    if (arguments.errors()) return arguments.writeErrorMessages(std::cerr);
+
+    std::vector<std::string> classNames{"vsg::Group", "vsg::MatrixTransform", "vsg::Objects", "vsg::vec2Array", "vsg::vec3Array", "vsg::vec4Array", "vsg::ushortArray", "vsg::uintArray", "vsg::floatValue", "vsg::stringValue"};
+
+    auto objectFactory = vsg::ObjectFactory::instance();
+
+    // class table, with each object referring to an entry as BinaryInput does
+    std::vector<vsg::ObjectFactory::TypeID> typeIDs;
+    std::vector<const vsg::ObjectFactory::CreateFunction*> createFunctions;
+    for (auto& className : classNames)
+    {
+        typeIDs.push_back(vsg::ObjectFactory::typeID(className));
+        createFunctions.push_back(objectFactory->getCreateFunction(className));
+        if (!createFunctions.back())
+        {
+            std::cerr << className << " not registered with the ObjectFactory." << std::endl;
+            return 1;
+        }
+    }
+
+    std::mt19937 generator(seed);
+    std::uniform_int_distribution<uint32_t> classDistribution(0, static_cast<uint32_t>(classNames.size() - 1));
+    std::vector<uint32_t> classIndices(numObjects);
+    for (auto& classIndex : classIndices) classIndex = classDistribution(generator);
+
+    std::cout << std::setw(8) << "run" << std::setw(16) << "by name ms" << std::setw(16) << "by TypeID ms" << std::setw(16) << "resolved ms" << std::endl;
+
+    double total[3] = {0.0, 0.0, 0.0};
+    for (size_t run = 0; run < numRuns; ++run)
+    {
+        double byName = time(numObjects, [&](size_t i) { return objectFactory->create(classNames[classIndices[i]]).valid(); });
+        double byTypeID = time(numObjects, [&](size_t i) { return objectFactory->create(typeIDs[classIndices[i]]).valid(); });
+        double resolved = time(numObjects, [&](size_t i) { return (*createFunctions[classIndices[i]])().valid(); });
+
+        std::cout << std::setw(8) << run << std::setw(16) << byName << std::setw(16) << byTypeID << std::setw(16) << resolved << std::endl;
+
+        total[0] += byName;
+        total[1] += byTypeID;
+        total[2] += resolved;
+    }
+
+    std::cout << std::setw(8) << "mean" << std::setw(16) << total[0] / numRuns << std::setw(16) << total[1] / numRuns << std::setw(16) << total[2] / numRuns << std::endl;
+
+    return 0;
+}
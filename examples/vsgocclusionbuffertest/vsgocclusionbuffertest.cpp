@@ -0,0 +1,127 @@
+/* <editor-fold desc="MIT License">
+
+Copyright(c) 2024 Robert Osfield
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"), to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+</editor-fold> */
+
+#include <vsg/maths/transform.h>
+#include <vsg/utils/CommandLine.h>
+#include <vsg/utils/OcclusionBuffer.h>
+
+#include <iostream>
+#include <limits>
+
+// Headless checks of the OcclusionBuffer rasterization and occlusion tests, no Vulkan device is required.
+// An orthographic projection maps eye coordinates one to one onto the 256 x 128 depth buffer so that occluder edges
+// and spheres can be placed at known fractions of a pixel. Returns 0 if all the checks pass, 1 otherwise.
+
+static int numFailures = 0;
+
+static void check(bool result, bool expected, const char* description)
+{
+    std::cout << (result == expected ? "passed : " : "FAILED : ") << description << std::endl;
+    if (result != expected) ++numFailures;
+}
+
+static vsg::ref_ptr<vsg::Occluder> createQuad(float x0, float x1, float z0, float z1)
+{
+    // quad spanning the full height of the depth buffer, with depth varying linearly from z0 at x0 to z1 at x1
+    auto vertices = vsg::vec3Array::create({{x0, -1000.0f, z0}, {x1, -1000.0f, z1}, {x1, 1000.0f, z1}, {x0, 1000.0f, z0}});
+    auto indices = vsg::uintArray::create({0, 1, 2, 0, 2, 3});
+    return vsg::Occluder::create(vertices, indices);
+}
+
+int main(int argc, char** argv)
+{
+    vsg::CommandLine arguments(&argc, argv);
+
+    uint32_t numThreads = 1;
+    arguments.read({"--threads", "-t"}, numThreads);
+
+    if (arguments.errors()) return arguments.writeErrorMessages(std::cerr);
+
+    auto projection = vsg::orthographic(0.0, 256.0, 0.0, 128.0, 1.0, 1000.0);
+    vsg::dmat4 view;
+
+    // flat occluder at z = -10 whose right edge at x = 100.7 crosses the center of pixel 100
+    {
+        auto occlusionBuffer = vsg::OcclusionBuffer::create(256, 128);
+        occlusionBuffer->numThreads = numThreads;
+        occlusionBuffer->occluders.push_back(createQuad(0.0f, 100.7f, -10.0f, -10.0f));
+        occlusionBuffer->rasterize(projection, view);
+
+        check(occlusionBuffer->occluded(vsg::dsphere(50.0, 64.0, -20.0, 5.0)), true, "sphere behind the occluder is occluded");
+        check(occlusionBuffer->occluded(vsg::dsphere(50.0, 64.0, -5.0, 2.0)), false, "sphere in front of the occluder is not occluded");
+        check(occlusionBuffer->occluded(vsg::dsphere(99.0, 64.0, -20.0, 0.45)), true, "sphere behind fully covered pixels is occluded");
+
+        // the sphere covers x = 100.45 to 100.75 so sticks out past the occluder edge, pixel 100 is only partially covered
+        check(occlusionBuffer->occluded(vsg::dsphere(100.6, 64.0, -20.0, 0.15)), false, "sphere behind a partially covered pixel is not occluded");
+
+        // pixel 100 must not be written at all
+        check(occlusionBuffer->depth()[64 * occlusionBuffer->width + 100] == std::numeric_limits<float>::max(), true, "partially covered pixel is left clear");
+
+        // the quad's diagonal crosses pixel 53 on row 64, neither triangle covers the pixel alone but the pair do
+        check(occlusionBuffer->depth()[64 * occlusionBuffer->width + 53] < std::numeric_limits<float>::max(), true, "pixel straddling an edge shared by two triangles is written");
+    }
+
+    // two triangles sharing the edge at x = 60.5 but folded over so both lie to the left of it
+    {
+        auto vertices = vsg::vec3Array::create({{60.5f, -1000.0f, -10.0f}, {60.5f, 1000.0f, -10.0f}, {0.0f, 0.0f, -10.0f}, {10.0f, 0.0f, -10.0f}});
+        auto indices = vsg::uintArray::create({0, 1, 2, 1, 0, 3});
+
+        auto occlusionBuffer = vsg::OcclusionBuffer::create(256, 128);
+        occlusionBuffer->numThreads = numThreads;
+        occlusionBuffer->occluders.push_back(vsg::Occluder::create(vertices, indices));
+        occlusionBuffer->rasterize(projection, view);
+
+        check(occlusionBuffer->depth()[64 * occlusionBuffer->width + 60] == std::numeric_limits<float>::max(), true, "pixel straddling a folded shared edge is left clear");
+        check(occlusionBuffer->occluded(vsg::dsphere(60.7, 64.0, -20.0, 0.1)), false, "sphere behind a folded shared edge is not occluded");
+    }
+
+    // occluder tilted in depth, z = -10 - 0.5 * x, so the depth varies by 0.5 across each pixel
+    {
+        auto occlusionBuffer = vsg::OcclusionBuffer::create(256, 128);
+        occlusionBuffer->numThreads = numThreads;
+        occlusionBuffer->occluders.push_back(createQuad(0.0f, 256.0f, -10.0f, -138.0f));
+        occlusionBuffer->rasterize(projection, view);
+
+        // the sphere lies within pixel 50, x = 50.85 to 50.95, entirely in front of the occluder which is at z = -35.45 at x = 50.9,
+        // but its nearest point at z = -35.27 is behind the occluder depth at the pixel center, z = -35.25
+        check(occlusionBuffer->occluded(vsg::dsphere(50.9, 64.0, -35.32, 0.05)), false, "sphere in front of a sloped occluder is not occluded");
+
+        // nearest point at z = -35.6 is behind the occluder across the whole of pixel 50, z = -35.0 to -35.5
+        check(occlusionBuffer->occluded(vsg::dsphere(50.5, 64.0, -35.65, 0.05)), true, "sphere behind a sloped occluder is occluded");
+    }
+
+    // each viewID has its own depth buffer, so Views sharing an OcclusionBuffer don't overwrite each other's results
+    {
+        auto occlusionBuffer = vsg::OcclusionBuffer::create(256, 128);
+        occlusionBuffer->numThreads = numThreads;
+        occlusionBuffer->occluders.push_back(createQuad(0.0f, 100.7f, -10.0f, -10.0f));
+
+        // viewID 1 looks at the occluder from the other side of the x axis, so the occluder covers x = 155.3 to 256
+        vsg::dmat4 mirrorView = vsg::translate(256.0, 0.0, 0.0) * vsg::scale(-1.0, 1.0, 1.0);
+        occlusionBuffer->rasterize(projection, view, 0);
+        occlusionBuffer->rasterize(projection, mirrorView, 1);
+
+        check(occlusionBuffer->occluded(vsg::dsphere(50.0, 64.0, -20.0, 5.0), 0), true, "sphere behind the occluder in viewID 0 is occluded");
+        check(occlusionBuffer->occluded(vsg::dsphere(50.0, 64.0, -20.0, 5.0), 1), false, "same sphere in viewID 1 is not occluded");
+        check(occlusionBuffer->occluded(vsg::dsphere(206.0, 64.0, -20.0, 5.0), 1), true, "sphere behind the mirrored occluder in viewID 1 is occluded");
+        check(occlusionBuffer->occluded(vsg::dsphere(50.0, 64.0, -20.0, 5.0), 2), false, "sphere in a viewID that hasn't been rasterized is not occluded");
+    }
+
+    if (numFailures > 0)
+    {
+        std::cout << numFailures << " checks failed." << std::endl;
+        return 1;
+    }
+
+    std::cout << "All checks passed." << std::endl;
+    return 0;
+}
@@ -0,0 +1,121 @@
+/* <editor-fold desc="MIT License">
+
+Copyright(c) 2024 Robert Osfield
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"), to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+</editor-fold> */
+
+#include <vsg/maths/transform.h>
+#include <vsg/nodes/PackedBounds.h>
+#include <vsg/utils/CommandLine.h>
+#include <vsg/vk/State.h>
+
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <vector>
+
+// Measures the cost of culling the children of a Group against the view frustum, with the children's bounds scattered around the view center.
+//   Frustum      - Frustum::intersect(sphere) for each child, as done for CullGroup/CullNode children without Group::childBounds.
+//   scalar       - PackedBounds::intersect_scalar(), the batched test without SIMD.
+//   PackedBounds - PackedBounds::intersect(), the batched test using AVX or SSE2 when enabled at compile time, as done with Group::childBounds.
+
+template<typename F>
+double time(size_t numIterations, size_t& numVisible, F intersect)
+{
+    auto start = std::chrono::steady_clock::now();
+    numVisible = 0;
+    for (size_t i = 0; i < numIterations; ++i)
+    {
+        numVisible += intersect();
+    }
+    return std::chrono::duration<double, std::chrono::milliseconds::period>(std::chrono::steady_clock::now() - start).count();
+}
+
+int main(int argc, char** argv)
+{
+    vsg::CommandLine arguments(&argc, argv);
+
+    size_t numChildren = arguments.value<size_t>(64, {"--children", "-c"});
+    size_t numIterations = arguments.value<size_t>(100000, {"--iterations", "-i"});
+    size_t numRuns = arguments.value<size_t>(5, {"--runs", "-r"});
+    double extents = arguments.value<double>(500.0, {"--extents", "-e"});
+    unsigned seed = arguments.value<unsigned>(1, "--seed");
+
+    if (arguments.errors()) return arguments.writeErrorMessages(std::cerr);
+
+    std::mt19937 generator(seed);
+    std::uniform_real_distribution<double> position(-extents, extents);
+    std::uniform_real_distribution<double> radius(1.0, extents * 0.02);
+
+    // offset the spheres from the world origin so that the PackedBounds origin and float conversion are exercised
+    vsg::dvec3 offset(1.0e5, 2.0e5, 0.0);
+    std::vector<vsg::dsphere> spheres(numChildren);
+    for (auto& sphere : spheres) sphere.set(offset + vsg::dvec3(position(generator), position(generator), position(generator)), radius(generator));
+
+    auto packedBounds = vsg::PackedBounds::create();
+    packedBounds->set(spheres.data(), spheres.size());
+
+    // set up the frustum as vsg::State does for a perspective view looking at the center of the spheres
+    vsg::Frustum frustumUnit;
+    vsg::Frustum frustumProjected(frustumUnit, vsg::perspective(vsg::radians(45.0), 1.5, 1.0, extents * 10.0));
+    vsg::Frustum frustum(frustumProjected, vsg::lookAt(offset + vsg::dvec3(0.0, -extents * 2.0, extents), offset, vsg::dvec3(0.0, 0.0, 1.0)));
+
+    std::vector<uint8_t> visible(numChildren);
+    auto intersectFrustum = [&]() {
+        size_t numVisible = 0;
+        for (size_t i = 0; i < numChildren; ++i)
+        {
+            visible[i] = frustum.intersect(spheres[i]) ? 1 : 0;
+            numVisible += visible[i];
+        }
+        return numVisible;
+    };
+    auto intersectScalar = [&]() { return packedBounds->intersect_scalar(frustum.face, vsg::POLYTOPE_SIZE, visible.data()); };
+    auto intersectPacked = [&]() { return packedBounds->intersect(frustum.face, vsg::POLYTOPE_SIZE, visible.data()); };
+
+    // the packed bounds are padded so that they never cull a child that Frustum::intersect keeps
+    std::vector<uint8_t> frustumVisible(numChildren);
+    intersectFrustum();
+    frustumVisible = visible;
+    intersectPacked();
+    size_t numWronglyCulled = 0;
+    for (size_t i = 0; i < numChildren; ++i)
+    {
+        if (frustumVisible[i] && !visible[i]) ++numWronglyCulled;
+    }
+    if (numWronglyCulled > 0)
+    {
+        std::cerr << numWronglyCulled << " children visible to Frustum::intersect were culled by PackedBounds::intersect." << std::endl;
+        return 1;
+    }
+
+    std::cout << numChildren << " children, " << intersectFrustum() << " visible" << std::endl;
+    std::cout << std::setw(8) << "run" << std::setw(16) << "Frustum ms" << std::setw(16) << "scalar ms" << std::setw(16) << "PackedBounds ms" << std::endl;
+
+    double total[3] = {0.0, 0.0, 0.0};
+    for (size_t run = 0; run < numRuns; ++run)
+    {
+        size_t numVisible[3];
+        double frustumTime = time(numIterations, numVisible[0], intersectFrustum);
+        double scalarTime = time(numIterations, numVisible[1], intersectScalar);
+        double packedTime = time(numIterations, numVisible[2], intersectPacked);
+
+        std::cout << std::setw(8) << run << std::setw(16) << frustumTime << std::setw(16) << scalarTime << std::setw(16) << packedTime << std::endl;
+        if (numVisible[1] != numVisible[2]) std::cerr << "PackedBounds::intersect_scalar() and intersect() results differ." << std::endl;
+
+        total[0] += frustumTime;
+        total[1] += scalarTime;
+        total[2] += packedTime;
+    }
+
+    std::cout << std::setw(8) << "mean" << std::setw(16) << total[0] / numRuns << std::setw(16) << total[1] / numRuns << std::setw(16) << total[2] / numRuns << std::endl;
+
+    return 0;
+}
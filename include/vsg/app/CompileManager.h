@@ -63,8 +63,8 @@ namespace vsg
 
         using ContextSelectionFunction = std::function<bool(vsg::Context&)>;
 
-        /// compile object
-        CompileResult compile(ref_ptr<Object> object, ContextSelectionFunction contextSelection = {});
+        /// compile object, if the activityStatus is cancelled before the compile traversal starts the compile is abandoned and the result is VK_INCOMPLETE.
+        CompileResult compile(ref_ptr<Object> object, ContextSelectionFunction contextSelection = {}, ref_ptr<ActivityStatus> activityStatus = {});
 
     protected:
         using CompileTraversals = ThreadSafeQueue<ref_ptr<CompileTraversal>>;
@@ -0,0 +1,92 @@
+#pragma once
+
+/* <editor-fold desc="MIT License">
+
+Copyright(c) 2024 Robert Osfield
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"), to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+</editor-fold> */
+
+#include <vsg/app/RecordTraversal.h>
+#include <vsg/nodes/Group.h>
+#include <vsg/threading/OperationThreads.h>
+#include <vsg/vk/CommandBuffer.h>
+
+#include <atomic>
+#include <mutex>
+
+namespace vsg
+{
+
+    /// ParallelRecordGroup records its subgraph across multiple threads during the RecordTraversal.
+    /// The children are partitioned following the Group/QuadGroup/CullGroup structure beneath the ParallelRecordGroup,
+    /// each partition is recorded to its own secondary CommandBuffer by a worker thread, with idle workers taking the next
+    /// unrecorded partition so the load is balanced, then the secondary CommandBuffers are executed in partition order via vkCmdExecuteCommands.
+    /// When used within a render pass the RenderGraph/NextSubPass contents must be VK_SUBPASS_CONTENTS_SECONDARY_COMMAND_BUFFERS,
+    /// if not, or when recording to a secondary CommandBuffer, the subgraph is traversed inline by the calling thread.
+    /// Lights within the subgraph are not collected when recording in parallel so should be placed outside the ParallelRecordGroup.
+    class VSG_DECLSPEC ParallelRecordGroup : public Inherit<Group, ParallelRecordGroup>
+    {
+    public:
+        ParallelRecordGroup();
+        ParallelRecordGroup(const ParallelRecordGroup& rhs, const CopyOp& copyop = {});
+
+        /// number of threads used to record the subgraph, including the calling thread, 0 selects std::thread::hardware_concurrency().
+        uint32_t numThreads = 0;
+
+        /// target number of partitions per thread, more partitions improve load balancing at the cost of more secondary CommandBuffers.
+        uint32_t partitionsPerThread = 4;
+
+        /// maximum depth of the Group/QuadGroup/CullGroup hierarchy beneath the ParallelRecordGroup that will be split into partitions.
+        uint32_t maxPartitionDepth = 4;
+
+        /// optional OperationThreads to run the workers, if not assigned OperationThreads with numThreads-1 threads are created on first use.
+        ref_ptr<OperationThreads> operationThreads;
+
+        using Group::accept;
+
+        /// record the subgraph to secondary CommandBuffers using worker threads and execute them from the current CommandBuffer
+        void accept(RecordTraversal& recordTraversal) const override;
+
+    public:
+        ref_ptr<Object> clone(const CopyOp& copyop = {}) const override { return ParallelRecordGroup::create(*this, copyop); }
+        int compare(const Object& rhs) const override;
+
+        void read(Input& input) override;
+        void write(Output& output) const override;
+
+    protected:
+        virtual ~ParallelRecordGroup();
+
+        struct Worker : public Inherit<Object, Worker>
+        {
+            ref_ptr<RecordTraversal> recordTraversal;
+            CommandBuffers commandBuffers;
+        };
+
+        struct RecordOperation;
+
+        void _partition(RecordTraversal& recordTraversal, size_t targetNumPartitions) const;
+        void _record(Worker& worker) const;
+
+        mutable std::mutex _mutex;
+        mutable ref_ptr<OperationThreads> _operationThreads;
+        mutable std::vector<ref_ptr<Worker>> _workers;
+
+        // per frame partitioning and recording data
+        mutable std::vector<const Node*> _nodes;
+        mutable std::vector<const Node*> _expandedNodes;
+        mutable std::vector<ref_ptr<CommandBuffer>> _partitionCommandBuffers;
+        mutable std::vector<VkCommandBuffer> _vk_commandBuffers;
+        mutable std::atomic_size_t _nextPartition{0};
+        mutable size_t _numPartitions = 0;
+        mutable RecordTraversal* _parent = nullptr;
+    };
+    VSG_type_name(vsg::ParallelRecordGroup);
+
+} // namespace vsg
@@ -12,10 +12,12 @@ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLI
 
 </editor-fold> */
 
+#include <vsg/core/Allocator.h>
 #include <vsg/core/Mask.h>
 #include <vsg/core/Object.h>
 #include <vsg/core/type_name.h>
 #include <vsg/maths/mat4.h>
+#include <vsg/maths/sphere.h>
 
 #include <set>
 #include <vector>
@@ -40,6 +42,7 @@ namespace vsg
     class TileDatabase;
     class VertexDraw;
     class VertexIndexDraw;
+    class CulledInstanceDraw;
     class Geometry;
     class Command;
     class Commands;
@@ -61,6 +64,9 @@ namespace vsg
     class CommandGraph;
     class RecordedCommandBuffers;
     class Instrumentation;
+    class PackedBounds;
+    class OcclusionBuffer;
+    class PagedLODPrefetch;
 
     VSG_type_name(vsg::RecordTraversal);
 
@@ -123,6 +129,7 @@ namespace vsg
         // leaf node
         void apply(const VertexDraw& vid);
         void apply(const VertexIndexDraw& vid);
+        void apply(const CulledInstanceDraw& cid);
         void apply(const Geometry& vid);
 
         // positional state
@@ -157,7 +164,14 @@ namespace vsg
         void clearBins();
 
         // list of pairs of modelview matrix & region of interest
-        std::vector<std::pair<dmat4, const RegionOfInterest*>> regionsOfInterest;
+        transient_vector<std::pair<dmat4, const RegionOfInterest*>> regionsOfInterest;
+
+        /// set up this RecordTraversal to record part of the subgraph being traversed by the parent RecordTraversal, inheriting its masks, FrameStamp, DatabasePager and bins.
+        /// Used by ParallelRecordGroup to record its subgraph from worker threads, lights are not collected by the worker RecordTraversal.
+        void inherit(const RecordTraversal& parent);
+
+        /// add the bin contents, regions of interest and culled PagedLOD collected since inherit() was called to the parent RecordTraversal.
+        void mergeTo(RecordTraversal& parent);
 
     protected:
         virtual ~RecordTraversal();
@@ -168,10 +182,41 @@ namespace vsg
         // used to handle loading of PagedLOD external children.
         ref_ptr<DatabasePager> _databasePager;
         ref_ptr<CulledPagedLODs> _culledPagedLODs;
+        ref_ptr<CulledPagedLODs> _localCulledPagedLODs;
 
         int32_t _minimumBinNumber = 0;
-        std::vector<ref_ptr<Bin>> _bins;
+        transient_vector<ref_ptr<Bin>> _bins;
         ref_ptr<ViewDependentState> _viewDependentState;
+
+        // containers for each level of nested View, reused from frame to frame to avoid per frame allocations
+        size_t _viewDepth = 0;
+        std::vector<decltype(_bins)> _viewBins;
+        std::vector<decltype(regionsOfInterest)> _viewRegionsOfInterest;
+
+        // visibility results of batched culling of Group/QuadGroup children with childBounds
+        std::vector<uint8_t> _childVisibility;
+
+        // occlusion buffer of the current View, nullptr when occlusion culling isn't enabled, and the viewID its depth buffer was rasterized for
+        OcclusionBuffer* _occlusionBuffer = nullptr;
+        uint32_t _occlusionViewID = 0;
+
+        // whether the subgraph being traversed is known to be entirely inside the view frustum, so its CullGroup/CullNode and childBounds tests can be skipped
+        bool _insideFrustum = false;
+
+        // PagedLOD prefetching of the current View, nullptr when prefetching isn't enabled
+        PagedLODPrefetch* _pagedLODPrefetch = nullptr;
+
+        // number of bounding sphere frustum tests done and skipped, reported to the instrumentation at the end of each top level View
+        uint64_t _numCullTests = 0;
+        uint64_t _numCullTestsSkipped = 0;
+
+        bool _visible(const dsphere& bound, bool& inside);
+
+        // test the PagedLOD against the predicted view and request its high res child if it'll be required, returns true if the high res child is required by the predicted view.
+        bool _prefetch(const PagedLOD& plod, uint64_t frameCount);
+
+        template<class C>
+        void _traverseVisibleChildren(const C& children, const PackedBounds& childBounds);
     };
 
 } // namespace vsg
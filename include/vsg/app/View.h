@@ -21,6 +21,8 @@ namespace vsg
 
     // forward declare
     class ViewDependentState;
+    class OcclusionBuffer;
+    class PagedLODPrefetch;
 
     /// ViewFeatures mask provide a means for controlling what features should be implemented by the View's ViewDependentState.
     enum ViewFeatures
@@ -86,6 +88,13 @@ namespace vsg
         /// override states for customization of graphics pipelines for this view
         GraphicsPipelineStates overridePipelineStates;
 
+        /// optional occlusion buffer, when assigned its occluders are rasterized at the start of the RecordTraversal of the View
+        /// and used to cull CullGroup, CullNode and LOD subgraphs that are hidden behind them
+        ref_ptr<OcclusionBuffer> occlusionBuffer;
+
+        /// optional PagedLOD prefetching, when assigned the camera path is extrapolated from previous frames and PagedLOD high resolution children required by the predicted view are requested ahead of time
+        ref_ptr<PagedLODPrefetch> pagedLODPrefetch;
+
     protected:
         virtual ~View();
     };
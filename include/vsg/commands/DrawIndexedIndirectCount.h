@@ -0,0 +1,43 @@
+#pragma once
+
+/* <editor-fold desc="MIT License">
+
+Copyright(c) 2024 Robert Osfield
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"), to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+</editor-fold> */
+
+#include <vsg/commands/Command.h>
+#include <vsg/state/BufferInfo.h>
+
+namespace vsg
+{
+
+    /// DrawIndexedIndirectCount command encapsulates vkCmdDrawIndexedIndirectCount call and associated parameters.
+    /// Requires Vulkan 1.2 with the drawIndirectCount feature enabled, or the VK_KHR_draw_indirect_count extension.
+    class VSG_DECLSPEC DrawIndexedIndirectCount : public Inherit<Command, DrawIndexedIndirectCount>
+    {
+    public:
+        DrawIndexedIndirectCount();
+
+        DrawIndexedIndirectCount(ref_ptr<Data> in_drawParametersData, ref_ptr<Data> in_drawCountData, uint32_t in_maxDrawCount, uint32_t in_stride);
+
+        void read(Input& input) override;
+        void write(Output& output) const override;
+
+        void compile(Context& context) override;
+        void record(CommandBuffer& commandBuffer) const override;
+
+        ref_ptr<BufferInfo> drawParameters;
+        ref_ptr<BufferInfo> drawCount;
+        uint32_t maxDrawCount = 0;
+        uint32_t stride = 0;
+    };
+    VSG_type_name(vsg::DrawIndexedIndirectCount);
+
+} // namespace vsg
@@ -14,9 +14,11 @@ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLI
 
 #include <vsg/core/Export.h>
 
+#include <atomic>
 #include <map>
 #include <memory>
 #include <mutex>
+#include <vector>
 
 namespace vsg
 {
@@ -25,7 +27,8 @@ namespace vsg
         ALLOCATOR_TYPE_NO_DELETE = 0,
         ALLOCATOR_TYPE_NEW_DELETE,
         ALLOCATOR_TYPE_MALLOC_FREE,
-        ALLOCATOR_TYPE_VSG_ALLOCATOR
+        ALLOCATOR_TYPE_VSG_ALLOCATOR,
+        ALLOCATOR_TYPE_MAPPED_FILE // data references the pages of a MappedFile, released with vsg::releaseMappedData()
     };
 
     enum AllocatorAffinity : uint32_t
@@ -89,6 +92,9 @@ namespace vsg
     /// deallocate memory using vsg::Allocator::instance() if available, otherwise use std::free(ptr)
     extern VSG_DECLSPEC void deallocate(void* ptr, std::size_t size = 0);
 
+    /// release data with ALLOCATOR_TYPE_MAPPED_FILE, unreferencing the MappedFile it points into or, for data allocated by copies of mapped data, deallocating with vsg::deallocate().
+    extern VSG_DECLSPEC void releaseMappedData(void* ptr);
+
     /// std container adapter for allocating with specific affinity
     template<typename T, vsg::AllocatorAffinity A>
     struct allocator_affinity_adapter
@@ -131,4 +137,40 @@ namespace vsg
     template<typename T>
     using allocator_affinity_physics = allocator_affinity_adapter<T, vsg::ALLOCATOR_AFFINITY_PHYSICS>;
 
+    /// number of heap allocations made by containers using the transient_allocator, used to check that steady state frame recording doesn't allocate.
+    extern VSG_DECLSPEC std::atomic_size_t& transientAllocationCount();
+
+    /// std container adapter for transient containers that are cleared and refilled each frame, such as those used by RecordTraversal, State and Bin.
+    /// Allocations are made with std::allocator and counted by transientAllocationCount().
+    template<typename T>
+    struct transient_allocator
+    {
+        using value_type = T;
+
+        transient_allocator() = default;
+        template<class U>
+        constexpr transient_allocator(const transient_allocator<U>&) noexcept {}
+
+        value_type* allocate(std::size_t n)
+        {
+            transientAllocationCount().fetch_add(1, std::memory_order_relaxed);
+            return std::allocator<value_type>().allocate(n);
+        }
+
+        void deallocate(value_type* ptr, std::size_t n)
+        {
+            std::allocator<value_type>().deallocate(ptr, n);
+        }
+    };
+
+    template<class T, class U>
+    bool operator==(const transient_allocator<T>&, const transient_allocator<U>&) { return true; }
+
+    template<class T, class U>
+    bool operator!=(const transient_allocator<T>&, const transient_allocator<U>&) { return false; }
+
+    /// std::vector that allocates using the transient_allocator
+    template<typename T>
+    using transient_vector = std::vector<T, transient_allocator<T>>;
+
 } // namespace vsg
@@ -158,6 +158,20 @@ namespace vsg
             {
                 size_t new_total_size = computeValueCountIncludingMipmaps(width_size, 1, 1, properties.maxNumMipmaps);
 
+                input.alignDataPayload();
+                if (auto mapped = input.mapDataPayload(new_total_size * sizeof(value_type), alignof(value_type)))
+                {
+                    // reference the payload directly from the memory mapped file
+                    _delete();
+                    _data = static_cast<value_type*>(mapped);
+                    properties.allocatorType = ALLOCATOR_TYPE_MAPPED_FILE;
+                    properties.stride = sizeof(value_type);
+                    _size = width_size;
+                    _storage = nullptr;
+                    dirty();
+                    return;
+                }
+
                 if (_data) // if data exists already may be able to reuse it
                 {
                     if (original_total_size != new_total_size) // if existing data is a different size delete old, and create new
@@ -196,6 +210,7 @@ namespace vsg
             }
 
             output.writePropertyName("data");
+            output.alignDataPayload();
             output.write(size(), _data);
             output.writeEndOfLine();
         }
@@ -353,6 +368,8 @@ namespace vsg
                     delete[] _data;
                 else if (properties.allocatorType == ALLOCATOR_TYPE_MALLOC_FREE)
                     std::free(_data);
+                else if (properties.allocatorType == ALLOCATOR_TYPE_MAPPED_FILE)
+                    vsg::releaseMappedData(_data);
                 else if (properties.allocatorType != 0)
                     vsg::deallocate(_data);
             }
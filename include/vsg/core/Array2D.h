@@ -137,6 +137,21 @@ namespace vsg
             {
                 size_t new_size = computeValueCountIncludingMipmaps(w, h, 1, properties.maxNumMipmaps);
 
+                input.alignDataPayload();
+                if (auto mapped = input.mapDataPayload(new_size * sizeof(value_type), alignof(value_type)))
+                {
+                    // reference the payload directly from the memory mapped file
+                    _delete();
+                    _data = static_cast<value_type*>(mapped);
+                    properties.allocatorType = ALLOCATOR_TYPE_MAPPED_FILE;
+                    properties.stride = sizeof(value_type);
+                    _width = w;
+                    _height = h;
+                    _storage = nullptr;
+                    dirty();
+                    return;
+                }
+
                 if (_data) // if data exists already may be able to reuse it
                 {
                     if (original_size != new_size) // if existing data is a different size delete old, and create new
@@ -177,6 +192,7 @@ namespace vsg
             }
 
             output.writePropertyName("data");
+            output.alignDataPayload();
             output.write(valueCount(), _data);
             output.writeEndOfLine();
         }
@@ -348,6 +364,8 @@ namespace vsg
                     delete[] _data;
                 else if (properties.allocatorType == ALLOCATOR_TYPE_MALLOC_FREE)
                     std::free(_data);
+                else if (properties.allocatorType == ALLOCATOR_TYPE_MAPPED_FILE)
+                    vsg::releaseMappedData(_data);
                 else if (properties.allocatorType != 0)
                     vsg::deallocate(_data);
             }
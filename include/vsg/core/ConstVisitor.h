@@ -39,6 +39,7 @@ namespace vsg
     class Geometry;
     class VertexDraw;
     class VertexIndexDraw;
+    class CulledInstanceDraw;
     class DepthSorted;
     class Layer;
     class Bin;
@@ -328,6 +329,7 @@ namespace vsg
         virtual void apply(const Geometry&);
         virtual void apply(const VertexDraw&);
         virtual void apply(const VertexIndexDraw&);
+        virtual void apply(const CulledInstanceDraw&);
         virtual void apply(const DepthSorted&);
         virtual void apply(const Layer&);
         virtual void apply(const Bin&);
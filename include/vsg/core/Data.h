@@ -157,6 +157,9 @@ namespace vsg
 
         int compare(const Object& rhs_object) const override;
 
+        /// hash of the type, properties and data contents, cached and only recomputed when dirty() has been called since the last hash() call.
+        std::size_t hash() const override;
+
         void read(Input& input) override;
         void write(Output& output) const override;
 
@@ -216,6 +219,9 @@ namespace vsg
 
         ModifiedCount _modifiedCount;
 
+        mutable std::atomic<std::size_t> _hash{0};
+        mutable std::atomic<uint32_t> _hashModifiedCount{0};
+
 #if 1
     public:
         /// deprecated: provided for backwards compatibility, use Properties instead.
@@ -14,7 +14,10 @@ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLI
 
 #include <vsg/core/Allocator.h>
 
+#include <atomic>
 #include <list>
+#include <set>
+#include <unordered_map>
 #include <vector>
 
 namespace vsg
@@ -41,6 +44,11 @@ namespace vsg
     // The maximum size of allocations within the block allocation is (2^15-2) * 4, allocations larger than this
     // are allocated using aligned versions of std::new and std::delete.
     //
+    // To avoid all threads contending on the Allocator::mutex, small allocations are served from per thread
+    // caches that hold batches of pre-allocated slots for each AllocatorAffinity and size class, and
+    // deallocations are collected in a per thread list that is batch returned to the MemoryBlocks.  The
+    // Allocator::mutex is only acquired when a cache needs to be refilled or flushed.
+    //
     class VSG_DECLSPEC IntrusiveAllocator : public Allocator
     {
     public:
@@ -63,10 +71,17 @@ namespace vsg
         size_t totalMemorySize() const override;
         void setBlockSize(AllocatorAffinity allocatorAffinity, size_t blockSize) override;
 
+        /// maximum allocation size that is served from the per thread caches, 0 disables the thread caches.
+        /// Must be set before any allocations are made from the calling threads.
+        size_t threadCacheMaximumAllocationSize = 256;
+
+        /// number of slots allocated from, or deallocations returned to, the MemoryBlocks each time a thread cache acquires the Allocator::mutex
+        size_t threadCacheBatchSize = 32;
+
     protected:
         struct VSG_DECLSPEC MemoryBlock
         {
-            MemoryBlock(const std::string& in_name, size_t in_blockSize, size_t in_alignment);
+            MemoryBlock(const std::string& in_name, size_t in_blockSize, size_t in_alignment, size_t in_minimumBlockAlignment = 16);
             virtual ~MemoryBlock();
 
             std::string name;
@@ -191,9 +206,108 @@ namespace vsg
             size_t totalMemorySize() const;
         };
 
+        struct ThreadCache;
+
+        // shared between an IntrusiveAllocator and the ThreadCache assigned to it, so that threads exiting after the allocator has been destroyed can detect this
+        struct ThreadCacheRegistry
+        {
+            std::mutex mutex;
+            std::atomic<IntrusiveAllocator*> allocator{nullptr};
+            std::set<ThreadCache*> threadCaches;
+        };
+
+        // per thread cache of available slots and pending deallocations
+        struct ThreadCache
+        {
+            ThreadCache(std::shared_ptr<ThreadCacheRegistry> in_registry, size_t in_maximumAllocationSize, size_t in_batchSize);
+            ~ThreadCache();
+
+            static constexpr size_t sizeClassGranularity = 16;
+
+            std::shared_ptr<ThreadCacheRegistry> registry;
+            size_t maximumAllocationSize = 0;
+            size_t batchSize = 0;
+            size_t numSizeClasses = 0;
+
+            // available slots indexed by allocatorAffinity * numSizeClasses + sizeClass
+            std::vector<std::vector<void*>> availableSlots;
+
+            // deallocations deferred until a batch is returned to the MemoryBlocks, pendingMutex is uncontended except when
+            // another thread flushes them via deleteEmptyMemoryBlocks(). Lock after the Allocator::mutex.
+            std::mutex pendingMutex;
+            std::vector<void*> pendingDeallocations;
+        };
+
+        ThreadCache* getThreadCache();
+
+        // return all cached slots and pending deallocations to MemoryBlocks, Allocator::mutex must be held by the caller.
+        void _releaseThreadCache(ThreadCache& threadCache);
+        void _flushPendingDeallocations(ThreadCache& threadCache);
+        void _flushAllPendingDeallocations();
+
+        void* _allocate(std::size_t size, AllocatorAffinity allocatorAffinity);
+        bool _deallocate(void* ptr, std::size_t size);
+
+        // MemoryBlock memory is aligned to pages of 2^memoryBlockPageShift bytes so that each page is owned by a single MemoryBlock,
+        // enabling deallocate() to find the owning MemoryBlock with a single hash lookup of the page index.
+        static constexpr size_t memoryBlockPageShift = 16;
+        static constexpr size_t memoryBlockPageSize = size_t(1) << memoryBlockPageShift;
+
+        static inline size_t memoryBlockPage(const void* ptr) { return reinterpret_cast<size_t>(ptr) >> memoryBlockPageShift; }
+
+        // map from page index to the MemoryBlock that owns it, modified with the Allocator::mutex held.
+        // Pages below maximumRadixPage are held in a radix tree that lookup() reads without the mutex, so deallocate() can check that a pointer
+        // belongs to a MemoryBlock before deferring it. Pages beyond the range of the radix tree, only possible with > 48 bit addresses, use a hash map that requires the mutex.
+        class MemoryBlockPages
+        {
+        public:
+            MemoryBlockPages();
+            MemoryBlockPages(const MemoryBlockPages&) = delete;
+            MemoryBlockPages& operator=(const MemoryBlockPages&) = delete;
+            ~MemoryBlockPages();
+
+            /// return the MemoryBlock owning the page, without requiring the Allocator::mutex, returns nullptr if not owned or the page is beyond the radix tree.
+            MemoryBlock* lookup(size_t page) const;
+
+            /// return the MemoryBlock owning the page, Allocator::mutex must be held.
+            MemoryBlock* find(size_t page) const;
+
+            /// assign the page owner, Allocator::mutex must be held.
+            void assign(size_t page, MemoryBlock* memoryBlock);
+
+            /// remove the page if it's owned by memoryBlock, Allocator::mutex must be held.
+            void erase(size_t page, const MemoryBlock* memoryBlock);
+
+            size_t size() const { return _size; }
+
+        protected:
+            static constexpr size_t leafBits = 12;
+            static constexpr size_t midBits = 12;
+            static constexpr size_t rootBits = 8;
+            static constexpr uint64_t maximumRadixPage = uint64_t(1) << (rootBits + midBits + leafBits);
+
+            struct Leaf
+            {
+                std::atomic<MemoryBlock*> memoryBlocks[size_t(1) << leafBits];
+            };
+
+            struct Mid
+            {
+                std::atomic<Leaf*> leaves[size_t(1) << midBits];
+            };
+
+            std::atomic<Mid*> _root[size_t(1) << rootBits];
+            std::unordered_map<size_t, MemoryBlock*> _overflow;
+            size_t _size = 0;
+        };
+
+        void registerMemoryBlock(MemoryBlock* memoryBlock);
+        void unregisterMemoryBlock(MemoryBlock* memoryBlock);
+
         std::vector<std::unique_ptr<MemoryBlocks>> allocatorMemoryBlocks;
-        std::map<void*, std::shared_ptr<MemoryBlock>> memoryBlocks;
-        std::map<void*, std::pair<size_t, size_t>> largeAllocations;
+        MemoryBlockPages memoryBlockPages;
+        std::unordered_map<void*, std::pair<size_t, size_t>> largeAllocations;
+        std::shared_ptr<ThreadCacheRegistry> threadCacheRegistry;
     };
 
 } // namespace vsg
@@ -98,6 +98,10 @@ namespace vsg
         /// compare two objects, return -1 if this object is less than rhs, return 0 if it's equal, return 1 if rhs is greater,
         virtual int compare(const Object& rhs) const;
 
+        /// return a hash of the object's contents that is consistent with compare(), so objects that compare equal return the same hash.
+        /// The default of 0 signifies no content hash is provided, SharedObjects then falls back to compare() ordering to find matching objects.
+        virtual std::size_t hash() const { return 0; }
+
         virtual void accept(Visitor& visitor);
         virtual void traverse(Visitor&) {}
 
@@ -39,6 +39,7 @@ namespace vsg
     class Geometry;
     class VertexDraw;
     class VertexIndexDraw;
+    class CulledInstanceDraw;
     class DepthSorted;
     class Layer;
     class Bin;
@@ -328,6 +329,7 @@ namespace vsg
         virtual void apply(Geometry&);
         virtual void apply(VertexDraw&);
         virtual void apply(VertexIndexDraw&);
+        virtual void apply(CulledInstanceDraw&);
         virtual void apply(DepthSorted&);
         virtual void apply(Layer&);
         virtual void apply(Bin&);
@@ -14,6 +14,7 @@ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLI
 
 #include <vsg/core/ref_ptr.h>
 
+#include <cstdint>
 #include <cstring>
 
 namespace vsg
@@ -102,6 +103,50 @@ namespace vsg
         return 0;
     }
 
+    /// hash a block of memory, combined with seed, for use in Object::hash() implementations.
+    /// Blocks that compare equal with std::memcmp return the same hash. Processes 32 bytes per iteration using 4 independent lanes.
+    inline std::size_t hash_memory(const void* ptr, size_t size, std::size_t seed = 0)
+    {
+        auto mix = [](uint64_t h, uint64_t value) {
+            h ^= value * 0x87c37b91114253d5ull;
+            h = (h << 31) | (h >> 33);
+            return h * 0x4cf5ad432745937full;
+        };
+
+        const uint8_t* bytes = static_cast<const uint8_t*>(ptr);
+        const uint8_t* end = bytes + size;
+        uint64_t lanes[4] = {seed, seed ^ 0x9e3779b97f4a7c15ull, seed ^ 0xc2b2ae3d27d4eb4full, seed ^ 0x165667b19e3779f9ull};
+        uint64_t value;
+
+        for (; end - bytes >= 32; bytes += 32)
+        {
+            for (int i = 0; i < 4; ++i)
+            {
+                std::memcpy(&value, bytes + i * 8, 8);
+                lanes[i] = mix(lanes[i], value);
+            }
+        }
+
+        uint64_t h = mix(mix(mix(lanes[0], lanes[1]), lanes[2]), lanes[3]) ^ static_cast<uint64_t>(size);
+        for (; end - bytes >= 8; bytes += 8)
+        {
+            std::memcpy(&value, bytes, 8);
+            h = mix(h, value);
+        }
+        if (bytes < end)
+        {
+            value = 0;
+            std::memcpy(&value, bytes, static_cast<size_t>(end - bytes));
+            h = mix(h, value);
+        }
+
+        // final avalanche so that all bits of the result depend on all the input bits
+        h ^= h >> 33;
+        h *= 0xff51afd7ed558ccdull;
+        h ^= h >> 33;
+        return static_cast<std::size_t>(h);
+    }
+
     /// less functor for comparing ref_ptr<Object> typically used with std::set<> etc.
     struct DereferenceLess
     {
@@ -18,19 +18,24 @@ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLI
 #include <vsg/io/ObjectFactory.h>
 #include <vsg/io/Options.h>
 
+#include <charconv>
 #include <fstream>
+#include <string_view>
 
 namespace vsg
 {
 
     /// vsg::Input subclass that implements reading from an ascii input stream.
     /// Used by VSG ReaderWriter when reading native .vsgt ascii files.
+    /// The remainder of the input stream is read on construction. On destruction seekable streams are repositioned to just past the parsed text,
+    /// but streams that can't seek, such as pipes, are left at the end of the stream.
     class VSG_DECLSPEC AsciiInput : public vsg::Input
     {
     public:
         using ObjectID = uint32_t;
 
         AsciiInput(std::istream& input, ref_ptr<ObjectFactory> in_objectFactory, ref_ptr<const Options> in_options = {});
+        ~AsciiInput();
 
         bool matchPropertyName(const char* propertyName) override;
 
@@ -41,37 +46,21 @@ namespace vsg
         template<typename T>
         void _read(size_t num, T* value)
         {
-            if (num == 1)
+            for (; num > 0; --num, ++value)
             {
-                _input >> *value;
-            }
-            else
-            {
-                for (; num > 0; --num, ++value)
-                {
-                    _input >> *value;
-                }
+                _parse(*value);
             }
         }
 
         template<typename R, typename T>
         void _read_withcast(size_t num, T* value)
         {
-            if (num == 1)
+            R v;
+            for (; num > 0; --num, ++value)
             {
-                R v;
-                _input >> v;
+                _parse(v);
                 *value = static_cast<T>(v);
             }
-            else
-            {
-                R v;
-                for (; num > 0; --num, ++value)
-                {
-                    _input >> v;
-                    *value = static_cast<T>(v);
-                }
-            }
         }
 
         // read value(s)
@@ -105,7 +94,40 @@ namespace vsg
         vsg::ref_ptr<vsg::Object> read() override;
 
     protected:
+        /// skip whitespace, returning false when the end of the buffer has been reached
+        bool _skipWhitespace()
+        {
+            while (_ptr < _end && (*_ptr == ' ' || (*_ptr >= '\t' && *_ptr <= '\r'))) ++_ptr;
+            return _ptr < _end;
+        }
+
+        /// return the next whitespace delimited token
+        std::string_view _token();
+
+        /// parse an integer directly from the buffer, a malformed value is skipped over and read as 0
+        template<typename T>
+        void _parse(T& value)
+        {
+            value = 0;
+            if (!_skipWhitespace()) return;
+
+            auto result = std::from_chars(_ptr, _end, value);
+            if (result.ec == std::errc())
+                _ptr = result.ptr;
+            else
+                _token();
+        }
+
+        void _parse(float& value);
+        void _parse(double& value);
+
         std::istream& _input;
+        std::streampos _startPosition = -1;
+
+        /// the remainder of the input stream is read into a buffer on construction and tokenized in place, which avoids the per value overhead of locale bound std::istream extraction.
+        std::vector<char> _buffer;
+        const char* _ptr = nullptr;
+        const char* _end = nullptr;
 
         std::string _readPropertyName;
     };
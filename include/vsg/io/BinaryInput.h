@@ -15,6 +15,7 @@ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLI
 #include <vsg/core/Object.h>
 
 #include <vsg/io/Input.h>
+#include <vsg/io/MappedFile.h>
 #include <vsg/io/Options.h>
 
 #include <fstream>
@@ -74,8 +75,28 @@ namespace vsg
         /// read object
         vsg::ref_ptr<vsg::Object> read() override;
 
+        /// when assigned the input stream must be reading from the start of the MappedFile's data, payloads of at least mappedDataThreshold bytes are then referenced directly from the mapped pages.
+        ref_ptr<MappedFile> mappedFile;
+        size_t mappedDataThreshold = 4096;
+
+        void alignDataPayload() override;
+        void* mapDataPayload(size_t size, size_t alignment) override;
+
     protected:
+        // with the VSG::CLASS_INDEX format feature objects are written with an index into a table of class names, with the first use of a class followed by its name.
+        // The create function is resolved when the entry is read, unless the ObjectFactory is a subclass that may override create(className).
+        struct ClassEntry
+        {
+            std::string name;
+            const ObjectFactory::CreateFunction* createFunction = nullptr;
+            bool isNull = false;
+        };
+
+        const ClassEntry& _readClassEntry();
+        vsg::ref_ptr<vsg::Object> _readObject(ObjectID id, vsg::ref_ptr<vsg::Object> object, const std::string& className);
+
         std::istream& _input;
+        std::vector<ClassEntry> _classEntries;
     };
 
 } // namespace vsg
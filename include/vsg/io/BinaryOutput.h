@@ -16,6 +16,8 @@ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLI
 #include <vsg/io/Output.h>
 
 #include <fstream>
+#include <string_view>
+#include <unordered_map>
 
 namespace vsg
 {
@@ -61,8 +63,17 @@ namespace vsg
         /// write object
         void write(const vsg::Object* object) override;
 
+        /// alignment of the Array, Array2D and Array3D payloads relative to the start of the stream with the VSG::ALIGNED_PAYLOADS format feature.
+        static constexpr size_t dataAlignment = 16;
+
+        void alignDataPayload() override;
+
     protected:
+        // with the VSG::CLASS_INDEX format feature objects are written with an index into a table of class names, with the first use of a class followed by its name.
+        void _writeClassIndex(const char* className);
+
         std::ostream& _output;
+        std::unordered_map<std::string_view, uint32_t> _classIndices;
     };
 
 } // namespace vsg
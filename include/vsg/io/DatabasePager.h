@@ -15,15 +15,20 @@ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLI
 #include <vsg/app/CompileManager.h>
 #include <vsg/core/Inherit.h>
 #include <vsg/core/observer_ptr.h>
+#include <vsg/io/FileReader.h>
 #include <vsg/io/FileSystem.h>
 #include <vsg/io/Options.h>
 #include <vsg/nodes/PagedLOD.h>
 #include <vsg/threading/ActivityStatus.h>
 #include <vsg/utils/Instrumentation.h>
 
+#include <algorithm>
+#include <chrono>
 #include <condition_variable>
+#include <deque>
 #include <list>
 #include <thread>
+#include <unordered_map>
 
 namespace vsg
 {
@@ -44,11 +49,13 @@ namespace vsg
             newHighresRequired.clear();
         }
 
-        std::vector<const PagedLOD*> highresCulled;
-        std::vector<const PagedLOD*> newHighresRequired;
+        transient_vector<const PagedLOD*> highresCulled;
+        transient_vector<const PagedLOD*> newHighresRequired;
     };
 
-    /// Thread safe queue for tracking PagedLOD that needs to be loaded, compiled or merged by the DatabasePager
+    /// Thread safe queue for tracking PagedLOD that needs to be loaded, compiled or merged by the DatabasePager.
+    /// The PagedLOD are held in a binary max heap ordered by PagedLOD::priority, with an index from PagedLOD to heap position
+    /// so that priority increases made by the RecordTraversal can be applied in place, and taking the highest priority PagedLOD is O(log n).
     class VSG_DECLSPEC DatabaseQueue : public Inherit<Object, DatabaseQueue>
     {
     public:
@@ -63,23 +70,142 @@ namespace vsg
 
         void add(ref_ptr<PagedLOD> plod, const CompileResult& cr);
 
+        /// reposition a queued PagedLOD after its priority has changed, does nothing if the PagedLOD isn't in the queue.
+        void updatePriority(const PagedLOD* plod);
+
         ref_ptr<PagedLOD> take_when_available();
 
+        /// take up to maxNumNodes of the highest priority PagedLOD, waiting for at least one to be added.
+        Nodes take_when_available(size_t maxNumNodes);
+
         Nodes take_all(CompileResult& result);
 
+        /// remove all the queued PagedLOD that the predicate returns true for, returning them so the caller can discard their requests.
+        /// The predicate is called with the queue mutex locked.
+        template<class Predicate>
+        Nodes take_if(Predicate predicate)
+        {
+            Nodes nodes;
+
+            std::scoped_lock lock(_mutex);
+            auto itr = std::partition(_heap.begin(), _heap.end(), [&](const Entry& entry) { return !predicate(*entry.plod); });
+            if (itr == _heap.end()) return nodes;
+
+            for (auto remove_itr = itr; remove_itr != _heap.end(); ++remove_itr)
+            {
+                _positions.erase(remove_itr->plod.get());
+                nodes.emplace_back(std::move(remove_itr->plod));
+            }
+            _heap.erase(itr, _heap.end());
+            _rebuild();
+
+            return nodes;
+        }
+
+        size_t size() const;
+
     protected:
         virtual ~DatabaseQueue();
 
-        std::mutex _mutex;
+        struct Entry
+        {
+            double priority = 0.0;
+            ref_ptr<PagedLOD> plod;
+        };
+
+        void _push(ref_ptr<PagedLOD> plod);
+        ref_ptr<PagedLOD> _pop();
+        bool _wait(std::unique_lock<std::mutex>& lock);
+        void _moveUp(size_t position);
+        void _moveDown(size_t position);
+        void _rebuild();
+
+        mutable std::mutex _mutex;
         std::condition_variable _cv;
-        Nodes _queue;
+        std::vector<Entry> _heap;
+        std::unordered_map<const PagedLOD*, size_t> _positions;
         CompileResult _compileResult;
         ref_ptr<ActivityStatus> _status;
     };
     VSG_type_name(vsg::DatabaseQueue);
 
+    /// Statistics collected by each of the DatabasePager stages, times are in nanoseconds.
+    struct VSG_DECLSPEC DatabaseStageStatistics
+    {
+        /// number of requests the stage has completed, and discarded as no longer required or failed.
+        std::atomic_uint64_t numProcessed{0};
+        std::atomic_uint64_t numDiscarded{0};
+
+        /// time requests waited in the stage's input queue, not tracked for the read stage as its queue is ordered by priority rather than arrival.
+        std::atomic_uint64_t totalQueueTime{0};
+
+        /// time spent processing requests
+        std::atomic_uint64_t totalProcessTime{0};
+        std::atomic_uint64_t maxProcessTime{0};
+
+        /// time the stage spent blocked waiting for space in a full output queue
+        std::atomic_uint64_t totalBlockedTime{0};
+
+        /// average time in milliseconds a request waited in the input queue
+        double averageQueueTime() const;
+
+        /// average time in milliseconds taken to process a request
+        double averageProcessTime() const;
+
+        void reset();
+    };
+
+    /// Request passed between the DatabasePager stages
+    struct DatabaseRequest
+    {
+        ref_ptr<PagedLOD> plod;
+
+        /// file contents loaded by the read stage, empty if the decode stage should read the file itself.
+        std::vector<uint8_t> buffer;
+        Path filename;
+
+        /// cancellation token passed to the ReaderWriters via Options::activityStatus and to CompileManager::compile(), set inactive by updateSceneGraph() when the request is no longer required.
+        ref_ptr<ActivityStatus> activityStatus;
+
+        std::chrono::steady_clock::time_point queued;
+    };
+
+    /// Thread safe bounded FIFO queue used to pass requests between the DatabasePager stages.
+    /// add() blocks while the queue is full so that a slow stage applies backpressure to the stage upstream of it.
+    class VSG_DECLSPEC DatabaseStageQueue : public Inherit<Object, DatabaseStageQueue>
+    {
+    public:
+        DatabaseStageQueue(ref_ptr<ActivityStatus> status, size_t in_capacity);
+
+        /// maximum number of requests held before add() blocks
+        std::atomic_size_t capacity;
+
+        /// add request, blocking while the queue is full, returns the time in nanoseconds spent blocked. The request is dropped if the queue's status becomes inactive.
+        uint64_t add(DatabaseRequest&& request);
+
+        /// take the oldest request, waiting for one to be added, returns false if the queue's status becomes inactive.
+        bool take_when_available(DatabaseRequest& request);
+
+        size_t size() const;
+
+    protected:
+        virtual ~DatabaseStageQueue();
+
+        mutable std::mutex _mutex;
+        std::condition_variable _notEmpty;
+        std::condition_variable _notFull;
+        std::deque<DatabaseRequest> _queue;
+        ref_ptr<ActivityStatus> _status;
+    };
+    VSG_type_name(vsg::DatabaseStageQueue);
+
     /// Multi-threaded database pager for reading, compiling loaded PagedLOD subgraphs and updating the scene graph
-    /// with newly loaded subgraphs and pruning expired PagedLOD subgraphs
+    /// with newly loaded subgraphs and pruning expired PagedLOD subgraphs.
+    /// Requests pass through a pipeline of stages, each with their own threads, connected by queues:
+    ///   read    - takes the highest priority request and loads the file contents into memory
+    ///   decode  - reads the subgraph from the loaded file contents, or from the file when the contents couldn't be preloaded
+    ///   compile - compiles the subgraph using the CompileManager
+    ///   merge   - merges the compiled subgraphs into the scene graph during updateSceneGraph()
     class VSG_DECLSPEC DatabasePager : public Inherit<Object, DatabasePager>
     {
     public:
@@ -92,10 +218,58 @@ namespace vsg
 
         virtual void request(ref_ptr<PagedLOD> plod);
 
+        /// called by the RecordTraversal when the priority of an already requested PagedLOD has been increased.
+        virtual void updatePriority(const PagedLOD* plod);
+
         virtual void updateSceneGraph(FrameStamp* frameStamp, CompileResult& cr);
 
         ref_ptr<CompileManager> compileManager;
 
+        /// number of threads for each stage, assign before start(). Use more read threads for high latency network file systems.
+        uint32_t numReadThreads = 4;
+        uint32_t numDecodeThreads = 2;
+        uint32_t numCompileThreads = 2;
+
+        /// maximum number of requests queued for the decode and compile stages before the stage upstream blocks.
+        size_t maxDecodeQueueSize = 16;
+        size_t maxCompileQueueSize = 8;
+
+        /// load file contents into memory in the read stage so the decode stage doesn't block on I/O.
+        /// Only used when the PagedLOD::options has ReaderWriters that can read from memory and doesn't use SharedObjects, as reads from memory can't be shared by filename.
+        bool readFilesIntoMemory = true;
+
+        /// maximum number of requests each read thread takes from the request queue at a time. The files of the requests are loaded together using the
+        /// Options::fileReader of the PagedLOD::options, so with an asynchronous FileReader such as IoUringFileReader a few read threads can keep many reads in flight.
+        uint32_t maxNumReadsPerThread = 1;
+
+        /// maximum time in milliseconds that updateSceneGraph() spends trimming inactive subgraphs and merging loaded subgraphs each frame,
+        /// the remaining work is carried over to following frames. At least one subgraph is merged each frame. A value of 0.0 disables the time limit.
+        double updateTimeBudget = 0.0;
+
+        /// maximum number of subgraphs merged, and trimmed, by each call to updateSceneGraph(), 0 disables the limit.
+        uint32_t maxNumMergesPerFrame = 0;
+        uint32_t maxNumTrimsPerFrame = 0;
+
+        /// release trimmed subgraphs on a background thread so that destroying large subgraphs doesn't stall the update thread, assign before start().
+        bool releaseOnBackgroundThread = true;
+
+        /// per stage statistics
+        DatabaseStageStatistics readStatistics;
+        DatabaseStageStatistics decodeStatistics;
+        DatabaseStageStatistics compileStatistics;
+        DatabaseStageStatistics mergeStatistics;
+
+        /// current number of requests waiting in each stage's input queue
+        struct QueueDepths
+        {
+            size_t read = 0;
+            size_t decode = 0;
+            size_t compile = 0;
+            size_t merge = 0;
+            size_t release = 0;
+        };
+        QueueDepths queueDepths() const;
+
         std::atomic_uint numActiveRequests{0};
         std::atomic_uint64_t frameCount;
 
@@ -104,6 +278,15 @@ namespace vsg
         /// for systems with smaller GPU memory limits you may need to reduce the targetMaxNumPagedLODWithHighResSubgraphs to keep memory usage within available limits.
         uint32_t targetMaxNumPagedLODWithHighResSubgraphs = 1500;
 
+        /// memory budgets in bytes for the loaded high resolution subgraphs, when exceeded the least recently used inactive subgraphs are released until back within budget.
+        /// A value of 0 disables the budget. GPU memory is estimated from the BufferInfo ranges and Image memory requirements, CPU memory from the Data::dataSize().
+        uint64_t cpuMemoryBudget = 0;
+        uint64_t gpuMemoryBudget = 0;
+
+        /// estimated memory used by the merged high resolution subgraphs, updated by updateSceneGraph().
+        std::atomic_uint64_t totalCPUMemory{0};
+        std::atomic_uint64_t totalGPUMemory{0};
+
         std::mutex pendingPagedLODMutex;
 
         ref_ptr<PagedLODContainer> pagedLODContainer;
@@ -119,12 +302,40 @@ namespace vsg
 
         void requestDiscarded(PagedLOD* plod);
 
+        bool requestExpired(const PagedLOD* plod) const { return (frameCount - plod->frameHighResLastUsed.load()) > 1; }
+
+        /// return true if the request has been cancelled or is no longer required
+        bool requestCancelled(const DatabaseRequest& request) const { return request.activityStatus->cancel() || requestExpired(request.plod); }
+
+        // cancellation tokens of the requests being read, decoded or compiled
+        ref_ptr<ActivityStatus> _startRequest(const PagedLOD* plod);
+        void _finishRequest(const PagedLOD* plod);
+
+        std::mutex _inflightMutex;
+        std::unordered_map<const PagedLOD*, ref_ptr<ActivityStatus>> _inflightRequests;
+
         ref_ptr<ActivityStatus> _status;
 
         ref_ptr<DatabaseQueue> _requestQueue;
+        ref_ptr<DatabaseStageQueue> _decodeQueue;
+        ref_ptr<DatabaseStageQueue> _compileQueue;
         ref_ptr<DatabaseQueue> _toMergeQueue;
 
         std::list<std::thread> _readThreads;
+        std::list<std::thread> _decodeThreads;
+        std::list<std::thread> _compileThreads;
+
+        // subgraphs taken from the _toMergeQueue that haven't been merged yet due to the updateTimeBudget or maxNumMergesPerFrame
+        DatabaseQueue::Nodes _pendingMerges;
+        std::atomic_size_t _numPendingMerges{0};
+
+        // trimmed subgraphs waiting to be released by the release thread
+        void _release(std::vector<ref_ptr<Node>>& nodes);
+
+        mutable std::mutex _releaseMutex;
+        std::condition_variable _releaseCondition;
+        std::vector<ref_ptr<Node>> _toRelease;
+        std::thread _releaseThread;
     };
     VSG_type_name(vsg::DatabasePager);
 
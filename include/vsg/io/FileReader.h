@@ -0,0 +1,50 @@
+#pragma once
+
+/* <editor-fold desc="MIT License">
+
+Copyright(c) 2024 Robert Osfield
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"), to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+</editor-fold> */
+
+#include <vsg/core/Inherit.h>
+#include <vsg/io/Path.h>
+
+#include <vector>
+
+namespace vsg
+{
+
+    /// FileReader loads the contents of files into memory so that they can be parsed with the ReaderWriters that support reading from memory.
+    /// Used by VSG::read and the DatabasePager read stage when assigned to Options::fileReader.
+    /// The base class uses blocking reads, one file after another, subclasses such as IoUringFileReader override read(Requests&) to keep many reads in flight.
+    class VSG_DECLSPEC FileReader : public Inherit<Object, FileReader>
+    {
+    public:
+        FileReader();
+
+        struct Request
+        {
+            Path filename;
+            std::vector<uint8_t> buffer;
+            bool success = false;
+        };
+        using Requests = std::vector<Request>;
+
+        /// read the contents of the requested files into their buffers, returning once all the reads have completed or failed.
+        virtual void read(Requests& requests);
+
+        /// convenience method for reading a single file, returns true on success.
+        bool read(const Path& filename, std::vector<uint8_t>& buffer);
+
+    protected:
+        virtual ~FileReader();
+    };
+    VSG_type_name(vsg::FileReader);
+
+} // namespace vsg
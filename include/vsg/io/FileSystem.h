@@ -12,6 +12,8 @@ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLI
 
 </editor-fold> */
 
+#include <cstdio>
+#include <functional>
 #include <map>
 #include <vector>
 
@@ -66,4 +68,16 @@ namespace vsg
     /// Open a file using the C style fopen() adapted to work with the vsg::Path.
     extern VSG_DECLSPEC FILE* fopen(const Path& path, const char* mode);
 
+    /// rename a file, replacing newPath if it already exists. When both paths are on the same file system the replacement is atomic,
+    /// so other processes opening newPath see either the previous or the new file and never a partially written one. Return true on success.
+    extern VSG_DECLSPEC bool renameFile(const Path& oldPath, const Path& newPath);
+
+    /// remove a file, return true on success.
+    extern VSG_DECLSPEC bool removeFile(const Path& path);
+
+    /// write a file by calling writeFunction with a temporary file in the same directory, named with the process ID and a per process count,
+    /// then renaming it to path, so concurrent threads and processes never read a partially written file.
+    /// The directory is created if required. If writeFunction returns false, or the write or rename fails, the temporary file is removed and false returned.
+    extern VSG_DECLSPEC bool writeFileAtomically(const Path& path, const std::function<bool(FILE* file)>& writeFunction);
+
 } // namespace vsg
@@ -68,6 +68,14 @@ namespace vsg
         // read object
         virtual ref_ptr<Object> read() = 0;
 
+        /// called by Array, Array2D and Array3D before reading their data payload to skip any padding written by Output::alignDataPayload().
+        virtual void alignDataPayload() {}
+
+        /// return a pointer to the data payload of size bytes if it can be referenced directly from a memory mapped file, advancing the input past the payload.
+        /// The caller must assign ALLOCATOR_TYPE_MAPPED_FILE to the Data so the pointer is released with vsg::releaseMappedData().
+        /// Returns nullptr if the payload should be read with read(num, value).
+        virtual void* mapDataPayload(size_t, size_t) { return nullptr; }
+
         // map char to int8_t
         void read(size_t num, char* value) { read(num, reinterpret_cast<int8_t*>(value)); }
         void read(size_t num, bool* value) { read(num, reinterpret_cast<int8_t*>(value)); }
@@ -236,18 +244,45 @@ namespace vsg
         }
 
         using ObjectID = uint32_t;
-        using ObjectIDMap = std::map<ObjectID, ref_ptr<Object>>;
 
-        ObjectIDMap objectIDMap;
+        struct ObjectIDEntry
+        {
+            bool assigned = false;
+            ref_ptr<Object> object;
+        };
+        using ObjectIDs = std::vector<ObjectIDEntry>;
+
+        /// objects read so far indexed by their ObjectID, Output assigns ObjectIDs sequentially so a dense vector is used rather than a map.
+        ObjectIDs objectIDs;
+
+        /// return the entry of an ObjectID that has already been read, otherwise return nullptr.
+        const ObjectIDEntry* findObjectID(ObjectID id) const { return (id < objectIDs.size() && objectIDs[id].assigned) ? &objectIDs[id] : nullptr; }
+
+        /// maximum distance an ObjectID read from a file may be beyond the ObjectIDs already assigned, Output assigns ObjectIDs sequentially so larger gaps indicate a corrupt file.
+        static constexpr ObjectID maximumObjectIDGap = 65536;
+
+        /// assign the object read for an ObjectID, throws vsg::Exception if the ObjectID is more than maximumObjectIDGap beyond those already assigned.
+        void assignObjectID(ObjectID id, ref_ptr<Object> object);
+
+        /// grow objectIDs to hold the ObjectIDs from startID to endID inclusive, used by External for the ObjectIDs of the objects in its external files.
+        /// throws vsg::Exception if startID is more than maximumObjectIDGap beyond the ObjectIDs already assigned or endID is less than startID.
+        void reserveObjectIDs(ObjectID startID, ObjectID endID);
+
         ref_ptr<ObjectFactory> objectFactory;
         ref_ptr<const Options> options;
         Path filename;
 
         VsgVersion version;
 
+        /// features of the file format signalled by the file header, see VSG::FormatFeatures
+        uint32_t formatFeatures = 0;
+
         virtual bool version_less(uint32_t major, uint32_t minor, uint32_t patch, uint32_t soversion = 0) const;
         virtual bool version_greater_equal(uint32_t major, uint32_t minor, uint32_t patch, uint32_t soversion = 0) const;
 
+        /// return true if the Options::activityStatus has been cancelled and the read should be abandoned.
+        bool cancelled() const;
+
     protected:
         virtual ~Input();
     };
@@ -0,0 +1,55 @@
+#pragma once
+
+/* <editor-fold desc="MIT License">
+
+Copyright(c) 2024 Robert Osfield
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"), to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+</editor-fold> */
+
+#include <vsg/io/FileReader.h>
+
+#include <atomic>
+#include <mutex>
+
+namespace vsg
+{
+
+    /// IoUringFileReader uses the Linux io_uring interface to submit the reads of all the requested files together,
+    /// so that a small number of threads can keep many reads in flight, such as when paging tiles from network file systems.
+    /// Falls back to the blocking FileReader implementation when io_uring isn't supported by the build (VSG_SUPPORTS_io_uring) or by the kernel.
+    class VSG_DECLSPEC IoUringFileReader : public Inherit<FileReader, IoUringFileReader>
+    {
+    public:
+        explicit IoUringFileReader(uint32_t in_queueDepth = 64);
+
+        /// maximum number of reads in flight for each call to read(Requests&).
+        const uint32_t queueDepth;
+
+        /// return true if io_uring is available, otherwise read() falls back to blocking reads.
+        bool supported() const { return _supported; }
+
+        using FileReader::read;
+        void read(Requests& requests) override;
+
+    protected:
+        virtual ~IoUringFileReader();
+
+        struct Ring;
+
+        // rings are reused between calls to read(Requests&), with a ring per concurrent call.
+        Ring* _takeRing();
+        void _returnRing(Ring* ring);
+
+        std::atomic_bool _supported{false};
+        std::mutex _ringMutex;
+        std::vector<Ring*> _availableRings;
+    };
+    VSG_type_name(vsg::IoUringFileReader);
+
+} // namespace vsg
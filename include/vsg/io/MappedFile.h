@@ -0,0 +1,51 @@
+#pragma once
+
+/* <editor-fold desc="MIT License">
+
+Copyright(c) 2024 Robert Osfield
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"), to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+</editor-fold> */
+
+#include <vsg/core/Inherit.h>
+#include <vsg/io/Path.h>
+
+namespace vsg
+{
+
+    /// MappedFile maps the contents of a file into memory using copy on write pages, so modifications made to the memory aren't written back to the file.
+    /// Used by VSG::read when the VSG::memory_map option is enabled so that large Array, Array2D and Array3D payloads in .vsgb files reference the mapped pages rather than being copied.
+    /// Data referencing the mapped pages use ALLOCATOR_TYPE_MAPPED_FILE and keep the MappedFile alive until they release their data.
+    class VSG_DECLSPEC MappedFile : public Inherit<Object, MappedFile>
+    {
+    public:
+        explicit MappedFile(const Path& in_filename);
+
+        const Path filename;
+
+        bool valid() const { return _data != nullptr; }
+
+        const uint8_t* data() const { return _data; }
+        size_t size() const { return _size; }
+
+        /// return a pointer to the mapped memory at the specified offset for Data to use, the MappedFile is kept alive until release(ptr) is called.
+        void* reference(size_t offset);
+
+        /// release a pointer returned by reference(), returns false if the pointer isn't within a MappedFile.
+        static bool release(const void* ptr);
+
+    protected:
+        virtual ~MappedFile();
+
+        uint8_t* _data = nullptr;
+        size_t _size = 0;
+        void* _mapping = nullptr;
+    };
+    VSG_type_name(vsg::MappedFile);
+
+} // namespace vsg
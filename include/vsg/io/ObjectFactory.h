@@ -15,8 +15,12 @@ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLI
 #include <vsg/core/Object.h>
 #include <vsg/core/type_name.h>
 
+#include <atomic>
 #include <functional>
 #include <map>
+#include <mutex>
+#include <string_view>
+#include <unordered_map>
 
 namespace vsg
 {
@@ -28,18 +32,56 @@ namespace vsg
     public:
         ObjectFactory();
 
+        /// stable numeric identifier of a class, the 64 bit FNV-1a hash of the namespace::class name so it's the same across runs and platforms.
+        using TypeID = uint64_t;
+
+        static constexpr TypeID typeID(std::string_view className)
+        {
+            TypeID hash = 14695981039346656037ull;
+            for (char c : className)
+            {
+                hash ^= static_cast<uint8_t>(c);
+                hash *= 1099511628211ull;
+            }
+            return hash;
+        }
+
+        template<class T>
+        static TypeID typeID() { return typeID(type_name<T>()); }
+
+        /// create an instance of the class with the specified namespace::class name.
         virtual vsg::ref_ptr<vsg::Object> create(const std::string& className);
 
+        /// create an instance of the class with the specified TypeID, using the create function found via getCreateFunction(id).
+        virtual vsg::ref_ptr<vsg::Object> create(TypeID id);
+
         using CreateFunction = std::function<vsg::ref_ptr<vsg::Object>()>;
         using CreateMap = std::map<std::string, CreateFunction>;
+        using TypeIndex = std::unordered_map<TypeID, CreateMap::iterator>;
 
-        CreateMap& getCreateMap() { return _createMap; }
+        /// map of class names to create functions used by all the create() methods, entries may be added or replaced directly.
+        /// Calling the non const getCreateMap() marks the TypeID index for rebuilding so direct edits are picked up by getCreateFunction().
+        CreateMap& getCreateMap()
+        {
+            _typeIndexDirty = true;
+            return _createMap;
+        }
         const CreateMap& getCreateMap() const { return _createMap; }
 
+        /// return the create function of the class with the specified TypeID, or nullptr if no class with that TypeID is registered.
+        /// The pointer refers to the CreateMap entry so remains valid until the entry is erased from the CreateMap.
+        const CreateFunction* getCreateFunction(TypeID id);
+
+        /// return the create function of the class with the specified namespace::class name, or nullptr if the class isn't registered.
+        const CreateFunction* getCreateFunction(const std::string& className);
+
+        /// register the create function for the class, returning its TypeID.
+        TypeID add(const std::string& className, CreateFunction createFunction);
+
         template<class T>
-        void add()
+        TypeID add()
         {
-            _createMap[type_name<T>()] = []() { return T::create(); };
+            return add(type_name<T>(), []() { return T::create(); });
         }
 
         /// return the ObjectFactory singleton instance
@@ -48,7 +90,13 @@ namespace vsg
     protected:
         virtual ~ObjectFactory();
 
+        void _rebuildTypeIndex();
+
         CreateMap _createMap;
+
+        std::mutex _typeIndexMutex;
+        std::atomic_bool _typeIndexDirty{true};
+        TypeIndex _typeIndex;
     };
 
     // Helper template class for registering the ability to create an Object of specified T on demand.
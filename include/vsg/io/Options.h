@@ -29,6 +29,8 @@ namespace vsg
     class ShaderSet;
     class FindDynamicObjects;
     class PropagateDynamicObjects;
+    class ActivityStatus;
+    class FileReader;
 
     using ReaderWriters = std::vector<ref_ptr<ReaderWriter>>;
 
@@ -108,6 +110,14 @@ namespace vsg
         /// mechanism for propogating dynamic objects classification up parental chain so that cloning is done on all dynamic objects to avoid sharing of dyanmic parts.
         ref_ptr<PropagateDynamicObjects> propagateDynamicObjects;
 
+        /// optional cancellation token, when its status becomes inactive ReaderWriters should abandon the read and return a ReadError.
+        /// Used by the DatabasePager to cancel reads of PagedLOD subgraphs that are no longer required.
+        ref_ptr<ActivityStatus> activityStatus;
+
+        /// optional FileReader used to load the contents of files into memory before parsing them, used by VSG::read and the DatabasePager read stage.
+        /// Assign an IoUringFileReader on Linux to keep many reads in flight, if not assigned blocking reads are used.
+        ref_ptr<FileReader> fileReader;
+
     protected:
         virtual ~Options();
     };
@@ -68,6 +68,10 @@ namespace vsg
         /// write object
         virtual void write(const Object* object) = 0;
 
+        /// called by Array, Array2D and Array3D before writing their data payload, BinaryOutput pads the stream so that the payload is aligned to dataAlignment
+        /// so that it can be referenced directly from memory mapped files.
+        virtual void alignDataPayload() {}
+
         /// map char to int8_t
         void write(size_t num, const char* value) { write(num, reinterpret_cast<const int8_t*>(value)); }
         void write(size_t num, const bool* value) { write(num, reinterpret_cast<const int8_t*>(value)); }
@@ -204,6 +208,9 @@ namespace vsg
 
         VsgVersion version;
 
+        /// features of the file format that are written, these must be signalled by the file header, see VSG::FormatFeatures
+        uint32_t formatFeatures = 0;
+
         virtual bool version_less(uint32_t major, uint32_t minor, uint32_t patch, uint32_t soversion = 0) const;
         virtual bool version_greater_equal(uint32_t major, uint32_t minor, uint32_t patch, uint32_t soversion = 0) const;
 
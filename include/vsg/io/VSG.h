@@ -32,8 +32,21 @@ namespace vsg
         bool write(const vsg::Object* object, const vsg::Path& filename, vsg::ref_ptr<const vsg::Options> options = {}) const override;
         bool write(const vsg::Object* object, std::ostream& fout, vsg::ref_ptr<const vsg::Options> options = {}) const override;
 
+        bool readOptions(Options& options, CommandLine& arguments) const override;
         bool getFeatures(Features& features) const override;
 
+        /// bool option, when true .vsgb files are memory mapped and large Array, Array2D and Array3D payloads reference the mapped pages rather than being copied.
+        /// Files preloaded by the DatabasePager read stage are read from memory so disable DatabasePager::readFilesIntoMemory when paging with this option.
+        static constexpr const char* memory_map = "memory_map";
+
+        /// bool option, when true .vsgb files are written as a block compressed container that is signalled by a #vsgz header token.
+        /// The binary stream is split into independently compressed blocks using the in-tree LZ codec, with a block index following the header.
+        /// When Options::operationThreads is assigned the blocks are compressed and decompressed in parallel.
+        static constexpr const char* compress = "compress";
+
+        /// uint32_t option, size of the uncompressed blocks used when writing compressed .vsgb files, defaults to 256KB.
+        static constexpr const char* compress_block_size = "compress_block_size";
+
         ObjectFactory* getObjectFactory() { return _objectFactory; }
         const ObjectFactory* getObjectFactory() const { return _objectFactory; }
 
@@ -41,15 +54,39 @@ namespace vsg
         {
             BINARY,
             ASCII,
-            NOT_RECOGNIZED
+            NOT_RECOGNIZED,
+            BINARY_COMPRESSED
+        };
+
+        /// optional changes to the file format, each signalled by a named token following the version in the header line and assigned to Input/Output::formatFeatures.
+        /// Files without a token, including those written by releases that predate the feature, are read without it.
+        enum FormatFeatures : uint32_t
+        {
+            NO_FORMAT_FEATURES = 0,
+            ALIGNED_PAYLOADS = 1 << 0, ///< "aligned_payloads", binary Array, Array2D and Array3D payloads are preceded by padding that aligns them to BinaryOutput::dataAlignment
+            CLASS_INDEX = 1 << 1,      ///< "class_index", binary objects are written with an index into a table of class names rather than the class name
+            CHILD_BOUNDS = 1 << 2      ///< "child_bounds", Group and QuadGroup are written with their childBounds
         };
 
         using FormatInfo = std::pair<FormatType, VsgVersion>;
 
         FormatInfo readHeader(std::istream& fin) const;
-        void writeHeader(std::ostream& fout, const FormatInfo& formatInfo) const;
+
+        /// read the header, assigning the FormatFeatures signalled in it. Headers with unknown feature tokens are NOT_RECOGNIZED.
+        FormatInfo readHeader(std::istream& fin, uint32_t& formatFeatures) const;
+
+        void writeHeader(std::ostream& fout, const FormatInfo& formatInfo, uint32_t formatFeatures = NO_FORMAT_FEATURES) const;
 
     protected:
+        /// read the header and root object from the stream, filename is assigned to the Input so that relative file references can be resolved.
+        vsg::ref_ptr<vsg::Object> _read(std::istream& fin, const vsg::Path& filename, vsg::ref_ptr<const vsg::Options> options) const;
+
+        /// read the block index and blocks that follow a BINARY_COMPRESSED header, decompress them and read the root object from the decompressed binary stream.
+        vsg::ref_ptr<vsg::Object> _readCompressed(std::istream& fin, const vsg::Path& filename, const VsgVersion& version, uint32_t formatFeatures, vsg::ref_ptr<const vsg::Options> options) const;
+
+        /// write the header, block index and compressed blocks of the binary stream of the object.
+        bool _writeCompressed(const vsg::Object* object, std::ostream& fout, const VsgVersion& version, vsg::ref_ptr<const vsg::Options> options) const;
+
         ref_ptr<ObjectFactory> _objectFactory;
     };
     VSG_type_name(vsg::VSG);
@@ -0,0 +1,38 @@
+#pragma once
+
+/* <editor-fold desc="MIT License">
+
+Copyright(c) 2024 Robert Osfield
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"), to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+</editor-fold> */
+
+#include <vsg/core/Export.h>
+
+#include <cstddef>
+#include <cstdint>
+
+namespace vsg
+{
+
+    /// return the maximum size of the output of lz_compress(..) for an input of srcSize bytes.
+    extern VSG_DECLSPEC size_t lz_compressBound(size_t srcSize);
+
+    /// compress a block of memory using the in-tree LZ77 codec, a byte oriented format of literal runs and matches with up to 64k back references.
+    /// Each call produces an independent block that can be decompressed without reference to any other block.
+    /// Returns the compressed size, or 0 if dstCapacity is too small for the compressed data.
+    extern VSG_DECLSPEC size_t lz_compress(const uint8_t* src, size_t srcSize, uint8_t* dst, size_t dstCapacity);
+
+    /// return the maximum size a valid block of srcSize bytes can decompress to, used to reject corrupt sizes before allocating the output.
+    extern VSG_DECLSPEC size_t lz_decompressBound(size_t srcSize);
+
+    /// decompress a block compressed with lz_compress(..), returns true if the block is valid and decompresses to exactly dstSize bytes.
+    /// All reads and writes are bounds checked so corrupt input is detected rather than overrunning the buffers.
+    extern VSG_DECLSPEC bool lz_decompress(const uint8_t* src, size_t srcSize, uint8_t* dst, size_t dstSize);
+
+} // namespace vsg
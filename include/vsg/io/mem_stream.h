@@ -47,6 +47,10 @@ namespace vsg
             {
                 setg((char*)(ptr), (char*)(ptr), (char*)(ptr) + length);
             }
+
+            // support tellg()/seekg() so that readers can compute offsets into the memory block
+            pos_type seekoff(off_type off, std::ios_base::seekdir dir, std::ios_base::openmode which) override;
+            pos_type seekpos(pos_type pos, std::ios_base::openmode which) override;
         };
 
         mem_buffer _buffer;
@@ -27,7 +27,8 @@ namespace vsg
         {
             NO_SORT,
             ASCENDING,
-            DESCENDING
+            DESCENDING,
+            STATE_SORT ///< sort by the StateCommand in slot 0 (pipeline), then slots 1 and 2 (descriptor sets), then ascending value, to minimize state changes in opaque bins
         };
 
         Bin();
@@ -41,6 +42,9 @@ namespace vsg
 
         void add(State* state, double value, const Node* node);
 
+        /// append the elements collected by another Bin, used to combine the bins populated by RecordTraversal worker threads.
+        void add(const Bin& rhs);
+
     public:
         ref_ptr<Object> clone(const CopyOp& copyop = {}) const override { return Bin::create(*this, copyop); }
         int compare(const Object& rhs) const override;
@@ -53,8 +57,8 @@ namespace vsg
     protected:
         virtual ~Bin();
 
-        std::vector<dmat4> _matrices;
-        std::vector<const StateCommand*> _stateCommands;
+        transient_vector<dmat4> _matrices;
+        transient_vector<const StateCommand*> _stateCommands;
 
         struct Element
         {
@@ -64,10 +68,18 @@ namespace vsg
             const Node* child = nullptr;
         };
 
-        std::vector<Element> _elements;
+        transient_vector<Element> _elements;
 
         using KeyIndex = std::pair<float, uint32_t>;
-        mutable std::vector<KeyIndex> _binElements;
+        mutable transient_vector<KeyIndex> _binElements;
+
+        // STATE_SORT support, computing a 64 bit key for each element from its StateCommands and value,
+        // with a sorted list of the unique StateCommands for each of the slots 0, 1 and 2 so each slot's index uses its own range of the key
+        static constexpr uint32_t numStateSortSlots = 3;
+        mutable transient_vector<const StateCommand*> _sortedStateCommands[numStateSortSlots];
+        mutable transient_vector<uint64_t> _stateSortKeys;
+
+        void _sortByState() const;
     };
     VSG_type_name(vsg::Bin);
 
@@ -0,0 +1,126 @@
+#pragma once
+
+/* <editor-fold desc="MIT License">
+
+Copyright(c) 2024 Robert Osfield
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"), to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+</editor-fold> */
+
+#include <vsg/commands/Dispatch.h>
+#include <vsg/commands/DrawIndexedIndirectCount.h>
+#include <vsg/commands/PipelineBarrier.h>
+#include <vsg/state/BindDescriptorSet.h>
+#include <vsg/state/ComputePipeline.h>
+#include <vsg/vk/CommandBuffer.h>
+
+#include <mutex>
+
+namespace vsg
+{
+
+    // forward declare
+    class State;
+    class FrameStamp;
+
+    /// CulledInstanceDraw draws many instances of an indexed mesh with the view frustum culling and level of detail selection of the instances done on the GPU.
+    /// A compute shader tests the bounding sphere of each instance against the view frustum, selects the level of detail using the same
+    /// screen height ratio test as vsg::LOD, then appends a VkDrawIndexedIndirectCommand to a compacted draw buffer that is drawn using vkCmdDrawIndexedIndirectCount.
+    /// Each visible instance is drawn with an instanceCount of 1 and firstInstance set to the instance index, so vertex shaders can use gl_InstanceIndex to look up the instance transform.
+    /// The culling is dispatched in a primary CommandBuffer submitted ahead of the CommandGraph's CommandBuffers, as vkCmdDispatch can't be recorded within a render pass.
+    /// Each View the CulledInstanceDraw is compiled for has its own frustum parameters and draw buffers, and the culling is dispatched once per View per frame,
+    /// using the frustum of the first path to the CulledInstanceDraw recorded for that View. Further paths in the same View, where the CulledInstanceDraw has multiple parents,
+    /// and Views it hasn't been compiled for, draw all instances at the highest level of detail.
+    /// Changes to the levels or instances are picked up when the CulledInstanceDraw is compiled again.
+    /// Requires Vulkan 1.2 with the drawIndirectCount feature enabled, or the VK_KHR_draw_indirect_count extension.
+    class VSG_DECLSPEC CulledInstanceDraw : public Inherit<Command, CulledInstanceDraw>
+    {
+    public:
+        CulledInstanceDraw();
+
+        struct Level
+        {
+            uint32_t indexCount = 0;
+            uint32_t firstIndex = 0;
+            int32_t vertexOffset = 0;
+            float minimumScreenHeightRatio = 0.0f;
+        };
+
+        /// levels of detail ordered from highest to lowest detail, the first level that satisfies radius > lodDistance * minimumScreenHeightRatio is drawn.
+        std::vector<Level> levels;
+
+        uint32_t firstBinding = 0;
+        BufferInfoList arrays;
+        ref_ptr<BufferInfo> indices;
+
+        /// per instance bounding spheres, xyz center and w radius, in the local coordinate frame of the instance transform.
+        const ref_ptr<BufferInfo> instanceBounds;
+
+        /// per instance transforms, the instance bounds are transformed by these before testing. Vertex shaders should bind the same data to transform the vertices.
+        const ref_ptr<BufferInfo> instanceTransforms;
+
+        void assignArrays(const DataList& in_arrays);
+        void assignIndices(ref_ptr<Data> in_indices);
+        void assignInstances(ref_ptr<vec4Array> in_bounds, ref_ptr<mat4Array> in_transforms);
+
+        /// compute pipeline and descriptor set used to cull the instances, set up by the constructor using the built in GLSL culling shader.
+        /// bindDescriptorSet binds set 0, shared by all Views, with bindings 0 instanceBounds, 1 instanceTransforms and 2 levels.
+        /// Each View has its own set 1 with bindings 0 frustum planes and lodScale, 1 draw commands and 2 draw count.
+        ref_ptr<BindComputePipeline> bindComputePipeline;
+        ref_ptr<BindDescriptorSet> bindDescriptorSet;
+
+        /// GLSL source of the built in culling shader, requires the ShaderCompiler to be available when compiled.
+        static const char* cullShaderSource();
+
+        /// local workgroup size of the culling shader
+        static constexpr uint32_t workgroupSize = 64;
+
+        /// record the culling dispatch for the current View and frame, called by RecordTraversal before draw commands are recorded.
+        void dispatch(State& state, const FrameStamp* frameStamp, RecordedCommandBuffers& recordedCommandBuffers) const;
+
+        void read(Input& input) override;
+        void write(Output& output) const override;
+
+        void compile(Context& context) override;
+        void record(CommandBuffer& commandBuffer) const override;
+
+    protected:
+        virtual ~CulledInstanceDraw();
+
+        struct ViewData
+        {
+            ref_ptr<BufferInfo> parameters;
+            ref_ptr<BufferInfo> drawCommands;
+            ref_ptr<BufferInfo> drawCount;
+            ref_ptr<BindDescriptorSet> bindDescriptorSet;
+            ref_ptr<DrawIndexedIndirectCount> drawIndexedIndirectCount;
+            bool dispatched = false;
+            bool drawAllInstances = false; // set when a further path in the View is recorded after the culling was dispatched
+            uint64_t dispatchedFrameCount = 0;
+        };
+
+        ref_ptr<BufferInfo> _levels;
+        ref_ptr<DescriptorSetLayout> _viewDescriptorSetLayout;
+        uint32_t _numInstances = 0;
+
+        ref_ptr<PipelineBarrier> _preCullBarrier;
+        ref_ptr<PipelineBarrier> _transferBarrier;
+        ref_ptr<Dispatch> _dispatch;
+        ref_ptr<PipelineBarrier> _postCullBarrier;
+
+        vk_buffer<VulkanArrayData> _vulkanData;
+        VkIndexType _indexType = VK_INDEX_TYPE_UINT16;
+
+        mutable std::mutex _dispatchMutex;
+        mutable std::vector<ViewData> _viewData; // indexed by viewID
+        mutable bool _multiplePathsReported = false;
+        mutable CommandBuffers _commandBuffers;
+    };
+    VSG_type_name(vsg::CulledInstanceDraw);
+
+} // namespace vsg
@@ -14,6 +14,7 @@ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLI
 
 #include <vsg/core/Allocator.h>
 #include <vsg/nodes/Node.h>
+#include <vsg/nodes/PackedBounds.h>
 
 #include <vector>
 namespace vsg
@@ -41,6 +42,11 @@ namespace vsg
             children.push_back(child);
         }
 
+        /// optional bounds of the children, used by the RecordTraversal to cull the children in a single batch.
+        /// Must be recreated with PackedBounds::create(group) when children are added, removed or reordered, or their bounds change,
+        /// as only a mismatch between the number of bounds and children is detected, in which case the childBounds are ignored.
+        ref_ptr<PackedBounds> childBounds;
+
     public:
         ref_ptr<Object> clone(const CopyOp& copyop = {}) const override { return Group::create(*this, copyop); }
         int compare(const Object& rhs) const override;
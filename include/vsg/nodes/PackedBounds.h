@@ -0,0 +1,81 @@
+#pragma once
+
+/* <editor-fold desc="MIT License">
+
+Copyright(c) 2024 Robert Osfield
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"), to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+</editor-fold> */
+
+#include <vsg/core/Inherit.h>
+#include <vsg/maths/plane.h>
+
+#include <vector>
+
+namespace vsg
+{
+
+    // forward declare
+    class Node;
+    class Group;
+    class QuadGroup;
+
+    /// PackedBounds stores a list of bounding spheres as float arrays of center x, y, z and radius relative to a common origin,
+    /// so that they can be tested against the view frustum in a single batch using SSE/AVX instructions when available.
+    /// Assigned to Group::childBounds/QuadGroup::childBounds to enable batched culling of the children during the RecordTraversal.
+    /// The spheres are a snapshot of the children's bounds taken when the PackedBounds is set up, they aren't updated when the children
+    /// or their bounds change, so the PackedBounds must then be recreated or reassigned with set(), otherwise a child may be wrongly culled.
+    class VSG_DECLSPEC PackedBounds : public Inherit<Object, PackedBounds>
+    {
+    public:
+        PackedBounds();
+
+        /// set up from the bounds of the Group's children
+        explicit PackedBounds(const Group& group);
+
+        /// set up from the bounds of the QuadGroup's children
+        explicit PackedBounds(const QuadGroup& quadGroup);
+
+        /// origin that the sphere centers are relative to, planes are transformed to this origin in double precision before conversion to float
+        dvec3 origin;
+
+        /// number of spheres, the arrays are padded to a multiple of 8 so that SIMD loads never read past the end
+        size_t count = 0;
+
+        std::vector<float> x;
+        std::vector<float> y;
+        std::vector<float> z;
+        std::vector<float> radius;
+
+        /// assign the spheres, an invalid sphere (negative radius) is treated as always visible
+        void set(const dsphere* spheres, size_t numSpheres);
+
+        /// get the bounding sphere used for culling a node, returns an invalid sphere for nodes that don't provide a bound
+        static dsphere bound(const Node* node);
+
+        /// test all the spheres against the planes, setting visible[i] to 1 if sphere i is inside or intersects all the planes, 0 otherwise.
+        /// Uses AVX or SSE2 when enabled at compile time, otherwise the scalar path. Returns the number of visible spheres.
+        size_t intersect(const dplane* planes, size_t numPlanes, uint8_t* visible) const;
+
+        /// scalar implementation of intersect()
+        size_t intersect_scalar(const dplane* planes, size_t numPlanes, uint8_t* visible) const;
+
+        /// maximum number of planes supported by intersect()
+        static constexpr size_t maxNumPlanes = 8;
+
+        int compare(const Object& rhs) const override;
+
+        void read(Input& input) override;
+        void write(Output& output) const override;
+
+    protected:
+        virtual ~PackedBounds();
+    };
+    VSG_type_name(vsg::PackedBounds);
+
+} // namespace vsg
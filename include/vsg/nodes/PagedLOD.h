@@ -89,6 +89,9 @@ namespace vsg
         mutable std::atomic_uint64_t frameHighResLastUsed{0};
         mutable std::atomic_uint requestCount{0};
 
+        // set when the high res child was requested by PagedLODPrefetch rather than required by the current view, used to collect prefetch statistics.
+        mutable std::atomic_bool prefetched{false};
+
         enum RequestStatus : unsigned int
         {
             NoRequest = 0,
@@ -105,6 +108,10 @@ namespace vsg
         mutable uint32_t index = 0;
 
         ref_ptr<Node> pending;
+
+        // estimated CPU and GPU memory used by the high resolution subgraph, computed by the DatabasePager after it's compiled.
+        uint64_t highResCPUMemory = 0;
+        uint64_t highResGPUMemory = 0;
     };
     VSG_type_name(vsg::PagedLOD);
 
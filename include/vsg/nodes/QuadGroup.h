@@ -15,6 +15,7 @@ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLI
 #include <vsg/core/ref_ptr.h>
 
 #include <vsg/nodes/Node.h>
+#include <vsg/nodes/PackedBounds.h>
 
 #include <array>
 #include <vector>
@@ -34,6 +35,10 @@ namespace vsg
         using Children = std::array<ref_ptr<vsg::Node>, 4>;
         Children children;
 
+        /// optional bounds of the children, used by the RecordTraversal to cull the children in a single batch.
+        /// Must be recreated with PackedBounds::create(quadGroup) when the children or their bounds change as stale bounds aren't detected.
+        ref_ptr<PackedBounds> childBounds;
+
     public:
         ref_ptr<Object> clone(const CopyOp& copyop = {}) const override { return QuadGroup::create(*this, copyop); }
         int compare(const Object& rhs) const override;
@@ -12,6 +12,7 @@ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLI
 
 </editor-fold> */
 
+#include <vsg/io/Path.h>
 #include <vsg/maths/vec2.h>
 #include <vsg/vk/DescriptorPool.h>
 
@@ -37,6 +38,10 @@ namespace vsg
         uivec2 numShadowMapsRange = {0, 64};
         uivec2 shadowMapSize = {2048, 2048};
 
+        /// directory that the Context's PipelineCache is read from and written to, keyed by PhysicalDevice, so pipeline compilation is reused across runs.
+        /// Only used when no PipelineCache has been assigned to Device::pipelineCache. Machine specific so isn't serialized.
+        Path pipelineCacheDirectory;
+
     public:
         void read(Input& input) override;
         void write(Output& output) const override;
@@ -119,10 +119,10 @@ namespace vsg
         void traverse(RecordTraversal& rt) const override;
 
         // containers filled in by RecordTraversal
-        std::vector<std::pair<dmat4, const AmbientLight*>> ambientLights;
-        std::vector<std::pair<dmat4, const DirectionalLight*>> directionalLights;
-        std::vector<std::pair<dmat4, const PointLight*>> pointLights;
-        std::vector<std::pair<dmat4, const SpotLight*>> spotLights;
+        transient_vector<std::pair<dmat4, const AmbientLight*>> ambientLights;
+        transient_vector<std::pair<dmat4, const DirectionalLight*>> directionalLights;
+        transient_vector<std::pair<dmat4, const PointLight*>> pointLights;
+        transient_vector<std::pair<dmat4, const SpotLight*>> spotLights;
 
         virtual void init(ResourceRequirements& requirements);
         virtual void update(ResourceRequirements& requirements);
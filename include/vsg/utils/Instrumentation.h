@@ -68,6 +68,9 @@ namespace vsg
         virtual void enter(const SourceLocation* /*sl*/, uint64_t& /*reference*/, CommandBuffer& /*commandBuffer*/, const Object* /*object*/ = nullptr) const {};
         virtual void leave(const SourceLocation* /*sl*/, uint64_t& /*reference*/, CommandBuffer& /*commandBuffer*/, const Object* /*object*/ = nullptr) const {};
 
+        /// report a named value, such as the number of cull tests done in a frame, name must be a string literal as implementations may retain the pointer.
+        virtual void counter(const char* /*name*/, uint64_t /*value*/) const {};
+
         virtual void finish() const {};
 
     protected:
@@ -0,0 +1,138 @@
+#pragma once
+
+/* <editor-fold desc="MIT License">
+
+Copyright(c) 2024 Robert Osfield
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"), to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+</editor-fold> */
+
+#include <vsg/core/Array.h>
+#include <vsg/maths/mat4.h>
+#include <vsg/maths/sphere.h>
+#include <vsg/threading/OperationThreads.h>
+
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+
+namespace vsg
+{
+
+    /// Occluder provides the triangle mesh, in the local coordinate frame of the matrix, that is rasterized into the OcclusionBuffer.
+    /// Occluder meshes should be simplified versions of the scene geometry that lie entirely within the geometry they represent, i.e. building walls and terrain,
+    /// otherwise objects that are visible may be culled.
+    class VSG_DECLSPEC Occluder : public Inherit<Object, Occluder>
+    {
+    public:
+        Occluder();
+        Occluder(ref_ptr<vec3Array> in_vertices, ref_ptr<uintArray> in_indices, const dmat4& in_matrix = {});
+
+        ref_ptr<vec3Array> vertices;
+        ref_ptr<uintArray> indices;
+        dmat4 matrix;
+
+        void read(Input& input) override;
+        void write(Output& output) const override;
+
+    protected:
+        virtual ~Occluder();
+    };
+    VSG_type_name(vsg::Occluder);
+
+    /// OcclusionBuffer is a low resolution CPU depth buffer that the Occluder meshes are rasterized into,
+    /// which is then used to test whether bounding spheres are completely hidden behind the occluders.
+    /// Assign to View::occlusionBuffer to enable occlusion culling of CullGroup, CullNode and LOD nodes during the RecordTraversal,
+    /// the occluders are rasterized at the start of the traversal of the View.
+    /// A depth buffer is kept for each viewID so an OcclusionBuffer can be shared by Views, including Views recorded in parallel and nested Views,
+    /// but rasterize() must not be called for a viewID while occluded() is being called for the same viewID.
+    /// OcclusionBuffer doesn't use Vulkan so can be used and tested without a GPU.
+    class VSG_DECLSPEC OcclusionBuffer : public Inherit<Object, OcclusionBuffer>
+    {
+    public:
+        explicit OcclusionBuffer(uint32_t in_width = 256, uint32_t in_height = 128);
+
+        /// dimensions of the depth buffer, rounded up to a multiple of the tileSize.
+        const uint32_t width;
+        const uint32_t height;
+
+        /// size of the tiles used to quickly accept occluded spheres, each tile records the farthest depth of its pixels.
+        static constexpr uint32_t tileSize = 8;
+
+        /// number of threads used to rasterize the occluders, the depth buffer is split into horizontal bands with one band per thread.
+        uint32_t numThreads = 1;
+
+        /// optional OperationThreads used for the rasterization, if not assigned OperationThreads with numThreads-1 threads are created on first use.
+        ref_ptr<OperationThreads> operationThreads;
+
+        /// occluders rasterized by rasterize()
+        std::vector<ref_ptr<Occluder>> occluders;
+
+        /// clear the viewID's depth buffer and rasterize the occluders using the specified projection and view matrices
+        void rasterize(const dmat4& projection, const dmat4& view, uint32_t viewID = 0);
+
+        /// return true if the sphere, in eye coordinates, is completely hidden by the occluders rasterized for the viewID.
+        bool occluded(const dsphere& sphere, uint32_t viewID = 0) const;
+
+        /// return true if the sphere, in the local coordinates of the modelview matrix, is completely hidden by the occluders rasterized for the viewID.
+        bool occluded(const dsphere& sphere, const dmat4& modelview, uint32_t viewID = 0) const;
+
+        /// depth buffer of the viewID, width * height values, larger values are farther from the eye point with std::numeric_limits<float>::max() for pixels not entirely covered by an occluder.
+        /// Occluders are rasterized conservatively, a pixel is only written when it's entirely covered by a triangle, or by the two triangles either side of an edge
+        /// shared within an Occluder's mesh, and records the farthest depth of the occluder over the whole pixel. Empty if the viewID hasn't been rasterized.
+        const std::vector<float>& depth(uint32_t viewID = 0) const;
+
+        /// statistics
+        std::atomic_uint64_t numTrianglesRasterized{0};
+        mutable std::atomic_uint64_t numTests{0};
+        mutable std::atomic_uint64_t numOccluded{0};
+
+    protected:
+        virtual ~OcclusionBuffer();
+
+        struct Triangle
+        {
+            float x[3];
+            float y[3];
+            float z[3];
+            uint32_t vertexIDs[3];
+            uint32_t sharedEdges; // bit i set when the edge from vertex i to vertex (i + 1) % 3 is shared with another triangle of the same Occluder
+        };
+
+        // depth buffer and working data of the rasterization for one viewID
+        struct ViewData
+        {
+            dmat4 projection;
+            float depthSign = 1.0f;
+            std::vector<float> depth;
+            std::vector<float> tileDepth;
+            std::vector<float> partialDepth;
+            std::vector<uint64_t> partialEdge;
+            std::vector<Triangle> triangles;
+            std::vector<dvec4> clipVertices;
+            std::unordered_map<uint64_t, uint32_t> edgeCounts;
+        };
+
+        struct RasterizeOperation;
+
+        ViewData* _getViewData(uint32_t viewID) const;
+        void _clipAndAddTriangle(ViewData& viewData, const dvec4& c0, const dvec4& c1, const dvec4& c2, const uint32_t* vertexIDs, uint32_t sharedEdges);
+        void _addTriangle(ViewData& viewData, const dvec4& c0, const dvec4& c1, const dvec4& c2, const uint32_t* vertexIDs, uint32_t sharedEdges);
+        void _rasterizeBand(ViewData& viewData, uint32_t y_begin, uint32_t y_end);
+        void _rasterizeTriangle(ViewData& viewData, const Triangle& triangle, uint32_t y_begin, uint32_t y_end);
+        static double _nearPlaneDistance(const ViewData& viewData, const dvec4& c);
+
+        // ViewData are held by unique_ptr so that they aren't moved when another viewID is added, the mutex guards _viewData and _operationThreads
+        mutable std::mutex _viewDataMutex;
+        std::vector<std::unique_ptr<ViewData>> _viewData;
+        ref_ptr<OperationThreads> _operationThreads;
+    };
+    VSG_type_name(vsg::OcclusionBuffer);
+
+} // namespace vsg
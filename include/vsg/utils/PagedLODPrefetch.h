@@ -0,0 +1,95 @@
+#pragma once
+
+#pragma once
+
+/* <editor-fold desc="MIT License">
+
+Copyright(c) 2024 Robert Osfield
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"), to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+</editor-fold> */
+
+#include <vsg/core/Inherit.h>
+#include <vsg/maths/mat4.h>
+#include <vsg/maths/plane.h>
+#include <vsg/maths/quat.h>
+#include <vsg/maths/sphere.h>
+
+#include <atomic>
+#include <deque>
+
+namespace vsg
+{
+
+    /// PagedLODPrefetch extrapolates the camera path from the view matrices of recent frames so that the RecordTraversal can request
+    /// PagedLOD high resolution children that will be required a short time ahead, reducing the number of frames low resolution children are shown during fast camera motion.
+    /// PagedLOD whose high resolution child isn't required by the current view are culled and LOD tested against the predicted view frustum,
+    /// those that pass are requested from the DatabasePager with a reduced priority.
+    /// Assign to View::pagedLODPrefetch to enable.
+    class VSG_DECLSPEC PagedLODPrefetch : public Inherit<Object, PagedLODPrefetch>
+    {
+    public:
+        PagedLODPrefetch();
+
+        /// time, in seconds, that the camera path is extrapolated ahead
+        double predictionTime = 0.3;
+
+        /// number of recent view matrices used to estimate the camera's linear and angular velocity
+        uint32_t maxNumSamples = 4;
+
+        /// multiplier applied to the priority of prefetch requests so that PagedLOD required by the current view are loaded first
+        double priorityScale = 0.1;
+
+        /// record the view matrix for the frame and update the predicted view, called by the RecordTraversal at the start of the View traversal.
+        /// time is in seconds, returns true if the camera is moving and a predicted view is available.
+        bool update(uint64_t frameCount, double time, const dmat4& projectionMatrix, const dmat4& viewMatrix);
+
+        /// return true if update() computed a predicted view for the current frame
+        bool active() const { return _active; }
+
+        /// predicted view matrix computed by update()
+        const dmat4& predictedViewMatrix() const { return _predictedViewMatrix; }
+
+        /// return the LOD distance of the sphere, in the local coordinates of the modelview matrix, from the predicted view, or -1.0 if it's outside the predicted view frustum.
+        double lodDistance(const dsphere& sphere, const dmat4& modelview) const;
+
+        /// number of prefetch requests made to the DatabasePager
+        std::atomic_uint64_t numRequests{0};
+
+        /// number of prefetched high resolution children that had been loaded by the time the current view required them
+        std::atomic_uint64_t numHits{0};
+
+        /// number of prefetched high resolution children that were still loading when the current view required them
+        std::atomic_uint64_t numLate{0};
+
+        /// number of prefetched high resolution children that haven't been required by the current view, including requests still in progress
+        uint64_t numMisses() const;
+
+        void resetStatistics();
+
+    protected:
+        virtual ~PagedLODPrefetch();
+
+        struct Sample
+        {
+            uint64_t frameCount = 0;
+            double time = 0.0;
+            dvec3 position;
+            dquat rotation;
+        };
+
+        std::deque<Sample> _samples;
+        bool _active = false;
+        dmat4 _predictedViewMatrix;
+        dmat4 _predictedFromCurrent; // transforms current eye coordinates to predicted eye coordinates
+        dplane _frustum[5];          // left, right, bottom, top and far planes of the projection in eye coordinates
+        double _lodScale = 1.0;
+    };
+    VSG_type_name(vsg::PagedLODPrefetch);
+
+} // namespace vsg
@@ -24,6 +24,11 @@ namespace vsg
         // default ShaderCompileSettings
         ref_ptr<ShaderCompileSettings> defaults;
 
+        /// directory used to cache the compiled SPIR-V between runs, used when the Options passed to compile() don't have a fileCache assigned.
+        /// The compiled shaders are written to the spirv/ subdirectory with filenames based on a hash of the final shader sources,
+        /// the ShaderCompileSettings and the glslang version.
+        Path fileCache;
+
         bool compile(ShaderStages& shaders, const std::vector<std::string>& defines = {}, ref_ptr<const Options> options = {});
         bool compile(ref_ptr<ShaderStage> shaderStage, const std::vector<std::string>& defines = {}, ref_ptr<const Options> options = {});
 
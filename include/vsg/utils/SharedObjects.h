@@ -20,6 +20,8 @@ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLI
 #include <mutex>
 #include <ostream>
 #include <set>
+#include <typeindex>
+#include <unordered_map>
 
 namespace vsg
 {
@@ -28,6 +30,8 @@ namespace vsg
     class SuitableForSharing;
 
     /// class for facilitating the sharing of instances of objects that have the same properties.
+    /// Objects that provide a content hash via Object::hash(), such as vsg::Data, are looked up in a hashed index with compare() only used to confirm a match,
+    /// other objects are held in a set ordered by compare(). Types are distributed across lock stripes so threads sharing objects of different types don't contend.
     class VSG_DECLSPEC SharedObjects : public Inherit<Object, SharedObjects>
     {
     public:
@@ -75,9 +79,35 @@ namespace vsg
     protected:
         virtual ~SharedObjects();
 
-        mutable std::recursive_mutex _mutex;
-        std::map<std::type_index, ref_ptr<Object>> _defaults;
-        std::map<std::type_index, std::set<ref_ptr<Object>, DereferenceLess>> _sharedObjects;
+        /// shared objects of a single type, objects with a content hash are held in the hashed index, the rest in the ordered set
+        struct TypedObjects
+        {
+            std::set<ref_ptr<Object>, DereferenceLess> ordered;
+            std::unordered_multimap<std::size_t, ref_ptr<Object>> hashed;
+        };
+
+        struct Stripe
+        {
+            mutable std::recursive_mutex mutex;
+            std::map<std::type_index, ref_ptr<Object>> defaults;
+            std::map<std::type_index, TypedObjects> sharedObjects;
+        };
+
+        static constexpr size_t numStripes = 16;
+        mutable Stripe _stripes[numStripes];
+
+        Stripe& _stripe(const std::type_index& id) const { return _stripes[id.hash_code() % numStripes]; }
+
+        /// return the shared object that compares equal to object, or nullptr if there is none. The stripe's mutex must be locked by the caller.
+        static Object* _find(const TypedObjects& objects, const ref_ptr<Object>& object, std::size_t hash);
+
+        /// add object if no equal object is already shared. The stripe's mutex must be locked by the caller.
+        static void _insert(TypedObjects& objects, const ref_ptr<Object>& object, std::size_t hash);
+
+        /// thread safe check of the object against suitableForSharing
+        bool _suitable(const Object* object);
+
+        std::mutex _suitableForSharingMutex;
     };
     VSG_type_name(vsg::SharedObjects);
 
@@ -127,22 +157,25 @@ namespace vsg
     template<class T>
     ref_ptr<T> SharedObjects::shared_default()
     {
-        std::scoped_lock<std::recursive_mutex> lock(_mutex);
-
         auto id = std::type_index(typeid(T));
-        auto& def = _defaults[id];
+        auto& stripe = _stripe(id);
+
+        std::scoped_lock<std::recursive_mutex> lock(stripe.mutex);
+
+        auto& def = stripe.defaults[id];
         auto def_T = def.cast<T>(); // should be able to do a static cast
         if (!def_T)
         {
             def_T = T::create();
-            auto& shared_objects = _sharedObjects[id];
-            if (auto itr = shared_objects.find(def_T); itr != shared_objects.end())
+            auto& shared_objects = stripe.sharedObjects[id];
+            auto hash = def_T->hash();
+            if (auto shared = _find(shared_objects, def_T, hash))
             {
-                def_T = (static_cast<T*>(itr->get()));
+                def_T = static_cast<T*>(shared);
             }
             else
             {
-                shared_objects.insert(def_T);
+                _insert(shared_objects, def_T, hash);
             }
 
             def = def_T;
@@ -155,47 +188,53 @@ namespace vsg
     template<class T>
     void SharedObjects::share(ref_ptr<T>& object)
     {
-        std::scoped_lock<std::recursive_mutex> lock(_mutex);
-
-        if (suitableForSharing && !suitableForSharing->suitable(object.get())) return;
+        if (!_suitable(object.get())) return;
 
+        // compute the content hash before taking the lock as it may involve hashing large data
+        auto hash = object->hash();
         auto id = std::type_index(typeid(T));
-        auto& shared_objects = _sharedObjects[id];
-        if (auto itr = shared_objects.find(object); itr != shared_objects.end())
+        auto& stripe = _stripe(id);
+
+        std::scoped_lock<std::recursive_mutex> lock(stripe.mutex);
+
+        auto& shared_objects = stripe.sharedObjects[id];
+        if (auto shared = _find(shared_objects, object, hash))
         {
-            object = ref_ptr<T>(static_cast<T*>(itr->get()));
+            object = ref_ptr<T>(static_cast<T*>(shared));
             return;
         }
 
-        shared_objects.insert(object);
+        _insert(shared_objects, object, hash);
     }
 
     // implementation of template method
     template<class T, typename Func>
     void SharedObjects::share(ref_ptr<T>& object, Func init)
     {
+        auto id = std::type_index(typeid(T));
+        auto& stripe = _stripe(id);
+
         {
-            std::scoped_lock<std::recursive_mutex> lock(_mutex);
+            auto hash = object->hash();
+
+            std::scoped_lock<std::recursive_mutex> lock(stripe.mutex);
 
-            auto id = std::type_index(typeid(T));
-            auto& shared_objects = _sharedObjects[id];
-            if (auto itr = shared_objects.find(object); itr != shared_objects.end())
+            auto& shared_objects = stripe.sharedObjects[id];
+            if (auto shared = _find(shared_objects, object, hash))
             {
-                object = ref_ptr<T>(static_cast<T*>(itr->get()));
+                object = ref_ptr<T>(static_cast<T*>(shared));
                 return;
             }
         }
 
         init(object);
 
+        if (suitableForSharing && _suitable(object.get()))
         {
-            std::scoped_lock<std::recursive_mutex> lock(_mutex);
-            auto id = std::type_index(typeid(T));
-            auto& shared_objects = _sharedObjects[id];
-            if (suitableForSharing && suitableForSharing->suitable(object.get()))
-            {
-                shared_objects.insert(object);
-            }
+            auto hash = object->hash();
+
+            std::scoped_lock<std::recursive_mutex> lock(stripe.mutex);
+            _insert(stripe.sharedObjects[id], object, hash);
         }
     }
 
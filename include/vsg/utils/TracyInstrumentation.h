@@ -133,6 +133,11 @@ namespace vsg
             FrameMark;
         }
 
+        void counter(const char* name, uint64_t value) const override
+        {
+            TracyPlot(name, static_cast<int64_t>(value));
+        }
+
         void enter(const SourceLocation* slcloc, uint64_t& reference, const Object*) const override
         {
 #    ifdef TRACY_ON_DEMAND
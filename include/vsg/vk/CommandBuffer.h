@@ -38,6 +38,13 @@ namespace vsg
         Mask overrideMask = MASK_OFF;
         ViewDependentState* viewDependentState = nullptr;
 
+        /// render pass, subpass and framebuffer active during the RecordTraversal, assigned by RenderGraph and NextSubPass.
+        /// Used to set up the VkCommandBufferInheritanceInfo of secondary CommandBuffers recorded within the render pass.
+        VkRenderPass renderPass = VK_NULL_HANDLE;
+        uint32_t subpass = 0;
+        VkFramebuffer framebuffer = VK_NULL_HANDLE;
+        VkSubpassContents subpassContents = VK_SUBPASS_CONTENTS_INLINE;
+
         VkCommandBufferLevel level() const { return _level; }
 
         /// reset the CommandBuffer for the new frame.
@@ -29,6 +29,7 @@ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLI
 #include <vsg/vk/DescriptorPool.h>
 #include <vsg/vk/Fence.h>
 #include <vsg/vk/MemoryBufferPools.h>
+#include <vsg/vk/PipelineCache.h>
 #include <vsg/vk/ResourceRequirements.h>
 
 namespace vsg
@@ -109,6 +110,9 @@ namespace vsg
         // DescriptorPools
         ref_ptr<DescriptorPools> descriptorPools;
 
+        // PipelineCache used when creating GraphicsPipeline, ComputePipeline and RayTracingPipeline, shared with other Context via Device::pipelineCache
+        ref_ptr<PipelineCache> pipelineCache;
+
         // ShaderCompiler
         ref_ptr<ShaderCompiler> shaderCompiler;
 
@@ -25,6 +25,7 @@ namespace vsg
     class WindowTraits;
     class MemoryBufferPools;
     class DescriptorPools;
+    class PipelineCache;
 
     struct QueueSetting
     {
@@ -88,6 +89,7 @@ namespace vsg
         observer_ptr<MemoryBufferPools> deviceMemoryBufferPools;
         observer_ptr<MemoryBufferPools> stagingMemoryBufferPools;
         observer_ptr<DescriptorPools> descriptorPools;
+        observer_ptr<PipelineCache> pipelineCache;
 
     protected:
         virtual ~Device();
@@ -43,6 +43,9 @@ namespace vsg
 
         PFN_vkGetBufferDeviceAddressKHR_Compatibility vkGetBufferDeviceAddressKHR = nullptr;
 
+        // VK_KHR_draw_indirect_count / Vulkan 1.2
+        PFN_vkCmdDrawIndexedIndirectCountKHR vkCmdDrawIndexedIndirectCount = nullptr;
+
         // VK_EXT_mesh_shader
         PFN_vkCmdDrawMeshTasksEXT vkCmdDrawMeshTasksEXT = nullptr;
         PFN_vkCmdDrawMeshTasksIndirectEXT vkCmdDrawMeshTasksIndirectEXT = nullptr;
@@ -0,0 +1,58 @@
+#pragma once
+
+/* <editor-fold desc="MIT License">
+
+Copyright(c) 2024 Robert Osfield
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"), to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+</editor-fold> */
+
+#include <vsg/io/Path.h>
+#include <vsg/vk/Device.h>
+
+namespace vsg
+{
+
+    /// PipelineCache encapsulates VkPipelineCache, used by GraphicsPipeline, ComputePipeline and RayTracingPipeline so that the driver can reuse the results of previous pipeline compilations.
+    /// If a filename is provided the cache data is loaded from it on construction, after checking that it was written for the same PhysicalDevice and driver version,
+    /// and saved back to it by write() and on destruction. The Context creates one for its Device, using ResourceHints::pipelineCacheDirectory for the filename when set,
+    /// or a PipelineCache can be assigned to Device::pipelineCache before the Context are created.
+    class VSG_DECLSPEC PipelineCache : public Inherit<Object, PipelineCache>
+    {
+    public:
+        explicit PipelineCache(Device* device, const Path& in_filename = {});
+
+        operator VkPipelineCache() const { return _pipelineCache; }
+        VkPipelineCache vk() const { return _pipelineCache; }
+
+        /// file the cache data is read from and written to.
+        const Path filename;
+
+        /// return filename for the pipeline cache of the physicalDevice within the directory, keyed by its pipelineCacheUUID and driverVersion.
+        static Path cacheFilename(const Path& directory, const PhysicalDevice* physicalDevice);
+
+        /// get the current cache data from the driver
+        std::vector<uint8_t> getData() const;
+
+        /// write the cache data to filename using writeFileAtomically() so concurrent processes never read a partial file. Return true on success.
+        bool write() const;
+
+        Device* getDevice() { return _device; }
+        const Device* getDevice() const { return _device; }
+
+    protected:
+        virtual ~PipelineCache();
+
+        bool _read(std::vector<uint8_t>& data) const;
+
+        VkPipelineCache _pipelineCache = VK_NULL_HANDLE;
+        ref_ptr<Device> _device;
+    };
+    VSG_type_name(vsg::PipelineCache);
+
+} // namespace vsg
@@ -98,6 +98,8 @@ namespace vsg
         uivec2 numLightsRange = {8, 1024};
         uivec2 numShadowMapsRange = {0, 64};
         uivec2 shadowMapSize = {2048, 2048};
+
+        Path pipelineCacheDirectory;
     };
     VSG_type_name(vsg::ResourceRequirements);
 
@@ -133,6 +135,7 @@ namespace vsg
         void apply(const Geometry& geometry) override;
         void apply(const VertexDraw& vid) override;
         void apply(const VertexIndexDraw& vid) override;
+        void apply(const CulledInstanceDraw& cid) override;
         void apply(const BindVertexBuffers& bvb) override;
         void apply(const BindIndexBuffer& bib) override;
 
@@ -12,6 +12,7 @@ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLI
 
 </editor-fold> */
 
+#include <vsg/core/Allocator.h>
 #include <vsg/maths/plane.h>
 #include <vsg/maths/transform.h>
 #include <vsg/nodes/MatrixTransform.h>
@@ -35,39 +36,63 @@ namespace vsg
         StateStack() :
             dirty(false) {}
 
-        using Stack = std::stack<ref_ptr<const T>>;
+        using Stack = std::stack<ref_ptr<const T>, transient_vector<ref_ptr<const T>>>;
         Stack stack;
         bool dirty;
 
+        /// StateCommand last recorded to the current CommandBuffer, used to avoid rebinding the same StateCommand, reset by vsg::State::resetLastRecorded().
+        const T* lastRecorded = nullptr;
+
+        /// bit mask, assigned by vsg::State, that records which StateStack have been modified and need recording.
+        uint64_t* dirtySlotMask = nullptr;
+        uint64_t dirtySlotBit = 0;
+
+        inline void setDirty()
+        {
+            dirty = true;
+            if (dirtySlotMask) *dirtySlotMask |= dirtySlotBit;
+        }
+
         template<class R>
         inline void push(ref_ptr<R> value)
         {
             stack.push(value);
-            dirty = true;
+            setDirty();
         }
 
         template<class R>
         inline void push(R* value)
         {
             stack.push(ref_ptr<const T>(value));
-            dirty = true;
+            setDirty();
         }
 
         inline void pop()
         {
             stack.pop();
-            dirty = !stack.empty();
+            if (stack.empty())
+                dirty = false;
+            else
+                setDirty();
         }
         size_t size() const { return stack.size(); }
         const T* top() const { return stack.top(); }
 
-        inline void record(CommandBuffer& commandBuffer)
+        /// record the top of the stack if it's dirty and not the StateCommand last recorded, return true if a StateCommand was recorded.
+        inline bool record(CommandBuffer& commandBuffer)
         {
             if (dirty)
             {
-                stack.top()->record(commandBuffer);
                 dirty = false;
+                const T* current = stack.top();
+                if (current != lastRecorded)
+                {
+                    current->record(commandBuffer);
+                    lastRecorded = current;
+                    return true;
+                }
             }
+            return false;
         }
     };
 
@@ -85,20 +110,22 @@ namespace vsg
 
         using value_type = double;
 
-        std::stack<dmat4> matrixStack;
+        std::stack<dmat4, transient_vector<dmat4>> matrixStack;
         uint32_t offset = 0;
         bool dirty = false;
 
         inline void set(const mat4& matrix)
         {
-            matrixStack = {};
+            // pop rather than reassign to retain the capacity of the stack
+            while (!matrixStack.empty()) matrixStack.pop();
             matrixStack.emplace(matrix);
             dirty = true;
         }
 
         inline void set(const dmat4& matrix)
         {
-            matrixStack = {};
+            // pop rather than reassign to retain the capacity of the stack
+            while (!matrixStack.empty()) matrixStack.pop();
             matrixStack.emplace(matrix);
             dirty = true;
         }
@@ -221,6 +248,20 @@ namespace vsg
                 if (distance(face[5], s.center) < negative_radius) return false;
             return true;
         }
+
+        /// return true if the sphere intersects the frustum, setting inside to whether the sphere is entirely inside the frustum.
+        template<typename T>
+        bool intersect(const t_sphere<T>& s, bool& inside) const
+        {
+            inside = true;
+            for (size_t i = 0; i < POLYTOPE_SIZE; ++i)
+            {
+                auto d = distance(face[i], s.center);
+                if (d < -s.radius) return false;
+                if (d < s.radius) inside = false;
+            }
+            return true;
+        }
     };
 
     /// vsg::State is used by vsg::RecordTraversal to manage state stacks, projection and modelview matrices and frustum stacks.
@@ -231,6 +272,7 @@ namespace vsg
             dirty(false),
             stateStacks(static_cast<size_t>(maxSlot) + 1)
         {
+            assignDirtySlotMasks();
         }
 
         using StateStacks = std::vector<StateStack<StateCommand>>;
@@ -240,7 +282,7 @@ namespace vsg
         Frustum _frustumUnit;
         Frustum _frustumProjected;
 
-        using FrustumStack = std::stack<Frustum>;
+        using FrustumStack = std::stack<Frustum, transient_vector<Frustum>>;
         FrustumStack _frustumStack;
 
         bool dirty = true;
@@ -252,6 +294,33 @@ namespace vsg
 
         StateStacks stateStacks;
 
+        /// bit mask of the stateStacks that have been modified since they were last recorded, one bit per slot.
+        std::vector<uint64_t> dirtySlotMasks;
+
+        /// statistics of the StateCommand recorded, and the StateStack that record() didn't need to check as they were unmodified.
+        uint64_t numStateCommandsRecorded = 0;
+        uint64_t numStateStacksSkipped = 0;
+
+        /// resize the stateStacks to accommodate the specified maxSlot
+        void setMaxSlot(uint32_t maxSlot)
+        {
+            stateStacks.resize(static_cast<size_t>(maxSlot) + 1);
+            assignDirtySlotMasks();
+        }
+
+        /// assign the dirtySlotMasks to the stateStacks, required after the stateStacks have been resized.
+        void assignDirtySlotMasks()
+        {
+            dirtySlotMasks.assign((stateStacks.size() + 63) / 64, 0);
+            for (size_t slot = 0; slot < stateStacks.size(); ++slot)
+            {
+                auto& stateStack = stateStacks[slot];
+                stateStack.dirtySlotMask = &dirtySlotMasks[slot / 64];
+                stateStack.dirtySlotBit = uint64_t(1) << (slot % 64);
+                if (stateStack.dirty) *stateStack.dirtySlotMask |= stateStack.dirtySlotBit;
+            }
+        }
+
         MatrixStack projectionMatrixStack{0};
         MatrixStack modelviewMatrixStack{64};
 
@@ -283,14 +352,94 @@ namespace vsg
             pushFrustum();
         }
 
+        /// set up this State to continue the traversal from the current position of the parent State, taking the top of the parent's matrix, frustum and state stacks.
+        /// Used when recording part of a subgraph to a secondary CommandBuffer, all inherited StateCommands are marked as dirty so they are recorded again.
+        void inherit(const State& parent)
+        {
+            inheritViewForLODScaling = parent.inheritViewForLODScaling;
+            inheritedProjectionMatrix = parent.inheritedProjectionMatrix;
+            inheritedViewMatrix = parent.inheritedViewMatrix;
+            inheritedViewTransform = parent.inheritedViewTransform;
+
+            _frustumProjected = parent._frustumProjected;
+            projectionMatrixStack.set(parent.projectionMatrixStack.top());
+            modelviewMatrixStack.set(parent.modelviewMatrixStack.top());
+
+            while (!_frustumStack.empty()) _frustumStack.pop();
+            _frustumStack.push(parent._frustumStack.top());
+
+            if (stateStacks.size() < parent.stateStacks.size()) setMaxSlot(static_cast<uint32_t>(parent.stateStacks.size() - 1));
+
+            for (size_t slot = 0; slot < stateStacks.size(); ++slot)
+            {
+                auto& stateStack = stateStacks[slot];
+                while (!stateStack.stack.empty()) stateStack.stack.pop();
+                stateStack.dirty = false;
+
+                if (slot < parent.stateStacks.size() && parent.stateStacks[slot].size() > 0)
+                {
+                    stateStack.push(parent.stateStacks[slot].top());
+                }
+            }
+
+            resetLastRecorded();
+
+            dirty = true;
+        }
+
+        /// mark all the current StateCommands and matrices as dirty so they are recorded again, required after vkCmdExecuteCommands as the CommandBuffer's state is then undefined.
+        /// forget which StateCommands were last recorded so that the next record() binds them again, required when starting a new CommandBuffer or View.
+        void resetLastRecorded()
+        {
+            for (auto& stateStack : stateStacks) stateStack.lastRecorded = nullptr;
+        }
+
+        void dirtyStateStacks()
+        {
+            for (auto& stateStack : stateStacks)
+            {
+                if (stateStack.size() > 0) stateStack.setDirty();
+            }
+            resetLastRecorded();
+            projectionMatrixStack.dirty = true;
+            modelviewMatrixStack.dirty = true;
+            dirty = true;
+        }
+
         inline void record()
         {
             if (dirty)
             {
-                for (auto& stateStack : stateStacks)
+                // stateStacks resized without calling setMaxSlot()
+                if (dirtySlotMasks.size() != (stateStacks.size() + 63) / 64 || (!stateStacks.empty() && !stateStacks.back().dirtySlotMask)) assignDirtySlotMasks();
+
+                // only record the stateStacks flagged in the dirtySlotMasks, in ascending slot order
+                // binding a pipeline or descriptor set can disturb the bindings of higher slots, so once a slot records, higher slots must record again
+                size_t numStateStacksChecked = 0;
+                bool lowerSlotRecorded = false;
+                size_t baseSlot = 0;
+                for (auto& mask : dirtySlotMasks)
                 {
-                    stateStack.record(*_commandBuffer);
+                    for (size_t slot = baseSlot; mask != 0 && slot < stateStacks.size(); ++slot, mask >>= 1)
+                    {
+                        if ((mask & 1) != 0)
+                        {
+                            ++numStateStacksChecked;
+                            if (stateStacks[slot].record(*_commandBuffer))
+                            {
+                                ++numStateCommandsRecorded;
+                                if (!lowerSlotRecorded)
+                                {
+                                    for (size_t higherSlot = slot + 1; higherSlot < stateStacks.size(); ++higherSlot) stateStacks[higherSlot].lastRecorded = nullptr;
+                                    lowerSlotRecorded = true;
+                                }
+                            }
+                        }
+                    }
+                    mask = 0;
+                    baseSlot += 64;
                 }
+                numStateStacksSkipped += stateStacks.size() - numStateStacksChecked;
 
                 projectionMatrixStack.record(*_commandBuffer);
                 modelviewMatrixStack.record(*_commandBuffer);
@@ -325,6 +474,12 @@ namespace vsg
             return _frustumStack.top().intersect(s);
         }
 
+        template<typename T>
+        bool intersect(const t_sphere<T>& s, bool& inside) const
+        {
+            return _frustumStack.top().intersect(s, inside);
+        }
+
         template<typename T>
         T lodDistance(const t_sphere<T>& s) const
         {
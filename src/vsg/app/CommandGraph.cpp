@@ -86,7 +86,7 @@ void CommandGraph::record(ref_ptr<RecordedCommandBuffers> recordedCommandBuffers
 
     if ((maxSlot + 1) != recordTraversal->getState()->stateStacks.size())
     {
-        recordTraversal->getState()->stateStacks.resize(maxSlot + 1);
+        recordTraversal->getState()->setMaxSlot(maxSlot);
     }
 
     recordTraversal->recordedCommandBuffers = recordedCommandBuffers;
@@ -118,6 +118,7 @@ void CommandGraph::record(ref_ptr<RecordedCommandBuffers> recordedCommandBuffers
     commandBuffer->numDependentSubmissions().fetch_add(1);
 
     recordTraversal->getState()->_commandBuffer = commandBuffer;
+    recordTraversal->getState()->resetLastRecorded();
 
     // or select index when maps to a dormant CommandBuffer
     VkCommandBuffer vk_commandBuffer = *commandBuffer;
@@ -166,8 +166,11 @@ void CompileManager::assignInstrumentation(ref_ptr<Instrumentation> in_instrumen
     }
 }
 
-CompileResult CompileManager::compile(ref_ptr<Object> object, ContextSelectionFunction contextSelection)
+CompileResult CompileManager::compile(ref_ptr<Object> object, ContextSelectionFunction contextSelection, ref_ptr<ActivityStatus> activityStatus)
 {
+    // skip the compile if it has already been cancelled
+    if (activityStatus && activityStatus->cancel()) return CompileResult{VK_INCOMPLETE, "Compile cancelled."};
+
     CollectResourceRequirements collectRequirements;
     object->accept(collectRequirements);
 
@@ -186,6 +189,14 @@ CompileResult CompileManager::compile(ref_ptr<Object> object, ContextSelectionFu
     // if no CompileTraversals are available abort compile
     if (!compileTraversal) return result;
 
+    // the compile may have been cancelled while waiting for a CompileTraversal to become available
+    if (activityStatus && activityStatus->cancel())
+    {
+        compileTraversals->add(compileTraversal);
+        result.message = "Compile cancelled.";
+        return result;
+    }
+
     auto run_compile_traversal = [&]() -> void {
         try
         {
@@ -0,0 +1,312 @@
+/* <editor-fold desc="MIT License">
+
+Copyright(c) 2024 Robert Osfield
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"), to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+</editor-fold> */
+
+#include <vsg/app/ParallelRecordGroup.h>
+#include <vsg/app/RecordTraversal.h>
+#include <vsg/io/Options.h>
+#include <vsg/io/stream.h>
+#include <vsg/nodes/CullGroup.h>
+#include <vsg/nodes/QuadGroup.h>
+#include <vsg/threading/Latch.h>
+#include <vsg/utils/Instrumentation.h>
+#include <vsg/vk/CommandPool.h>
+#include <vsg/vk/State.h>
+
+#include <algorithm>
+
+using namespace vsg;
+
+struct ParallelRecordGroup::RecordOperation : public Inherit<Operation, RecordOperation>
+{
+    RecordOperation(const ParallelRecordGroup* in_group, ref_ptr<Worker> in_worker, ref_ptr<Latch> in_latch) :
+        group(in_group),
+        worker(in_worker),
+        latch(in_latch) {}
+
+    const ParallelRecordGroup* group;
+    ref_ptr<Worker> worker;
+    ref_ptr<Latch> latch;
+
+    void run() override
+    {
+        group->_record(*worker);
+        latch->count_down();
+    }
+};
+
+ParallelRecordGroup::ParallelRecordGroup()
+{
+}
+
+ParallelRecordGroup::ParallelRecordGroup(const ParallelRecordGroup& rhs, const CopyOp& copyop) :
+    Inherit(rhs, copyop),
+    numThreads(rhs.numThreads),
+    partitionsPerThread(rhs.partitionsPerThread),
+    maxPartitionDepth(rhs.maxPartitionDepth),
+    operationThreads(rhs.operationThreads)
+{
+}
+
+ParallelRecordGroup::~ParallelRecordGroup()
+{
+}
+
+int ParallelRecordGroup::compare(const Object& rhs_object) const
+{
+    int result = Group::compare(rhs_object);
+    if (result != 0) return result;
+
+    auto& rhs = static_cast<decltype(*this)>(rhs_object);
+    if ((result = compare_value(numThreads, rhs.numThreads))) return result;
+    if ((result = compare_value(partitionsPerThread, rhs.partitionsPerThread))) return result;
+    return compare_value(maxPartitionDepth, rhs.maxPartitionDepth);
+}
+
+void ParallelRecordGroup::read(Input& input)
+{
+    Group::read(input);
+
+    input.read("numThreads", numThreads);
+    input.read("partitionsPerThread", partitionsPerThread);
+    input.read("maxPartitionDepth", maxPartitionDepth);
+}
+
+void ParallelRecordGroup::write(Output& output) const
+{
+    Group::write(output);
+
+    output.write("numThreads", numThreads);
+    output.write("partitionsPerThread", partitionsPerThread);
+    output.write("maxPartitionDepth", maxPartitionDepth);
+}
+
+void ParallelRecordGroup::accept(RecordTraversal& recordTraversal) const
+{
+    CPU_INSTRUMENTATION_L1_NC(recordTraversal.instrumentation, "ParallelRecordGroup", COLOR_RECORD_L1);
+
+    auto commandBuffer = recordTraversal.getCommandBuffer();
+    uint32_t threadCount = numThreads > 0 ? numThreads : std::max(1u, std::thread::hardware_concurrency());
+
+    // secondary CommandBuffers can only be executed from a primary CommandBuffer, and within a render pass only when the subpass contents are secondary CommandBuffers
+    bool secondaryContents = commandBuffer->renderPass != VK_NULL_HANDLE && commandBuffer->subpassContents == VK_SUBPASS_CONTENTS_SECONDARY_COMMAND_BUFFERS;
+    bool inlineContents = commandBuffer->renderPass != VK_NULL_HANDLE && commandBuffer->subpassContents == VK_SUBPASS_CONTENTS_INLINE;
+    if (commandBuffer->level() != VK_COMMAND_BUFFER_LEVEL_PRIMARY || !recordTraversal.recordedCommandBuffers || inlineContents || (threadCount <= 1 && !secondaryContents))
+    {
+        traverse(recordTraversal);
+        return;
+    }
+
+    std::scoped_lock<std::mutex> lock(_mutex);
+
+    _partition(recordTraversal, static_cast<size_t>(threadCount) * std::max(1u, partitionsPerThread));
+    if (_numPartitions == 0) return;
+
+    // set up the workers' RecordTraversal to inherit the bins and settings of the parent RecordTraversal
+    auto state = recordTraversal.getState();
+    size_t numWorkers = std::min(static_cast<size_t>(threadCount), _numPartitions);
+    while (_workers.size() < numWorkers)
+    {
+        _workers.push_back(Worker::create());
+    }
+
+    for (size_t i = 0; i < numWorkers; ++i)
+    {
+        auto& worker = _workers[i];
+        if (!worker->recordTraversal) worker->recordTraversal = RecordTraversal::create(static_cast<uint32_t>(state->stateStacks.size() - 1));
+        worker->recordTraversal->inherit(recordTraversal);
+    }
+
+    _parent = &recordTraversal;
+    _partitionCommandBuffers.assign(_numPartitions, {});
+    _nextPartition = 0;
+
+    if (numWorkers > 1)
+    {
+        auto threads = operationThreads;
+        if (!threads)
+        {
+            if (!_operationThreads) _operationThreads = OperationThreads::create(threadCount - 1);
+            threads = _operationThreads;
+        }
+
+        auto latch = Latch::create(static_cast<int>(numWorkers - 1));
+        for (size_t i = 1; i < numWorkers; ++i)
+        {
+            threads->add(RecordOperation::create(this, _workers[i], latch));
+        }
+
+        // the calling thread records partitions as well, then waits for the other workers to complete
+        _record(*_workers[0]);
+
+        latch->wait();
+    }
+    else
+    {
+        _record(*_workers[0]);
+    }
+
+    _parent = nullptr;
+
+    for (size_t i = 0; i < numWorkers; ++i)
+    {
+        _workers[i]->recordTraversal->mergeTo(recordTraversal);
+    }
+
+    // execute the secondary CommandBuffers in partition order, and pass them on to the RecordedCommandBuffers so they aren't reused till the frame has completed.
+    _vk_commandBuffers.clear();
+    for (auto& partitionCommandBuffer : _partitionCommandBuffers)
+    {
+        _vk_commandBuffers.push_back(*partitionCommandBuffer);
+        recordTraversal.recordedCommandBuffers->add(0, partitionCommandBuffer);
+    }
+    _partitionCommandBuffers.clear();
+
+    vkCmdExecuteCommands(*commandBuffer, static_cast<uint32_t>(_vk_commandBuffers.size()), _vk_commandBuffers.data());
+
+    // the state of the primary CommandBuffer is undefined after vkCmdExecuteCommands so any subsequent state must be recorded again
+    state->dirtyStateStacks();
+}
+
+void ParallelRecordGroup::_partition(RecordTraversal& recordTraversal, size_t targetNumPartitions) const
+{
+    auto state = recordTraversal.getState();
+
+    _nodes.clear();
+    for (auto& child : children)
+    {
+        if (child) _nodes.push_back(child.get());
+    }
+
+    // expand the Group, QuadGroup and CullGroup one level at a time till there are enough nodes to partition, culling the CullGroup outside the view frustum.
+    for (uint32_t depth = 0; depth < maxPartitionDepth && _nodes.size() < targetNumPartitions; ++depth)
+    {
+        bool expanded = false;
+        _expandedNodes.clear();
+        for (auto node : _nodes)
+        {
+            const auto& type = node->type_info();
+            if (type == typeid(Group))
+            {
+                for (auto& child : static_cast<const Group*>(node)->children)
+                {
+                    if (child) _expandedNodes.push_back(child.get());
+                }
+                expanded = true;
+            }
+            else if (type == typeid(QuadGroup))
+            {
+                for (auto& child : static_cast<const QuadGroup*>(node)->children)
+                {
+                    if (child) _expandedNodes.push_back(child.get());
+                }
+                expanded = true;
+            }
+            else if (type == typeid(CullGroup))
+            {
+                auto cullGroup = static_cast<const CullGroup*>(node);
+                if (state->intersect(cullGroup->bound))
+                {
+                    for (auto& child : cullGroup->children)
+                    {
+                        if (child) _expandedNodes.push_back(child.get());
+                    }
+                }
+                expanded = true;
+            }
+            else
+            {
+                _expandedNodes.push_back(node);
+            }
+        }
+
+        _nodes.swap(_expandedNodes);
+
+        if (!expanded) break;
+    }
+
+    _numPartitions = std::min(_nodes.size(), targetNumPartitions);
+}
+
+void ParallelRecordGroup::_record(Worker& worker) const
+{
+    auto& recordTraversal = *worker.recordTraversal;
+    auto state = recordTraversal.getState();
+    auto parentState = _parent->getState();
+    auto parentCommandBuffer = _parent->getCommandBuffer();
+    auto device = parentCommandBuffer->getDevice();
+
+    VkCommandBufferInheritanceInfo inheritanceInfo = {};
+    inheritanceInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_INHERITANCE_INFO;
+    inheritanceInfo.renderPass = parentCommandBuffer->renderPass;
+    inheritanceInfo.subpass = parentCommandBuffer->subpass;
+    inheritanceInfo.framebuffer = parentCommandBuffer->framebuffer;
+
+    VkCommandBufferBeginInfo beginInfo = {};
+    beginInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
+    beginInfo.flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT;
+    if (inheritanceInfo.renderPass != VK_NULL_HANDLE) beginInfo.flags |= VK_COMMAND_BUFFER_USAGE_RENDER_PASS_CONTINUE_BIT;
+    beginInfo.pInheritanceInfo = &inheritanceInfo;
+
+    // take partitions till there are none left, so workers that finish early take on more of the work
+    size_t partition = 0;
+    while ((partition = _nextPartition.fetch_add(1)) < _numPartitions)
+    {
+        ref_ptr<CommandBuffer> commandBuffer;
+        for (auto& cb : worker.commandBuffers)
+        {
+            if (cb->numDependentSubmissions() == 0 && cb->getDevice() == device)
+            {
+                commandBuffer = cb;
+                break;
+            }
+        }
+        if (!commandBuffer)
+        {
+            // each CommandBuffer has its own CommandPool as CommandBuffer::reset() resets the CommandPool.
+            auto commandPool = CommandPool::create(device, parentCommandBuffer->getCommandPool()->queueFamilyIndex);
+            commandBuffer = commandPool->allocate(VK_COMMAND_BUFFER_LEVEL_SECONDARY);
+            worker.commandBuffers.push_back(commandBuffer);
+        }
+        else
+        {
+            commandBuffer->reset();
+        }
+
+        commandBuffer->numDependentSubmissions().fetch_add(1);
+
+        commandBuffer->viewID = parentCommandBuffer->viewID;
+        commandBuffer->traversalMask = parentCommandBuffer->traversalMask;
+        commandBuffer->overrideMask = parentCommandBuffer->overrideMask;
+        commandBuffer->viewDependentState = parentCommandBuffer->viewDependentState;
+        commandBuffer->renderPass = parentCommandBuffer->renderPass;
+        commandBuffer->subpass = parentCommandBuffer->subpass;
+        commandBuffer->framebuffer = parentCommandBuffer->framebuffer;
+
+        vkBeginCommandBuffer(*commandBuffer, &beginInfo);
+
+        state->_commandBuffer = commandBuffer;
+        state->inherit(*parentState);
+
+        size_t begin = (partition * _nodes.size()) / _numPartitions;
+        size_t end = ((partition + 1) * _nodes.size()) / _numPartitions;
+        for (size_t i = begin; i < end; ++i)
+        {
+            _nodes[i]->accept(recordTraversal);
+        }
+
+        vkEndCommandBuffer(*commandBuffer);
+
+        _partitionCommandBuffers[partition] = commandBuffer;
+    }
+
+    state->_commandBuffer = {};
+}
@@ -29,6 +29,7 @@ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLI
 #include <vsg/nodes/Bin.h>
 #include <vsg/nodes/CullGroup.h>
 #include <vsg/nodes/CullNode.h>
+#include <vsg/nodes/CulledInstanceDraw.h>
 #include <vsg/nodes/DepthSorted.h>
 #include <vsg/nodes/Geometry.h>
 #include <vsg/nodes/Group.h>
@@ -46,6 +47,8 @@ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLI
 #include <vsg/state/ViewDependentState.h>
 #include <vsg/threading/atomics.h>
 #include <vsg/ui/ApplicationEvent.h>
+#include <vsg/utils/OcclusionBuffer.h>
+#include <vsg/utils/PagedLODPrefetch.h>
 #include <vsg/vk/CommandBuffer.h>
 #include <vsg/vk/RenderPass.h>
 #include <vsg/vk/State.h>
@@ -115,6 +118,113 @@ void RecordTraversal::clearBins()
     }
 }
 
+void RecordTraversal::inherit(const RecordTraversal& parent)
+{
+    CPU_INSTRUMENTATION_L2_NC(instrumentation, "RecordTraversal inherit", COLOR_RECORD_L2);
+
+    traversalMask = parent.traversalMask;
+    overrideMask = parent.overrideMask;
+    recordedCommandBuffers = parent.recordedCommandBuffers;
+    _frameStamp = parent._frameStamp;
+    _databasePager = parent._databasePager;
+
+    // collect culled PagedLOD locally so that the shared CulledPagedLODs is only modified by the parent in mergeTo()
+    if (parent._culledPagedLODs)
+    {
+        if (!_localCulledPagedLODs) _localCulledPagedLODs = CulledPagedLODs::create();
+        _localCulledPagedLODs->clear();
+        _culledPagedLODs = _localCulledPagedLODs;
+    }
+    else
+    {
+        _culledPagedLODs = {};
+    }
+
+    // the parent's ViewDependentState isn't thread safe so don't collect lights
+    _viewDependentState = {};
+
+    // the occlusion buffer is only read during the traversal so can be shared with the parent
+    _occlusionBuffer = parent._occlusionBuffer;
+    _occlusionViewID = parent._occlusionViewID;
+
+    // the PagedLODPrefetch's predicted view is only read during the traversal so can be shared with the parent
+    _pagedLODPrefetch = parent._pagedLODPrefetch;
+
+    // inherit whether the subgraph is known to be inside the view frustum
+    _insideFrustum = parent._insideFrustum;
+    _numCullTests = 0;
+    _numCullTestsSkipped = 0;
+
+    // mirror the parent's bins with local Bin that are merged back into the parent's bins in mergeTo()
+    _minimumBinNumber = parent._minimumBinNumber;
+    _bins.resize(parent._bins.size());
+    for (size_t i = 0; i < parent._bins.size(); ++i)
+    {
+        auto& parentBin = parent._bins[i];
+        auto& bin = _bins[i];
+        if (!parentBin)
+        {
+            bin = {};
+        }
+        else if (!bin || bin->binNumber != parentBin->binNumber || bin->sortOrder != parentBin->sortOrder)
+        {
+            bin = Bin::create(parentBin->binNumber, parentBin->sortOrder);
+        }
+        else
+        {
+            bin->clear();
+        }
+    }
+
+    regionsOfInterest.clear();
+}
+
+void RecordTraversal::mergeTo(RecordTraversal& parent)
+{
+    CPU_INSTRUMENTATION_L2_NC(instrumentation, "RecordTraversal mergeTo", COLOR_RECORD_L2);
+
+    for (size_t i = 0; i < _bins.size() && i < parent._bins.size(); ++i)
+    {
+        if (_bins[i] && parent._bins[i]) parent._bins[i]->add(*_bins[i]);
+    }
+
+    parent.regionsOfInterest.insert(parent.regionsOfInterest.end(), regionsOfInterest.begin(), regionsOfInterest.end());
+    regionsOfInterest.clear();
+
+    if (_localCulledPagedLODs && parent._culledPagedLODs)
+    {
+        auto& highresCulled = parent._culledPagedLODs->highresCulled;
+        highresCulled.insert(highresCulled.end(), _localCulledPagedLODs->highresCulled.begin(), _localCulledPagedLODs->highresCulled.end());
+
+        auto& newHighresRequired = parent._culledPagedLODs->newHighresRequired;
+        newHighresRequired.insert(newHighresRequired.end(), _localCulledPagedLODs->newHighresRequired.begin(), _localCulledPagedLODs->newHighresRequired.end());
+
+        _localCulledPagedLODs->clear();
+    }
+
+    parent._numCullTests += _numCullTests;
+    parent._numCullTestsSkipped += _numCullTestsSkipped;
+    _numCullTests = 0;
+    _numCullTestsSkipped = 0;
+}
+
+bool RecordTraversal::_visible(const dsphere& bound, bool& inside)
+{
+    if (_insideFrustum)
+    {
+        // an ancestor was found to be entirely inside the view frustum
+        ++_numCullTestsSkipped;
+        inside = true;
+    }
+    else
+    {
+        ++_numCullTests;
+        if (!_state->intersect(bound, inside)) return false;
+    }
+
+    return !(_occlusionBuffer && _occlusionBuffer->occluded(bound, _state->modelviewMatrixStack.top(), _occlusionViewID));
+}
+
 void RecordTraversal::apply(const Object& object)
 {
     // GPU_INSTRUMENTATION_L2_NCO(instrumentation, *getCommandBuffer(), "Object", COLOR_RECORD_L2, &object);
@@ -123,11 +233,46 @@ void RecordTraversal::apply(const Object& object)
     object.traverse(*this);
 }
 
+template<class C>
+void RecordTraversal::_traverseVisibleChildren(const C& children, const PackedBounds& childBounds)
+{
+    // cull all the children in one batch, _childVisibility is used as a stack so nested groups append their results after ours
+    size_t base = _childVisibility.size();
+    _childVisibility.resize(base + childBounds.count);
+    _numCullTests += childBounds.count;
+    childBounds.intersect(_state->_frustumStack.top().face, POLYTOPE_SIZE, _childVisibility.data() + base);
+
+    size_t i = base;
+    for (auto& child : children)
+    {
+        if (_childVisibility[i++] == 0) continue;
+
+        // CullGroup and CullNode have passed the frustum test so traverse their subgraphs directly, unless they still need an occlusion test
+        const auto& type = child->type_info();
+        if (_occlusionBuffer)
+            child->accept(*this);
+        else if (type == typeid(CullGroup))
+            static_cast<const CullGroup&>(*child).traverse(*this);
+        else if (type == typeid(CullNode))
+            static_cast<const CullNode&>(*child).traverse(*this);
+        else
+            child->accept(*this);
+    }
+
+    _childVisibility.resize(base);
+}
+
 void RecordTraversal::apply(const Group& group)
 {
     GPU_INSTRUMENTATION_L2_NCO(instrumentation, *getCommandBuffer(), "Group", COLOR_RECORD_L2, &group);
 
     //debug("Visiting Group");
+    if (group.childBounds && group.childBounds->count == group.children.size() && !_insideFrustum)
+    {
+        _traverseVisibleChildren(group.children, *group.childBounds);
+        return;
+    }
+
 #if INLINE_TRAVERSE
     vsg::Group::t_traverse(group, *this);
 #else
@@ -140,6 +285,12 @@ void RecordTraversal::apply(const QuadGroup& quadGroup)
     GPU_INSTRUMENTATION_L2_NCO(instrumentation, *getCommandBuffer(), "QuadGroup", COLOR_RECORD_L2, &quadGroup);
 
     //debug("Visiting QuadGroup");
+    if (quadGroup.childBounds && quadGroup.childBounds->count == quadGroup.children.size() && !_insideFrustum)
+    {
+        _traverseVisibleChildren(quadGroup.children, *quadGroup.childBounds);
+        return;
+    }
+
 #if INLINE_TRAVERSE
     vsg::QuadGroup::t_traverse(quadGroup, *this);
 #else
@@ -160,6 +311,11 @@ void RecordTraversal::apply(const LOD& lod)
         return;
     }
 
+    if (_occlusionBuffer && _occlusionBuffer->occluded(sphere, _state->modelviewMatrixStack.top(), _occlusionViewID))
+    {
+        return;
+    }
+
     for (auto& child : lod.children)
     {
         auto cutoff = lodDistance * child.minimumScreenHeightRatio;
@@ -172,6 +328,46 @@ void RecordTraversal::apply(const LOD& lod)
     }
 }
 
+bool RecordTraversal::_prefetch(const PagedLOD& plod, uint64_t frameCount)
+{
+    // test the high res child against the predicted view
+    const auto& sphere = plod.bound;
+    const auto& child = plod.children[0];
+
+    auto lodDistance = _pagedLODPrefetch->lodDistance(sphere, _state->modelviewMatrixStack.top());
+    if (lodDistance < 0.0) return false;
+
+    auto cutoff = lodDistance * child.minimumScreenHeightRatio;
+    if (sphere.r <= cutoff) return false;
+
+    // keep the high res child active so it isn't released before it's required
+    auto previousHighResUsed = plod.frameHighResLastUsed.exchange(frameCount);
+    if (_culledPagedLODs && ((frameCount - previousHighResUsed) > 1))
+    {
+        _culledPagedLODs->newHighresRequired.emplace_back(&plod);
+    }
+
+    if (child.node) return true;
+
+    // request with a reduced priority so that PagedLOD required by the current view are loaded first
+    auto priority = (sphere.r / cutoff) * _pagedLODPrefetch->priorityScale;
+    bool priorityIncreased = exchange_if_greater(plod.priority, priority);
+
+    auto previousRequestCount = plod.requestCount.fetch_add(1);
+    if (previousRequestCount == 0)
+    {
+        plod.prefetched.exchange(true);
+        ++_pagedLODPrefetch->numRequests;
+        _databasePager->request(ref_ptr<PagedLOD>(const_cast<PagedLOD*>(&plod)));
+    }
+    else if (priorityIncreased)
+    {
+        _databasePager->updatePriority(&plod);
+    }
+
+    return true;
+}
+
 void RecordTraversal::apply(const PagedLOD& plod)
 {
     GPU_INSTRUMENTATION_L2_NCO(instrumentation, *getCommandBuffer(), "PagedLOD", COLOR_PAGER, &plod);
@@ -183,7 +379,9 @@ void RecordTraversal::apply(const PagedLOD& plod)
     auto lodDistance = _state->lodDistance(sphere);
     if (lodDistance < 0.0)
     {
-        if ((frameCount - plod.frameHighResLastUsed) > 1 && _culledPagedLODs)
+        // the high res child may still be required by the predicted view
+        bool prefetched = _pagedLODPrefetch && _pagedLODPrefetch->active() && _prefetch(plod, frameCount);
+        if (!prefetched && (frameCount - plod.frameHighResLastUsed) > 1 && _culledPagedLODs)
         {
             _culledPagedLODs->highresCulled.emplace_back(&plod);
         }
@@ -205,6 +403,14 @@ void RecordTraversal::apply(const PagedLOD& plod)
                 _culledPagedLODs->newHighresRequired.emplace_back(&plod);
             }
 
+            if (plod.prefetched.exchange(false) && _pagedLODPrefetch)
+            {
+                if (child.node)
+                    ++_pagedLODPrefetch->numHits;
+                else
+                    ++_pagedLODPrefetch->numLate;
+            }
+
             if (child.node)
             {
                 // high res visible and available so traverse it
@@ -214,7 +420,7 @@ void RecordTraversal::apply(const PagedLOD& plod)
             else if (_databasePager)
             {
                 auto priority = sphere.r / cutoff;
-                exchange_if_greater(plod.priority, priority);
+                bool priorityIncreased = exchange_if_greater(plod.priority, priority);
 
                 auto previousRequestCount = plod.requestCount.fetch_add(1);
                 if (previousRequestCount == 0)
@@ -222,6 +428,11 @@ void RecordTraversal::apply(const PagedLOD& plod)
                     // we are the first request so tell the databasePager about it
                     _databasePager->request(ref_ptr<PagedLOD>(const_cast<PagedLOD*>(&plod)));
                 }
+                else if (priorityIncreased)
+                {
+                    // the request may still be queued so let the databasePager reorder it
+                    _databasePager->updatePriority(&plod);
+                }
                 else
                 {
                     //debug("repeat request ",&plod,", ",plod.filename,", ",plod.requestCount.load(),", plod.requestStatus = ",plod.requestStatus.load());
@@ -230,7 +441,8 @@ void RecordTraversal::apply(const PagedLOD& plod)
         }
         else
         {
-            if (_culledPagedLODs && ((frameCount - plod.frameHighResLastUsed) <= 1))
+            bool prefetched = _pagedLODPrefetch && _pagedLODPrefetch->active() && _prefetch(plod, frameCount);
+            if (!prefetched && _culledPagedLODs && ((frameCount - plod.frameHighResLastUsed) <= 1))
             {
                 _culledPagedLODs->highresCulled.emplace_back(&plod);
             }
@@ -263,10 +475,21 @@ void RecordTraversal::apply(const CullGroup& cullGroup)
 {
     GPU_INSTRUMENTATION_L2_NCO(instrumentation, *getCommandBuffer(), "CullGroup", COLOR_RECORD_L2, &cullGroup);
 
-    if (_state->intersect(cullGroup.bound))
+    bool inside = false;
+    if (_visible(cullGroup.bound, inside))
     {
         // debug("Passed node");
-        cullGroup.traverse(*this);
+        if (inside && !_insideFrustum)
+        {
+            // the subgraph is entirely inside the view frustum so its cull tests can be skipped
+            _insideFrustum = true;
+            cullGroup.traverse(*this);
+            _insideFrustum = false;
+        }
+        else
+        {
+            cullGroup.traverse(*this);
+        }
     }
 }
 
@@ -274,10 +497,21 @@ void RecordTraversal::apply(const CullNode& cullNode)
 {
     GPU_INSTRUMENTATION_L2_NCO(instrumentation, *getCommandBuffer(), "CullNode", COLOR_RECORD_L2, &cullNode);
 
-    if (_state->intersect(cullNode.bound))
+    bool inside = false;
+    if (_visible(cullNode.bound, inside))
     {
         //debug("Passed node");
-        cullNode.traverse(*this);
+        if (inside && !_insideFrustum)
+        {
+            // the subgraph is entirely inside the view frustum so its cull tests can be skipped
+            _insideFrustum = true;
+            cullNode.traverse(*this);
+            _insideFrustum = false;
+        }
+        else
+        {
+            cullNode.traverse(*this);
+        }
     }
 }
 
@@ -342,6 +576,16 @@ void RecordTraversal::apply(const VertexIndexDraw& vid)
     vid.record(*(_state->_commandBuffer));
 }
 
+void RecordTraversal::apply(const CulledInstanceDraw& cid)
+{
+    GPU_INSTRUMENTATION_L3_NCO(instrumentation, *getCommandBuffer(), "CulledInstanceDraw", COLOR_GPU, &cid);
+
+    if (recordedCommandBuffers) cid.dispatch(*_state, _frameStamp, *recordedCommandBuffers);
+
+    _state->record();
+    cid.record(*(_state->_commandBuffer));
+}
+
 void RecordTraversal::apply(const Geometry& geometry)
 {
     GPU_INSTRUMENTATION_L3_NCO(instrumentation, *getCommandBuffer(), "Geometry", COLOR_GPU, &geometry);
@@ -503,14 +747,34 @@ void RecordTraversal::apply(const View& view)
     _state->_commandBuffer->viewID = view.viewID;
     _state->_commandBuffer->viewDependentState = view.viewDependentState.get();
 
-    // cache the previous bins
+    // StateCommands select their Vulkan objects by viewID so must be bound again within each View
+    _state->resetLastRecorded();
+
+    // cache the previous bins and regionsOfInterest, swapping in the containers used by this View's nesting level in previous frames so their capacity is reused
+    size_t viewDepth = _viewDepth++;
+    if (viewDepth >= _viewBins.size())
+    {
+        _viewBins.resize(viewDepth + 1);
+        _viewRegionsOfInterest.resize(viewDepth + 1);
+    }
+
     int32_t cached_minimumBinNumber = _minimumBinNumber;
-    decltype(_bins) cached_bins;
-    cached_bins.swap(_bins);
+    _viewBins[viewDepth].swap(_bins);
+    _bins.clear();
     auto cached_viewDependentState = _viewDependentState;
+    auto cached_occlusionBuffer = _occlusionBuffer;
+    auto cached_occlusionViewID = _occlusionViewID;
+    auto cached_pagedLODPrefetch = _pagedLODPrefetch;
+    auto cached_insideFrustum = _insideFrustum;
+
+    if (viewDepth == 0)
+    {
+        _numCullTests = 0;
+        _numCullTestsSkipped = 0;
+    }
 
-    decltype(regionsOfInterest) cached_regionsOfInterest;
-    cached_regionsOfInterest.swap(regionsOfInterest);
+    _viewRegionsOfInterest[viewDepth].swap(regionsOfInterest);
+    regionsOfInterest.clear();
 
     // assign and clear the View's bins
     int32_t min_binNumber = 0;
@@ -541,6 +805,29 @@ void RecordTraversal::apply(const View& view)
         _state->inheritViewForLODScaling = (view.features & INHERIT_VIEWPOINT) != 0;
         _state->setProjectionAndViewMatrix(view.camera->projectionMatrix->transform(), view.camera->viewMatrix->transform());
 
+        // rasterize the occluders for this View's camera, nested Views with their own camera don't inherit the parent's occlusion buffer
+        // each View uses its own depth buffer so an OcclusionBuffer shared by Views recorded in parallel, or by nested Views, isn't overwritten while in use
+        _occlusionBuffer = view.occlusionBuffer.get();
+        _occlusionViewID = view.viewID;
+        if (_occlusionBuffer)
+        {
+            CPU_INSTRUMENTATION_L2_NC(instrumentation, "OcclusionBuffer rasterize", COLOR_RECORD_L2);
+            _occlusionBuffer->rasterize(view.camera->projectionMatrix->transform(), view.camera->viewMatrix->transform(), _occlusionViewID);
+        }
+
+        // nested Views with their own camera start outside of any subgraph known to be inside their frustum
+        _insideFrustum = false;
+
+        // extrapolate the camera path to find the PagedLOD that will be required shortly
+        _pagedLODPrefetch = nullptr;
+        if (view.pagedLODPrefetch && _databasePager && _frameStamp)
+        {
+            _pagedLODPrefetch = view.pagedLODPrefetch.get();
+
+            double time = std::chrono::duration<double>(_frameStamp->time.time_since_epoch()).count();
+            _pagedLODPrefetch->update(_frameStamp->frameCount, time, _state->projectionMatrixStack.top(), view.camera->viewMatrix->transform());
+        }
+
         if (_viewDependentState && _viewDependentState->viewportData && view.camera->viewportState)
         {
             auto& viewportData = _viewDependentState->viewportData;
@@ -580,10 +867,22 @@ void RecordTraversal::apply(const View& view)
 
     // swap back previous bin setup.
     _minimumBinNumber = cached_minimumBinNumber;
-    cached_bins.swap(_bins);
-    cached_regionsOfInterest.swap(regionsOfInterest);
+    _viewBins[viewDepth].swap(_bins);
+    _viewRegionsOfInterest[viewDepth].swap(regionsOfInterest);
+    --_viewDepth;
     _state->_commandBuffer->traversalMask = cached_traversalMask;
     _viewDependentState = cached_viewDependentState;
+    _occlusionBuffer = cached_occlusionBuffer;
+    _occlusionViewID = cached_occlusionViewID;
+    _pagedLODPrefetch = cached_pagedLODPrefetch;
+    _insideFrustum = cached_insideFrustum;
+    _state->resetLastRecorded();
+
+    if (viewDepth == 0 && instrumentation)
+    {
+        instrumentation->counter("Cull tests", _numCullTests);
+        instrumentation->counter("Cull tests skipped", _numCullTestsSkipped);
+    }
 }
 
 void RecordTraversal::apply(const CommandGraph& commandGraph)
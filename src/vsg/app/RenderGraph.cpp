@@ -142,13 +142,24 @@ void RenderGraph::accept(RecordTraversal& recordTraversal) const
     renderPassInfo.clearValueCount = static_cast<uint32_t>(clearValues.size());
     renderPassInfo.pClearValues = clearValues.data();
 
-    VkCommandBuffer vk_commandBuffer = *(recordTraversal.getState()->_commandBuffer);
+    auto commandBuffer = recordTraversal.getState()->_commandBuffer;
+    VkCommandBuffer vk_commandBuffer = *commandBuffer;
     vkCmdBeginRenderPass(vk_commandBuffer, &renderPassInfo, contents);
 
+    commandBuffer->renderPass = renderPassInfo.renderPass;
+    commandBuffer->subpass = 0;
+    commandBuffer->framebuffer = renderPassInfo.framebuffer;
+    commandBuffer->subpassContents = contents;
+
     // traverse the subgraph to place commands into the command buffer.
     traverse(recordTraversal);
 
     vkCmdEndRenderPass(vk_commandBuffer);
+
+    commandBuffer->renderPass = VK_NULL_HANDLE;
+    commandBuffer->subpass = 0;
+    commandBuffer->framebuffer = VK_NULL_HANDLE;
+    commandBuffer->subpassContents = VK_SUBPASS_CONTENTS_INLINE;
 }
 
 void RenderGraph::resized()
@@ -88,7 +88,7 @@ void SecondaryCommandGraph::record(ref_ptr<RecordedCommandBuffers> recordedComma
 
     if ((maxSlot + 1) != recordTraversal->getState()->stateStacks.size())
     {
-        recordTraversal->getState()->stateStacks.resize(maxSlot + 1);
+        recordTraversal->getState()->setMaxSlot(maxSlot);
     }
 
     recordTraversal->recordedCommandBuffers = recordedCommandBuffers;
@@ -119,6 +119,7 @@ void SecondaryCommandGraph::record(ref_ptr<RecordedCommandBuffers> recordedComma
     commandBuffer->numDependentSubmissions().fetch_add(1);
 
     recordTraversal->getState()->_commandBuffer = commandBuffer;
+    recordTraversal->getState()->resetLastRecorded();
 
     // or select index when maps to a dormant CommandBuffer
     VkCommandBuffer vk_commandBuffer = *commandBuffer;
@@ -41,3 +41,9 @@ void vsg::deallocate(void* ptr, std::size_t size)
 {
     Allocator::instance()->deallocate(ptr, size);
 }
+
+std::atomic_size_t& vsg::transientAllocationCount()
+{
+    static std::atomic_size_t s_transientAllocationCount{0};
+    return s_transientAllocationCount;
+}
@@ -585,6 +585,10 @@ void ConstVisitor::apply(const VertexIndexDraw& value)
 {
     apply(static_cast<const Command&>(value));
 }
+void ConstVisitor::apply(const CulledInstanceDraw& value)
+{
+    apply(static_cast<const Command&>(value));
+}
 void ConstVisitor::apply(const DepthSorted& value)
 {
     apply(static_cast<const Node&>(value));
@@ -71,6 +71,23 @@ int Data::compare(const Object& rhs_object) const
     return std::memcmp(dataPointer(), rhs.dataPointer(), dataSize());
 }
 
+std::size_t Data::hash() const
+{
+    if (_hash != 0 && _hashModifiedCount == _modifiedCount.count) return _hash;
+
+    // hash the same contents that compare() uses, the Auxiliary is left out as equal objects will still have equal hashes
+    std::size_t result = hash_memory(&properties, sizeof(properties), std::type_index(typeid(*this)).hash_code());
+    if (dataSize() > 0) result = hash_memory(dataPointer(), dataSize(), result);
+
+    // 0 is reserved for no hash provided
+    if (result == 0) result = 1;
+
+    // assign the hash before the count so that another thread can't pair the new count with a previous hash
+    _hash = result;
+    _hashModifiedCount = _modifiedCount.count;
+    return result;
+}
+
 void Data::read(Input& input)
 {
     Object::read(input);
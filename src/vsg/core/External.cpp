@@ -108,19 +108,23 @@ void External::read(Input& input)
         auto& objectIDRange = collectIDs.objectIDRangeMap[itr->first];
         collectIDs._objectID = objectIDRange.startID;
         if (itr->second)
+        {
             itr->second->accept(collectIDs);
+            input.reserveObjectIDs(objectIDRange.startID, collectIDs._objectID);
+        }
         else
         {
+            input.reserveObjectIDs(objectIDRange.startID, objectIDRange.endID);
             for (uint32_t objectID = objectIDRange.startID; objectID <= objectIDRange.endID; ++objectID)
             {
-                input.objectIDMap[objectID] = nullptr;
+                input.assignObjectID(objectID, {});
             }
         }
     }
 
     for (auto [object, objectID] : collectIDs._objectIDMap)
     {
-        input.objectIDMap[objectID] = const_cast<Object*>(object);
+        input.assignObjectID(objectID, ref_ptr<Object>(const_cast<Object*>(object)));
     }
 }
 
@@ -33,7 +33,7 @@ using namespace vsg;
 //
 // MemoryBlock
 //
-IntrusiveAllocator::MemoryBlock::MemoryBlock(const std::string& in_name, size_t in_blockSize, size_t in_alignment) :
+IntrusiveAllocator::MemoryBlock::MemoryBlock(const std::string& in_name, size_t in_blockSize, size_t in_alignment, size_t in_minimumBlockAlignment) :
     name(in_name),
     alignment(in_alignment),
     blockSize(in_blockSize)
@@ -42,7 +42,7 @@ IntrusiveAllocator::MemoryBlock::MemoryBlock(const std::string& in_name, size_t
     elementAlignment = static_cast<Element::Index>(alignment / sizeof(Element));
 
     blockAlignment = std::max(alignment, alignof(std::max_align_t));
-    blockAlignment = std::max(blockAlignment, size_t{16});
+    blockAlignment = std::max(blockAlignment, std::max(in_minimumBlockAlignment, size_t{16}));
 
     // round blockSize up to nearest aligned size
     blockSize = ((blockSize + alignment - 1) / alignment) * alignment;
@@ -749,10 +749,10 @@ void* IntrusiveAllocator::MemoryBlocks::allocate(std::size_t size)
         }
     }
 
-    auto new_block = std::make_shared<MemoryBlock>(name, new_blockSize, alignment);
+    auto new_block = std::make_shared<MemoryBlock>(name, new_blockSize, alignment, IntrusiveAllocator::memoryBlockPageSize);
     if (parent)
     {
-        parent->memoryBlocks[new_block->memory] = new_block;
+        parent->registerMemoryBlock(new_block.get());
     }
 
     if (memoryBlocks.empty())
@@ -796,6 +796,8 @@ size_t IntrusiveAllocator::MemoryBlocks::deleteEmptyMemoryBlocks()
         if (memoryBlock->totalReservedSize() == 0)
         {
             count += memoryBlock->totalAvailableSize();
+            if (parent) parent->unregisterMemoryBlock(memoryBlock.get());
+            if (memoryBlock == memoryBlockWithSpace) memoryBlockWithSpace.reset();
         }
         else
         {
@@ -852,6 +854,9 @@ IntrusiveAllocator::IntrusiveAllocator(size_t in_defaultAlignment) :
     allocatorMemoryBlocks[vsg::ALLOCATOR_AFFINITY_DATA].reset(new MemoryBlocks(this, "ALLOCATOR_AFFINITY_DATA", size_t(16) * blockSize, defaultAlignment));
     allocatorMemoryBlocks[vsg::ALLOCATOR_AFFINITY_NODES].reset(new MemoryBlocks(this, "ALLOCATOR_AFFINITY_NODES", blockSize, defaultAlignment));
     allocatorMemoryBlocks[vsg::ALLOCATOR_AFFINITY_PHYSICS].reset(new MemoryBlocks(this, "ALLOCATOR_AFFINITY_PHYSICS", blockSize, 16));
+
+    threadCacheRegistry = std::make_shared<ThreadCacheRegistry>();
+    threadCacheRegistry->allocator = this;
 }
 
 IntrusiveAllocator::IntrusiveAllocator(std::unique_ptr<Allocator> in_nestedAllocator, size_t in_defaultAlignment) :
@@ -865,10 +870,23 @@ IntrusiveAllocator::IntrusiveAllocator(std::unique_ptr<Allocator> in_nestedAlloc
     allocatorMemoryBlocks[vsg::ALLOCATOR_AFFINITY_DATA].reset(new MemoryBlocks(this, "ALLOCATOR_AFFINITY_DATA", size_t(16) * blockSize, defaultAlignment));
     allocatorMemoryBlocks[vsg::ALLOCATOR_AFFINITY_NODES].reset(new MemoryBlocks(this, "ALLOCATOR_AFFINITY_NODES", blockSize, defaultAlignment));
     allocatorMemoryBlocks[vsg::ALLOCATOR_AFFINITY_PHYSICS].reset(new MemoryBlocks(this, "ALLOCATOR_AFFINITY_PHYSICS", blockSize, 16));
+
+    threadCacheRegistry = std::make_shared<ThreadCacheRegistry>();
+    threadCacheRegistry->allocator = this;
 }
 
 IntrusiveAllocator::~IntrusiveAllocator()
 {
+    // return the pending deallocations of any threads still using this allocator so large and nested allocations are released
+    std::scoped_lock<std::mutex> registry_lock(threadCacheRegistry->mutex);
+    std::scoped_lock<std::mutex> lock(mutex);
+
+    for (auto threadCache : threadCacheRegistry->threadCaches)
+    {
+        _releaseThreadCache(*threadCache);
+    }
+    threadCacheRegistry->threadCaches.clear();
+    threadCacheRegistry->allocator = nullptr;
 }
 
 void IntrusiveAllocator::setBlockSize(AllocatorAffinity allocatorAffinity, size_t blockSize)
@@ -892,6 +910,12 @@ void IntrusiveAllocator::report(std::ostream& out) const
 {
     out << "IntrusiveAllocator::report() " << allocatorMemoryBlocks.size() << std::endl;
 
+    {
+        std::scoped_lock<std::mutex> registry_lock(threadCacheRegistry->mutex);
+        out << "    threadCaches.size() = " << threadCacheRegistry->threadCaches.size() << ", threadCacheMaximumAllocationSize = " << threadCacheMaximumAllocationSize << ", threadCacheBatchSize = " << threadCacheBatchSize << std::endl;
+    }
+    out << "    memoryBlockPages.size() = " << memoryBlockPages.size() << ", largeAllocations.size() = " << largeAllocations.size() << std::endl;
+
     for (const auto& memoryBlock : allocatorMemoryBlocks)
     {
         if (memoryBlock) memoryBlock->report(out);
@@ -902,8 +926,47 @@ void IntrusiveAllocator::report(std::ostream& out) const
 
 void* IntrusiveAllocator::allocate(std::size_t size, AllocatorAffinity allocatorAffinity)
 {
+    if (size <= threadCacheMaximumAllocationSize && allocatorAffinity < vsg::ALLOCATOR_AFFINITY_LAST)
+    {
+        if (auto threadCache = getThreadCache())
+        {
+            size_t sizeClass = (std::max(size, size_t(1)) + ThreadCache::sizeClassGranularity - 1) / ThreadCache::sizeClassGranularity - 1;
+            auto& availableSlots = threadCache->availableSlots[allocatorAffinity * threadCache->numSizeClasses + sizeClass];
+            if (availableSlots.empty())
+            {
+                // refill the cache with a batch of slots of the size class' maximum size
+                size_t slotSize = (sizeClass + 1) * ThreadCache::sizeClassGranularity;
+
+                std::scoped_lock<std::mutex> lock(mutex);
+
+                _flushPendingDeallocations(*threadCache);
+
+                auto& blocks = allocatorMemoryBlocks[allocatorAffinity];
+                if (blocks && slotSize <= blocks->maximumAllocationSize)
+                {
+                    for (size_t i = 0; i < threadCache->batchSize; ++i)
+                    {
+                        auto ptr = blocks->allocate(slotSize);
+                        if (!ptr) break;
+                        availableSlots.push_back(ptr);
+                    }
+                }
+
+                if (availableSlots.empty()) return _allocate(size, allocatorAffinity);
+            }
+
+            auto ptr = availableSlots.back();
+            availableSlots.pop_back();
+            return ptr;
+        }
+    }
+
     std::scoped_lock<std::mutex> lock(mutex);
+    return _allocate(size, allocatorAffinity);
+}
 
+void* IntrusiveAllocator::_allocate(std::size_t size, AllocatorAffinity allocatorAffinity)
+{
     // create a MemoryBlocks entry if one doesn't already exist
     if (allocatorAffinity > allocatorMemoryBlocks.size())
     {
@@ -938,38 +1001,39 @@ void* IntrusiveAllocator::allocate(std::size_t size, AllocatorAffinity allocator
 
 bool IntrusiveAllocator::deallocate(void* ptr, std::size_t size)
 {
-    std::scoped_lock<std::mutex> lock(mutex);
-
-    if (memoryBlocks.empty()) return false;
-
-    auto itr = memoryBlocks.upper_bound(ptr);
-    if (itr != memoryBlocks.end())
+    // only defer small deallocations of memory owned by the MemoryBlocks, large and nested allocations,
+    // and pointers that weren't allocated by this allocator, are handled immediately so the caller gets the correct result.
+    if (size <= threadCacheMaximumAllocationSize && memoryBlockPages.lookup(memoryBlockPage(ptr)))
     {
-        if (itr != memoryBlocks.begin())
+        if (auto threadCache = getThreadCache())
         {
-            --itr;
-            auto& block = itr->second;
-            if (block->deallocate(ptr, size))
+            // defer the deallocation so that the Allocator::mutex is only acquired once per batch
+            bool flush = false;
             {
-                return true;
+                std::scoped_lock<std::mutex> pending_lock(threadCache->pendingMutex);
+                threadCache->pendingDeallocations.push_back(ptr);
+                flush = threadCache->pendingDeallocations.size() >= threadCache->batchSize;
             }
-        }
-        else
-        {
-            auto& block = itr->second;
-            if (block->deallocate(ptr, size))
+
+            if (flush)
             {
-                return true;
+                std::scoped_lock<std::mutex> lock(mutex);
+                _flushPendingDeallocations(*threadCache);
             }
+            return true;
         }
     }
-    else
+
+    std::scoped_lock<std::mutex> lock(mutex);
+    return _deallocate(ptr, size);
+}
+
+bool IntrusiveAllocator::_deallocate(void* ptr, std::size_t size)
+{
+    auto memoryBlock = memoryBlockPages.find(memoryBlockPage(ptr));
+    if (memoryBlock && memoryBlock->deallocate(ptr, size))
     {
-        auto& block = memoryBlocks.rbegin()->second;
-        if (block->deallocate(ptr, size))
-        {
-            return true;
-        }
+        return true;
     }
 
     auto la_itr = largeAllocations.find(ptr);
@@ -990,18 +1054,247 @@ bool IntrusiveAllocator::deallocate(void* ptr, std::size_t size)
     return false;
 }
 
+IntrusiveAllocator::ThreadCache::ThreadCache(std::shared_ptr<ThreadCacheRegistry> in_registry, size_t in_maximumAllocationSize, size_t in_batchSize) :
+    registry(in_registry),
+    maximumAllocationSize(in_maximumAllocationSize),
+    batchSize(std::max(in_batchSize, size_t(1))),
+    numSizeClasses((in_maximumAllocationSize + sizeClassGranularity - 1) / sizeClassGranularity)
+{
+    availableSlots.resize(vsg::ALLOCATOR_AFFINITY_LAST * numSizeClasses);
+    pendingDeallocations.reserve(batchSize);
+}
+
+IntrusiveAllocator::ThreadCache::~ThreadCache()
+{
+    std::scoped_lock<std::mutex> registry_lock(registry->mutex);
+    if (auto allocator = registry->allocator.load())
+    {
+        {
+            std::scoped_lock<std::mutex> lock(allocator->mutex);
+            allocator->_releaseThreadCache(*this);
+        }
+        registry->threadCaches.erase(this);
+    }
+}
+
+IntrusiveAllocator::ThreadCache* IntrusiveAllocator::getThreadCache()
+{
+    static thread_local std::unique_ptr<ThreadCache> s_threadCache;
+
+    if (s_threadCache)
+    {
+        if (s_threadCache->registry == threadCacheRegistry) return s_threadCache.get();
+
+        // thread is already assigned to another IntrusiveAllocator that is still in use, such as when this allocator is nested, so fallback to the locking code paths
+        if (s_threadCache->registry->allocator) return nullptr;
+    }
+
+    if (threadCacheMaximumAllocationSize == 0) return nullptr;
+
+    s_threadCache = std::make_unique<ThreadCache>(threadCacheRegistry, threadCacheMaximumAllocationSize, threadCacheBatchSize);
+
+    std::scoped_lock<std::mutex> registry_lock(threadCacheRegistry->mutex);
+    threadCacheRegistry->threadCaches.insert(s_threadCache.get());
+
+    return s_threadCache.get();
+}
+
+void IntrusiveAllocator::_flushPendingDeallocations(ThreadCache& threadCache)
+{
+    std::scoped_lock<std::mutex> pending_lock(threadCache.pendingMutex);
+    for (auto ptr : threadCache.pendingDeallocations)
+    {
+        // deallocate() only defers pointers within pages owned by MemoryBlocks so a failure here means the pointer wasn't a valid allocation
+        if (!_deallocate(ptr, 0))
+        {
+            std::cerr << "IntrusiveAllocator::_flushPendingDeallocations() failed to deallocate " << ptr << std::endl;
+        }
+    }
+    threadCache.pendingDeallocations.clear();
+}
+
+void IntrusiveAllocator::_flushAllPendingDeallocations()
+{
+    // threadCacheRegistry->mutex and Allocator::mutex must be held by the caller
+    for (auto threadCache : threadCacheRegistry->threadCaches)
+    {
+        _flushPendingDeallocations(*threadCache);
+    }
+}
+
+void IntrusiveAllocator::_releaseThreadCache(ThreadCache& threadCache)
+{
+    _flushPendingDeallocations(threadCache);
+
+    for (auto& availableSlots : threadCache.availableSlots)
+    {
+        for (auto ptr : availableSlots)
+        {
+            _deallocate(ptr, 0);
+        }
+        availableSlots.clear();
+    }
+}
+
+IntrusiveAllocator::MemoryBlockPages::MemoryBlockPages()
+{
+    for (auto& mid : _root) mid.store(nullptr, std::memory_order_relaxed);
+}
+
+IntrusiveAllocator::MemoryBlockPages::~MemoryBlockPages()
+{
+    for (auto& root_entry : _root)
+    {
+        auto mid = root_entry.load(std::memory_order_relaxed);
+        if (!mid) continue;
+
+        for (auto& mid_entry : mid->leaves) delete mid_entry.load(std::memory_order_relaxed);
+        delete mid;
+    }
+}
+
+IntrusiveAllocator::MemoryBlock* IntrusiveAllocator::MemoryBlockPages::lookup(size_t page) const
+{
+    if (uint64_t(page) >= maximumRadixPage) return nullptr;
+
+    auto mid = _root[page >> (midBits + leafBits)].load(std::memory_order_acquire);
+    if (!mid) return nullptr;
+
+    auto leaf = mid->leaves[(page >> leafBits) & ((size_t(1) << midBits) - 1)].load(std::memory_order_acquire);
+    if (!leaf) return nullptr;
+
+    return leaf->memoryBlocks[page & ((size_t(1) << leafBits) - 1)].load(std::memory_order_acquire);
+}
+
+IntrusiveAllocator::MemoryBlock* IntrusiveAllocator::MemoryBlockPages::find(size_t page) const
+{
+    if (uint64_t(page) < maximumRadixPage) return lookup(page);
+
+    auto itr = _overflow.find(page);
+    return (itr != _overflow.end()) ? itr->second : nullptr;
+}
+
+void IntrusiveAllocator::MemoryBlockPages::assign(size_t page, MemoryBlock* memoryBlock)
+{
+    if (uint64_t(page) >= maximumRadixPage)
+    {
+        auto& entry = _overflow[page];
+        if (!entry) ++_size;
+        entry = memoryBlock;
+        return;
+    }
+
+    // leaves are created on demand and only deleted with the MemoryBlockPages, so lookup() never reads a deleted leaf
+    auto& root_entry = _root[page >> (midBits + leafBits)];
+    auto mid = root_entry.load(std::memory_order_relaxed);
+    if (!mid)
+    {
+        mid = new Mid;
+        for (auto& mid_entry : mid->leaves) mid_entry.store(nullptr, std::memory_order_relaxed);
+        root_entry.store(mid, std::memory_order_release);
+    }
+
+    auto& mid_entry = mid->leaves[(page >> leafBits) & ((size_t(1) << midBits) - 1)];
+    auto leaf = mid_entry.load(std::memory_order_relaxed);
+    if (!leaf)
+    {
+        leaf = new Leaf;
+        for (auto& leaf_entry : leaf->memoryBlocks) leaf_entry.store(nullptr, std::memory_order_relaxed);
+        mid_entry.store(leaf, std::memory_order_release);
+    }
+
+    auto& leaf_entry = leaf->memoryBlocks[page & ((size_t(1) << leafBits) - 1)];
+    if (!leaf_entry.load(std::memory_order_relaxed)) ++_size;
+    leaf_entry.store(memoryBlock, std::memory_order_release);
+}
+
+void IntrusiveAllocator::MemoryBlockPages::erase(size_t page, const MemoryBlock* memoryBlock)
+{
+    if (uint64_t(page) >= maximumRadixPage)
+    {
+        auto itr = _overflow.find(page);
+        if (itr != _overflow.end() && itr->second == memoryBlock)
+        {
+            _overflow.erase(itr);
+            --_size;
+        }
+        return;
+    }
+
+    auto mid = _root[page >> (midBits + leafBits)].load(std::memory_order_relaxed);
+    if (!mid) return;
+
+    auto leaf = mid->leaves[(page >> leafBits) & ((size_t(1) << midBits) - 1)].load(std::memory_order_relaxed);
+    if (!leaf) return;
+
+    auto& leaf_entry = leaf->memoryBlocks[page & ((size_t(1) << leafBits) - 1)];
+    if (leaf_entry.load(std::memory_order_relaxed) == memoryBlock)
+    {
+        leaf_entry.store(nullptr, std::memory_order_release);
+        --_size;
+    }
+}
+
+void IntrusiveAllocator::registerMemoryBlock(MemoryBlock* memoryBlock)
+{
+    size_t endPage = memoryBlockPage(memoryBlock->memoryEnd - 1);
+    for (size_t page = memoryBlockPage(memoryBlock->memory); page <= endPage; ++page)
+    {
+        memoryBlockPages.assign(page, memoryBlock);
+    }
+}
+
+void IntrusiveAllocator::unregisterMemoryBlock(MemoryBlock* memoryBlock)
+{
+    size_t endPage = memoryBlockPage(memoryBlock->memoryEnd - 1);
+    for (size_t page = memoryBlockPage(memoryBlock->memory); page <= endPage; ++page)
+    {
+        memoryBlockPages.erase(page, memoryBlock);
+    }
+}
+
 bool IntrusiveAllocator::validate() const
 {
     bool valid = true;
-    for (auto& memoryBlock : allocatorMemoryBlocks)
+    size_t numPages = 0;
+    for (auto& memoryBlocks : allocatorMemoryBlocks)
     {
-        valid = memoryBlock->validate() && valid;
+        if (!memoryBlocks) continue;
+
+        valid = memoryBlocks->validate() && valid;
+
+        // check that every page of each MemoryBlock maps back to it
+        for (auto& memoryBlock : memoryBlocks->memoryBlocks)
+        {
+            size_t endPage = memoryBlockPage(memoryBlock->memoryEnd - 1);
+            for (size_t page = memoryBlockPage(memoryBlock->memory); page <= endPage; ++page, ++numPages)
+            {
+                if (memoryBlockPages.find(page) != memoryBlock.get())
+                {
+                    std::cerr << "IntrusiveAllocator::validate() validation failed, page " << page << " not mapped to MemoryBlock " << memoryBlock.get() << std::endl;
+                    valid = false;
+                }
+            }
+        }
+    }
+
+    if (numPages != memoryBlockPages.size())
+    {
+        std::cerr << "IntrusiveAllocator::validate() validation failed, memoryBlockPages.size() = " << memoryBlockPages.size() << " but MemoryBlocks cover " << numPages << " pages." << std::endl;
+        valid = false;
     }
+
     return valid;
 }
 
 size_t IntrusiveAllocator::deleteEmptyMemoryBlocks()
 {
+    std::scoped_lock<std::mutex> registry_lock(threadCacheRegistry->mutex);
+    std::scoped_lock<std::mutex> lock(mutex);
+
+    // return the deallocations deferred by all threads so that the MemoryBlocks they belong to can be released
+    _flushAllPendingDeallocations();
+
     size_t count = 0;
     for (auto& blocks : allocatorMemoryBlocks)
     {
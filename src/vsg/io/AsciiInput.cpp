@@ -10,11 +10,14 @@ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLI
 
 </editor-fold> */
 
+#include <vsg/core/Exception.h>
 #include <vsg/io/AsciiInput.h>
 #include <vsg/io/Logger.h>
 #include <vsg/io/ReaderWriter.h>
+#include <vsg/io/mem_stream.h>
 
 #include <cstring>
+#include <iterator>
 
 using namespace vsg;
 
@@ -22,13 +25,98 @@ AsciiInput::AsciiInput(std::istream& input, ref_ptr<ObjectFactory> in_objectFact
     Input(in_objectFactory, in_options),
     _input(input)
 {
+    // read the remainder of the stream into memory, using the stream size when it's seekable to avoid reallocations
+    auto position = _input.tellg();
+    if (position >= 0 && _input.seekg(0, std::ios::end))
+    {
+        _startPosition = position;
+
+        auto end = _input.tellg();
+        _input.seekg(position);
+        if (end > position)
+        {
+            _buffer.resize(static_cast<size_t>(end - position));
+            _input.read(_buffer.data(), static_cast<std::streamsize>(_buffer.size()));
+            _buffer.resize(static_cast<size_t>(_input.gcount()));
+        }
+    }
+    else
+    {
+        _input.clear();
+        _buffer.assign(std::istreambuf_iterator<char>(_input), std::istreambuf_iterator<char>());
+    }
+
+    _ptr = _buffer.data();
+    _end = _ptr + _buffer.size();
+}
+
+AsciiInput::~AsciiInput()
+{
+    // position seekable streams just past the parsed text so that any data following it can be read by the caller
+    if (_startPosition >= 0)
+    {
+        _input.clear();
+        _input.seekg(_startPosition + static_cast<std::streamoff>(_ptr - _buffer.data()));
+    }
+}
+
+std::string_view AsciiInput::_token()
+{
+    if (!_skipWhitespace()) return {};
+
+    const char* start = _ptr;
+    while (_ptr < _end && !(*_ptr == ' ' || (*_ptr >= '\t' && *_ptr <= '\r'))) ++_ptr;
+    return std::string_view(start, static_cast<size_t>(_ptr - start));
+}
+
+template<typename T>
+static void parseToken(std::string_view token, T& value)
+{
+    // fallback to classic locale std::istream extraction, matching the values the stream based parser produced
+    mem_stream str(token);
+    str.imbue(std::locale::classic());
+    str >> value;
+    if (str.fail()) value = 0;
+}
+
+void AsciiInput::_parse(float& value)
+{
+#if defined(__cpp_lib_to_chars)
+    value = 0.0f;
+    if (!_skipWhitespace()) return;
+
+    auto result = std::from_chars(_ptr, _end, value);
+    if (result.ec == std::errc())
+    {
+        _ptr = result.ptr;
+        return;
+    }
+#endif
+    parseToken(_token(), value);
+}
+
+void AsciiInput::_parse(double& value)
+{
+#if defined(__cpp_lib_to_chars)
+    value = 0.0;
+    if (!_skipWhitespace()) return;
+
+    auto result = std::from_chars(_ptr, _end, value);
+    if (result.ec == std::errc())
+    {
+        _ptr = result.ptr;
+        return;
+    }
+#endif
+    parseToken(_token(), value);
 }
 
 bool AsciiInput::matchPropertyName(const char* propertyName)
 {
-    _input >> _readPropertyName;
-    if (_readPropertyName != propertyName)
+    auto token = _token();
+    if (token != propertyName)
     {
+        _readPropertyName = token;
         error("Unable to match ", propertyName, " got ", _readPropertyName, " instead.");
         return false;
     }
@@ -37,14 +125,11 @@ bool AsciiInput::matchPropertyName(const char* propertyName)
 
 AsciiInput::OptionalObjectID AsciiInput::objectID()
 {
-    std::string token;
-    _input >> token;
+    auto token = _token();
     if (token.compare(0, 3, "id=") == 0)
     {
-        token.erase(0, 3);
-        std::stringstream str(token);
-        ObjectID id;
-        str >> id;
+        ObjectID id = 0;
+        std::from_chars(token.data() + 3, token.data() + token.size(), id);
         return OptionalObjectID{true, id};
     }
     else
@@ -57,41 +142,39 @@ void AsciiInput::_read(std::string& value)
 {
     value.clear();
 
-    char c;
-    _input >> c;
-    if (_input.good())
+    if (!_skipWhitespace()) return;
+
+    if (*_ptr == '"')
     {
-        if (c == '"')
+        ++_ptr;
+        while (_ptr < _end)
         {
-            _input.get(c);
-            while (_input.good())
+            char c = *(_ptr++);
+            if (c == '\\')
             {
-                if (c == '\\')
-                {
-                    _input.get(c);
-                    if (c == '"')
-                        value.push_back(c);
-                    else
-                    {
-                        value.push_back('\\');
-                        value.push_back(c);
-                    }
-                }
-                else if (c != '"')
-                {
+                if (_ptr == _end) break;
+                c = *(_ptr++);
+                if (c == '"')
                     value.push_back(c);
-                }
                 else
                 {
-                    break;
+                    value.push_back('\\');
+                    value.push_back(c);
                 }
-                _input.get(c);
+            }
+            else if (c != '"')
+            {
+                value.push_back(c);
+            }
+            else
+            {
+                break;
             }
         }
-        else
-        {
-            _input >> value;
-        }
+    }
+    else
+    {
+        value = _token();
     }
 }
 
@@ -153,35 +236,36 @@ void AsciiInput::read(size_t num, Path* value)
 
 vsg::ref_ptr<vsg::Object> AsciiInput::read()
 {
+    if (cancelled()) throw Exception{"Read of " + filename.string() + " cancelled."};
+
     auto result = objectID();
     if (result.first)
     {
         ObjectID id = result.second;
         //debug("   matched result=", id);
 
-        if (auto itr = objectIDMap.find(id); itr != objectIDMap.end())
+        if (auto entry = findObjectID(id))
         {
-            //debug("Returning existing object ", itr->second);
-            return itr->second;
+            //debug("Returning existing object ", entry->object);
+            return entry->object;
         }
         else
         {
-            std::string className;
-            _input >> className;
+            std::string className(_token());
 
             //debug("Loading new object ", className);
 
             if (className != "nullptr")
             {
                 auto object = objectFactory->create(className.c_str());
-                objectIDMap[id] = object;
+                assignObjectID(id, object);
                 if (object)
                 {
                     matchPropertyName("{");
 
                     object->read(*this);
 
-                    //debug("Loaded object, assigning to objectIDMap.", object);
+                    //debug("Loaded object ", object);
 
                     matchPropertyName("}");
                 }
@@ -193,7 +277,8 @@ vsg::ref_ptr<vsg::Object> AsciiInput::read()
             }
             else
             {
-                return objectIDMap[id] = {};
+                assignObjectID(id, {});
+                return {};
             }
         }
     }
@@ -10,11 +10,14 @@ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLI
 
 </editor-fold> */
 
+#include <vsg/core/Exception.h>
 #include <vsg/io/BinaryInput.h>
 #include <vsg/io/Logger.h>
 #include <vsg/io/ReaderWriter.h>
+#include <vsg/io/VSG.h>
 
 #include <cstring>
+#include <typeinfo>
 
 using namespace vsg;
 
@@ -24,6 +27,30 @@ BinaryInput::BinaryInput(std::istream& input, ref_ptr<ObjectFactory> in_objectFa
 {
 }
 
+void BinaryInput::alignDataPayload()
+{
+    if ((formatFeatures & VSG::ALIGNED_PAYLOADS) == 0) return;
+
+    uint8_t padding = 0;
+    _read(1, &padding);
+    _input.ignore(padding);
+}
+
+void* BinaryInput::mapDataPayload(size_t size, size_t alignment)
+{
+    if (!mappedFile || size < mappedDataThreshold) return nullptr;
+
+    auto position = _input.tellg();
+    if (position < 0 || (static_cast<size_t>(position) + size) > mappedFile->size()) return nullptr;
+
+    // payloads in files written before the padding was introduced may not be aligned
+    auto offset = static_cast<size_t>(position);
+    if (reinterpret_cast<uintptr_t>(mappedFile->data() + offset) % alignment != 0) return nullptr;
+
+    _input.seekg(static_cast<std::streamoff>(size), std::ios::cur);
+    return mappedFile->reference(offset);
+}
+
 void BinaryInput::_read(std::string& value)
 {
     uint32_t size = readValue<uint32_t>(nullptr);
@@ -88,34 +115,64 @@ void BinaryInput::read(size_t num, Path* value)
     }
 }
 
-vsg::ref_ptr<vsg::Object> BinaryInput::read()
+const BinaryInput::ClassEntry& BinaryInput::_readClassEntry()
 {
-    ObjectID id = objectID();
+    uint32_t index = readValue<uint32_t>(nullptr);
+    if (index < _classEntries.size()) return _classEntries[index];
+
+    if (index > _classEntries.size()) throw Exception{"Invalid class index " + std::to_string(index) + " in " + filename.string()};
 
-    if (auto itr = objectIDMap.find(id); itr != objectIDMap.end())
+    // first use of the class so read its name, later objects of the class reuse it without reading or allocating a string
+    ClassEntry entry;
+    _read(entry.name);
+    entry.isNull = (entry.name == "nullptr");
+    if (!entry.isNull && typeid(*objectFactory) == typeid(ObjectFactory)) entry.createFunction = objectFactory->getCreateFunction(entry.name);
+
+    _classEntries.push_back(std::move(entry));
+    return _classEntries.back();
+}
+
+vsg::ref_ptr<vsg::Object> BinaryInput::_readObject(ObjectID id, vsg::ref_ptr<vsg::Object> object, const std::string& className)
+{
+    assignObjectID(id, object);
+    if (object)
     {
-        return itr->second;
+        object->read(*this);
     }
     else
     {
-        std::string className = readValue<std::string>(nullptr);
-        if (className != "nullptr")
-        {
-            auto object = objectFactory->create(className.c_str());
-            objectIDMap[id] = object;
-            if (object)
-            {
-                object->read(*this);
-            }
-            else
-            {
-                warn("Unable to create instance of class : ", className);
-            }
-            return object;
-        }
-        else
+        warn("Unable to create instance of class : ", className);
+    }
+    return object;
+}
+
+vsg::ref_ptr<vsg::Object> BinaryInput::read()
+{
+    if (cancelled()) throw Exception{"Read of " + filename.string() + " cancelled."};
+
+    ObjectID id = objectID();
+
+    if (auto entry = findObjectID(id)) return entry->object;
+
+    if ((formatFeatures & VSG::CLASS_INDEX) != 0)
+    {
+        const auto& classEntry = _readClassEntry();
+        if (classEntry.isNull)
         {
-            return objectIDMap[id] = {};
+            assignObjectID(id, {});
+            return {};
         }
+
+        auto object = classEntry.createFunction ? (*classEntry.createFunction)() : objectFactory->create(classEntry.name);
+        return _readObject(id, object, classEntry.name);
     }
+
+    std::string className = readValue<std::string>(nullptr);
+    if (className == "nullptr")
+    {
+        assignObjectID(id, {});
+        return {};
+    }
+
+    return _readObject(id, objectFactory->create(className), className);
 }
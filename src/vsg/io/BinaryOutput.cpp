@@ -13,6 +13,7 @@ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLI
 #include <vsg/core/Version.h>
 
 #include <vsg/io/BinaryOutput.h>
+#include <vsg/io/VSG.h>
 
 using namespace vsg;
 
@@ -22,6 +23,21 @@ BinaryOutput::BinaryOutput(std::ostream& output, ref_ptr<const Options> in_optio
 {
 }
 
+void BinaryOutput::alignDataPayload()
+{
+    if ((formatFeatures & VSG::ALIGNED_PAYLOADS) == 0) return;
+
+    // write the number of padding bytes followed by the padding, positioning the payload on a dataAlignment boundary.
+    // Streams that don't report their position are written without padding.
+    uint8_t padding = 0;
+    auto position = _output.tellp();
+    if (position >= 0) padding = static_cast<uint8_t>((dataAlignment - (static_cast<size_t>(position) + 1) % dataAlignment) % dataAlignment);
+
+    const char zeros[dataAlignment] = {};
+    _output.write(reinterpret_cast<const char*>(&padding), 1);
+    _output.write(zeros, padding);
+}
+
 void BinaryOutput::_write(const std::string& str)
 {
     uint32_t size = static_cast<uint32_t>(str.size());
@@ -95,13 +111,21 @@ void BinaryOutput::write(const vsg::Object* object)
     objectIDMap[object] = id;
 
     _output.write(reinterpret_cast<const char*>(&id), sizeof(id));
-    if (object)
-    {
-        _write(std::string(object->className()));
-        object->write(*this);
-    }
+
+    const char* className = object ? object->className() : "nullptr";
+    if ((formatFeatures & VSG::CLASS_INDEX) != 0)
+        _writeClassIndex(className);
     else
-    {
-        _write(std::string("nullptr"));
-    }
+        _write(std::string(className));
+
+    if (object) object->write(*this);
+}
+
+void BinaryOutput::_writeClassIndex(const char* className)
+{
+    auto [itr, inserted] = _classIndices.emplace(className, static_cast<uint32_t>(_classIndices.size()));
+    _output.write(reinterpret_cast<const char*>(&itr->second), sizeof(uint32_t));
+
+    // the first use of a class is followed by its name, adding it to the reader's table of class names
+    if (inserted) _write(std::string(className));
 }
@@ -16,6 +16,9 @@ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLI
 #include <vsg/io/read.h>
 #include <vsg/threading/atomics.h>
 #include <vsg/ui/ApplicationEvent.h>
+#include <vsg/utils/ComputeMemoryFootprint.h>
+
+#include <map>
 
 using namespace vsg;
 
@@ -32,72 +35,288 @@ DatabaseQueue::~DatabaseQueue()
 {
 }
 
+void DatabaseQueue::_push(ref_ptr<PagedLOD> plod)
+{
+    auto itr = _positions.find(plod.get());
+    if (itr != _positions.end())
+    {
+        // already queued so just make sure it's in the right place
+        auto position = itr->second;
+        _heap[position].priority = plod->priority;
+        _moveUp(position);
+        _moveDown(_positions[plod.get()]);
+        return;
+    }
+
+    auto position = _heap.size();
+    _positions[plod.get()] = position;
+    _heap.push_back(Entry{plod->priority, plod});
+    _moveUp(position);
+}
+
+void DatabaseQueue::_moveUp(size_t position)
+{
+    Entry entry = std::move(_heap[position]);
+    while (position > 0)
+    {
+        size_t parent = (position - 1) / 2;
+        if (_heap[parent].priority >= entry.priority) break;
+
+        _heap[position] = std::move(_heap[parent]);
+        _positions[_heap[position].plod.get()] = position;
+        position = parent;
+    }
+    _positions[entry.plod.get()] = position;
+    _heap[position] = std::move(entry);
+}
+
+void DatabaseQueue::_moveDown(size_t position)
+{
+    size_t size = _heap.size();
+    Entry entry = std::move(_heap[position]);
+    for (;;)
+    {
+        size_t child = position * 2 + 1;
+        if (child >= size) break;
+        if ((child + 1) < size && _heap[child + 1].priority > _heap[child].priority) ++child;
+        if (entry.priority >= _heap[child].priority) break;
+
+        _heap[position] = std::move(_heap[child]);
+        _positions[_heap[position].plod.get()] = position;
+        position = child;
+    }
+    _positions[entry.plod.get()] = position;
+    _heap[position] = std::move(entry);
+}
+
+void DatabaseQueue::_rebuild()
+{
+    for (size_t position = 0; position < _heap.size(); ++position)
+    {
+        _positions[_heap[position].plod.get()] = position;
+    }
+
+    for (size_t position = _heap.size() / 2; position > 0; --position)
+    {
+        _moveDown(position - 1);
+    }
+}
+
 void DatabaseQueue::add(ref_ptr<PagedLOD> plod)
 {
     // debug("DatabaseQueue::add(", plod,") status = ",plod->requestStatus.load());
 
     std::scoped_lock lock(_mutex);
-    _queue.emplace_back(plod);
+    _push(plod);
     _cv.notify_one();
 }
 
 void DatabaseQueue::add(ref_ptr<PagedLOD> plod, const CompileResult& cr)
 {
     std::scoped_lock lock(_mutex);
-    _queue.emplace_back(plod);
+    _push(plod);
     _cv.notify_one();
     _compileResult.add(cr);
 }
 
-ref_ptr<PagedLOD> DatabaseQueue::take_when_available()
+void DatabaseQueue::updatePriority(const PagedLOD* plod)
 {
-    // debug("DatabaseQueue::take_when_available() A size = ", _queue.size());
+    std::scoped_lock lock(_mutex);
 
+    auto itr = _positions.find(plod);
+    if (itr == _positions.end()) return;
+
+    // RecordTraversal only ever increases the priority, but handle decreases as well to keep the heap valid.
+    auto position = itr->second;
+    double priority = plod->priority;
+    if (priority > _heap[position].priority)
+    {
+        _heap[position].priority = priority;
+        _moveUp(position);
+    }
+    else if (priority < _heap[position].priority)
+    {
+        _heap[position].priority = priority;
+        _moveDown(position);
+    }
+}
+
+bool DatabaseQueue::_wait(std::unique_lock<std::mutex>& lock)
+{
     std::chrono::duration waitDuration = std::chrono::milliseconds(100);
-    std::unique_lock lock(_mutex);
 
     // wait until the conditional variable signals that an operation has been added
-    while (_queue.empty() && _status->active())
+    while (_heap.empty() && _status->active())
     {
-        // debug("   Waiting on condition variable B size = ", _queue.size());
+        // debug("   Waiting on condition variable B size = ", _heap.size());
         _cv.wait_for(lock, waitDuration);
     }
 
     // if the threads we are associated with should no longer be running go for a quick exit and return nothing.
-    if (_queue.empty() || _status->cancel())
+    return !_heap.empty() && _status->active();
+}
+
+ref_ptr<PagedLOD> DatabaseQueue::_pop()
+{
+    // the PagedLOD with the highest priority is at the top of the heap
+    ref_ptr<PagedLOD> plod = std::move(_heap.front().plod);
+    _positions.erase(plod.get());
+
+    if (_heap.size() > 1)
     {
-        // debug("DatabaseQueue::take_when_available() C empty");
-        return {};
+        _heap.front() = std::move(_heap.back());
+        _heap.pop_back();
+        _moveDown(0);
+    }
+    else
+    {
+        _heap.pop_back();
     }
 
-    // debug("DatabaseQueue::take_when_available() D ", _queue.size());
+    return plod;
+}
 
-    // find the PagedLOD with the highest priority;
-    auto itr = _queue.begin();
-    auto highest_itr = itr++;
+ref_ptr<PagedLOD> DatabaseQueue::take_when_available()
+{
+    // debug("DatabaseQueue::take_when_available() A size = ", _heap.size());
+
+    std::unique_lock lock(_mutex);
+    if (!_wait(lock)) return {};
+
+    return _pop();
+}
+
+DatabaseQueue::Nodes DatabaseQueue::take_when_available(size_t maxNumNodes)
+{
+    Nodes nodes;
 
-    for (; itr != _queue.end(); ++itr)
+    std::unique_lock lock(_mutex);
+    if (!_wait(lock)) return nodes;
+
+    while (!_heap.empty() && nodes.size() < maxNumNodes)
     {
-        if ((*itr)->priority > (*highest_itr)->priority) highest_itr = itr;
+        nodes.push_back(_pop());
     }
 
-    ref_ptr<PagedLOD> plod = *highest_itr;
-    _queue.erase(highest_itr);
-
-    // debug("Returning ", plod.get(), std::dec, ", size = ", _queue.size());
-    return plod;
+    return nodes;
 }
 
 DatabaseQueue::Nodes DatabaseQueue::take_all(CompileResult& cr)
 {
     std::scoped_lock lock(_mutex);
     Nodes nodes;
-    nodes.swap(_queue);
+    for (auto& entry : _heap) nodes.emplace_back(std::move(entry.plod));
+    _heap.clear();
+    _positions.clear();
     cr.add(_compileResult);
     _compileResult.reset();
     return nodes;
 }
 
+size_t DatabaseQueue::size() const
+{
+    std::scoped_lock lock(_mutex);
+    return _heap.size();
+}
+
+/////////////////////////////////////////////////////////////////////////
+//
+// DatabaseStageStatistics
+//
+namespace
+{
+    uint64_t nanoseconds(std::chrono::steady_clock::time_point start, std::chrono::steady_clock::time_point end)
+    {
+        return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(end - start).count());
+    }
+} // namespace
+
+double DatabaseStageStatistics::averageQueueTime() const
+{
+    uint64_t count = numProcessed + numDiscarded;
+    return count > 0 ? (static_cast<double>(totalQueueTime) / static_cast<double>(count)) * 1e-6 : 0.0;
+}
+
+double DatabaseStageStatistics::averageProcessTime() const
+{
+    uint64_t count = numProcessed + numDiscarded;
+    return count > 0 ? (static_cast<double>(totalProcessTime) / static_cast<double>(count)) * 1e-6 : 0.0;
+}
+
+void DatabaseStageStatistics::reset()
+{
+    numProcessed = 0;
+    numDiscarded = 0;
+    totalQueueTime = 0;
+    totalProcessTime = 0;
+    maxProcessTime = 0;
+    totalBlockedTime = 0;
+}
+
+/////////////////////////////////////////////////////////////////////////
+//
+// DatabaseStageQueue
+//
+DatabaseStageQueue::DatabaseStageQueue(ref_ptr<ActivityStatus> status, size_t in_capacity) :
+    capacity(in_capacity),
+    _status(status)
+{
+}
+
+DatabaseStageQueue::~DatabaseStageQueue()
+{
+}
+
+uint64_t DatabaseStageQueue::add(DatabaseRequest&& request)
+{
+    std::chrono::duration waitDuration = std::chrono::milliseconds(100);
+    std::unique_lock lock(_mutex);
+
+    uint64_t blockedTime = 0;
+    if (_queue.size() >= capacity)
+    {
+        auto start = std::chrono::steady_clock::now();
+        while (_queue.size() >= capacity && _status->active())
+        {
+            _notFull.wait_for(lock, waitDuration);
+        }
+        blockedTime = nanoseconds(start, std::chrono::steady_clock::now());
+    }
+
+    if (_status->cancel()) return blockedTime;
+
+    request.queued = std::chrono::steady_clock::now();
+    _queue.emplace_back(std::move(request));
+    _notEmpty.notify_one();
+
+    return blockedTime;
+}
+
+bool DatabaseStageQueue::take_when_available(DatabaseRequest& request)
+{
+    std::chrono::duration waitDuration = std::chrono::milliseconds(100);
+    std::unique_lock lock(_mutex);
+
+    while (_queue.empty() && _status->active())
+    {
+        _notEmpty.wait_for(lock, waitDuration);
+    }
+
+    if (_queue.empty() || _status->cancel()) return false;
+
+    request = std::move(_queue.front());
+    _queue.pop_front();
+    _notFull.notify_one();
+
+    return true;
+}
+
+size_t DatabaseStageQueue::size() const
+{
+    std::scoped_lock lock(_mutex);
+    return _queue.size();
+}
+
 /////////////////////////////////////////////////////////////////////////
 //
 // DatabasePager
@@ -109,6 +328,8 @@ DatabasePager::DatabasePager()
     culledPagedLODs = CulledPagedLODs::create();
 
     _requestQueue = DatabaseQueue::create(_status);
+    _decodeQueue = DatabaseStageQueue::create(_status, maxDecodeQueueSize);
+    _compileQueue = DatabaseStageQueue::create(_status, maxCompileQueueSize);
     _toMergeQueue = DatabaseQueue::create(_status);
 
     pagedLODContainer = PagedLODContainer::create(4000);
@@ -120,10 +341,15 @@ DatabasePager::~DatabasePager()
 
     _status->set(false);
 
-    for (auto& thread : _readThreads)
+    for (auto threads : {&_readThreads, &_decodeThreads, &_compileThreads})
     {
-        thread.join();
+        for (auto& thread : *threads)
+        {
+            thread.join();
+        }
     }
+
+    if (_releaseThread.joinable()) _releaseThread.join();
 }
 
 void DatabasePager::assignInstrumentation(ref_ptr<Instrumentation> in_instrumentation)
@@ -131,78 +357,334 @@ void DatabasePager::assignInstrumentation(ref_ptr<Instrumentation> in_instrument
     instrumentation = in_instrumentation;
 }
 
+DatabasePager::QueueDepths DatabasePager::queueDepths() const
+{
+    QueueDepths depths;
+    depths.read = _requestQueue->size();
+    depths.decode = _decodeQueue->size();
+    depths.compile = _compileQueue->size();
+    depths.merge = _toMergeQueue->size() + _numPendingMerges;
+    {
+        std::scoped_lock lock(_releaseMutex);
+        depths.release = _toRelease.size();
+    }
+    return depths;
+}
+
 void DatabasePager::start()
 {
-    int numReadThreads = 4;
+    _decodeQueue->capacity = std::max(maxDecodeQueueSize, size_t(1));
+    _compileQueue->capacity = std::max(maxCompileQueueSize, size_t(1));
+
+    auto setUpThread = [](DatabasePager& databasePager, const std::string& threadName) {
+        auto local_instrumentation = shareOrDuplicateForThreadSafety(databasePager.instrumentation);
+        if (local_instrumentation) local_instrumentation->setThreadName(threadName);
+    };
+
+    auto recordProcessTime = [](DatabaseStageStatistics& statistics, std::chrono::steady_clock::time_point start) {
+        auto processTime = nanoseconds(start, std::chrono::steady_clock::now());
+        statistics.totalProcessTime += processTime;
+        exchange_if_greater(statistics.maxProcessTime, processTime);
+    };
 
     //
-    // set up read thread(s)
+    // read stage, takes the highest priority requests and loads the file contents into memory
     //
-    auto read = [](ref_ptr<DatabaseQueue> requestQueue, ref_ptr<ActivityStatus> status, DatabasePager& databasePager, const std::string& threadName) {
-        debug("Started DatabaseThread read thread");
+    auto read = [setUpThread, recordProcessTime](ref_ptr<ActivityStatus> status, DatabasePager& databasePager, const std::string& threadName) {
+        debug("Started DatabasePager read thread");
+        setUpThread(databasePager, threadName);
 
-        auto local_instrumentation = shareOrDuplicateForThreadSafety(databasePager.instrumentation);
-        if (local_instrumentation) local_instrumentation->setThreadName(threadName);
+        // FileReader used when the PagedLOD::options don't provide one
+        auto blockingFileReader = FileReader::create();
+
+        // files to load with each FileReader, and the index of the request each file is for
+        struct FileReads
+        {
+            FileReader::Requests files;
+            std::vector<size_t> indices;
+        };
+        std::map<FileReader*, FileReads> fileReads;
+        std::vector<DatabaseRequest> requests;
 
+        auto& statistics = databasePager.readStatistics;
         while (status->active())
         {
-            auto plod = requestQueue->take_when_available();
-            if (plod)
-            {
-                CPU_INSTRUMENTATION_L1_NC(databasePager.instrumentation, "DatabasePager read", COLOR_PAGER);
+            auto plods = databasePager._requestQueue->take_when_available(std::max(databasePager.maxNumReadsPerThread, 1u));
+            if (plods.empty()) continue;
+
+            CPU_INSTRUMENTATION_L1_NC(databasePager.instrumentation, "DatabasePager read", COLOR_PAGER);
+
+            auto start = std::chrono::steady_clock::now();
 
-                uint64_t frameDelta = databasePager.frameCount - plod->frameHighResLastUsed.load();
-                if (frameDelta > 1 || !compare_exchange(plod->requestStatus, PagedLOD::ReadRequest, PagedLOD::Reading))
+            for (auto& plod : plods)
+            {
+                if (databasePager.requestExpired(plod) || !compare_exchange(plod->requestStatus, PagedLOD::ReadRequest, PagedLOD::Reading))
                 {
                     // debug("Expire read request");
                     databasePager.requestDiscarded(plod);
+                    ++statistics.numDiscarded;
                     continue;
                 }
 
-                auto read_object = vsg::read(plod->filename, plod->options);
-                auto subgraph = read_object.cast<Node>();
+                DatabaseRequest request;
+                request.plod = plod;
+                request.activityStatus = databasePager._startRequest(plod);
 
-                if (subgraph && compare_exchange(plod->requestStatus, PagedLOD::Reading, PagedLOD::Compiling))
+                const auto& options = plod->options;
+                if (databasePager.readFilesIntoMemory && options && !options->readerWriters.empty() && !options->sharedObjects)
                 {
+                    if (auto filename = findFile(plod->filename, options); filename && fileType(filename) == REGULAR_FILE)
                     {
-                        std::scoped_lock<std::mutex> lock(databasePager.pendingPagedLODMutex);
-                        plod->pending = subgraph;
+                        auto& reads = fileReads[options->fileReader ? options->fileReader.get() : blockingFileReader.get()];
+                        reads.files.push_back(FileReader::Request{filename, {}, false});
+                        reads.indices.push_back(requests.size());
                     }
+                }
 
-                    // compile plod
-                    if (auto result = databasePager.compileManager->compile(subgraph))
-                    {
-                        plod->requestStatus.exchange(PagedLOD::MergeRequest);
+                requests.push_back(std::move(request));
+            }
 
-                        // move to the merge queue;
-                        databasePager._toMergeQueue->add(plod, result);
-                    }
-                    else
-                    {
-                        debug("Failed to compile ", plod, " ", plod->filename);
-                        databasePager.requestDiscarded(plod);
-                    }
+            // load the files together so that asynchronous FileReaders can keep them all in flight
+            for (auto& [fileReader, reads] : fileReads)
+            {
+                fileReader->read(reads.files);
+
+                for (size_t i = 0; i < reads.files.size(); ++i)
+                {
+                    auto& file = reads.files[i];
+                    if (!file.success || file.buffer.empty()) continue;
+
+                    auto& request = requests[reads.indices[i]];
+                    request.buffer = std::move(file.buffer);
+                    request.filename = file.filename;
                 }
-                else
+            }
+            fileReads.clear();
+
+            if (!requests.empty()) recordProcessTime(statistics, start);
+
+            for (auto& request : requests)
+            {
+                if (databasePager.requestCancelled(request))
                 {
-                    if (auto read_error = read_object.cast<ReadError>())
-                        warn(read_error->message);
-                    else
-                        warn("Failed to read ", plod, " ", plod->filename);
+                    databasePager.requestDiscarded(request.plod);
+                    ++statistics.numDiscarded;
+                    continue;
+                }
 
-                    databasePager.requestDiscarded(plod);
+                ++statistics.numProcessed;
+
+                statistics.totalBlockedTime += databasePager._decodeQueue->add(std::move(request));
+            }
+            requests.clear();
+        }
+        debug("Finished DatabasePager read thread");
+    };
+
+    //
+    // decode stage, reads the subgraph from the loaded file contents or directly from file
+    //
+    auto decode = [setUpThread, recordProcessTime](ref_ptr<ActivityStatus> status, DatabasePager& databasePager, const std::string& threadName) {
+        debug("Started DatabasePager decode thread");
+        setUpThread(databasePager, threadName);
+
+        auto& statistics = databasePager.decodeStatistics;
+        DatabaseRequest request;
+        while (databasePager._decodeQueue->take_when_available(request))
+        {
+            CPU_INSTRUMENTATION_L1_NC(databasePager.instrumentation, "DatabasePager decode", COLOR_PAGER);
+
+            auto start = std::chrono::steady_clock::now();
+            statistics.totalQueueTime += nanoseconds(request.queued, start);
+
+            auto plod = request.plod;
+            if (databasePager.requestCancelled(request))
+            {
+                databasePager.requestDiscarded(plod);
+                ++statistics.numDiscarded;
+                continue;
+            }
+
+            // pass the cancellation token to the ReaderWriters so they can abandon the read if the request is cancelled
+            auto local_options = plod->options ? Options::create(*plod->options) : Options::create();
+            local_options->activityStatus = request.activityStatus;
+
+            ref_ptr<Object> read_object;
+            if (!request.buffer.empty())
+            {
+                // read from memory, providing the extension and location of the file so that the ReaderWriter can select the format and find any files it references.
+                auto memory_options = Options::create(*local_options);
+                memory_options->extensionHint = lowerCaseFileExtension(request.filename);
+                memory_options->paths.insert(memory_options->paths.begin(), filePath(request.filename));
+
+                read_object = vsg::read(request.buffer.data(), request.buffer.size(), memory_options);
+
+                request.buffer.clear();
+                request.buffer.shrink_to_fit();
+            }
+
+            // fallback to reading the file when the ReaderWriters couldn't read from memory
+            if (!read_object && !databasePager.requestCancelled(request)) read_object = vsg::read(plod->filename, local_options);
+
+            auto subgraph = read_object.cast<Node>();
+
+            recordProcessTime(statistics, start);
+
+            if (databasePager.requestCancelled(request))
+            {
+                debug("Cancelled read of ", plod, " ", plod->filename);
+                databasePager.requestDiscarded(plod);
+                ++statistics.numDiscarded;
+            }
+            else if (subgraph && compare_exchange(plod->requestStatus, PagedLOD::Reading, PagedLOD::Compiling))
+            {
+                {
+                    std::scoped_lock<std::mutex> lock(databasePager.pendingPagedLODMutex);
+                    plod->pending = subgraph;
                 }
+
+                ++statistics.numProcessed;
+
+                // move to the compile queue
+                statistics.totalBlockedTime += databasePager._compileQueue->add(std::move(request));
+            }
+            else
+            {
+                if (auto read_error = read_object.cast<ReadError>())
+                    warn(read_error->message);
+                else
+                    warn("Failed to read ", plod, " ", plod->filename);
+
+                databasePager.requestDiscarded(plod);
+                ++statistics.numDiscarded;
+            }
+        }
+        debug("Finished DatabasePager decode thread");
+    };
+
+    //
+    // compile stage, compiles the subgraph ready for merging
+    //
+    auto compile = [setUpThread, recordProcessTime](ref_ptr<ActivityStatus> /*status*/, DatabasePager& databasePager, const std::string& threadName) {
+        debug("Started DatabasePager compile thread");
+        setUpThread(databasePager, threadName);
+
+        auto& statistics = databasePager.compileStatistics;
+        DatabaseRequest request;
+        while (databasePager._compileQueue->take_when_available(request))
+        {
+            CPU_INSTRUMENTATION_L1_NC(databasePager.instrumentation, "DatabasePager compile", COLOR_PAGER);
+
+            auto start = std::chrono::steady_clock::now();
+            statistics.totalQueueTime += nanoseconds(request.queued, start);
+
+            auto plod = request.plod;
+            if (databasePager.requestCancelled(request))
+            {
+                databasePager.requestDiscarded(plod);
+                ++statistics.numDiscarded;
+                continue;
+            }
+
+            ref_ptr<Node> subgraph;
+            {
+                std::scoped_lock<std::mutex> lock(databasePager.pendingPagedLODMutex);
+                subgraph = plod->pending;
+            }
+
+            auto result = subgraph ? databasePager.compileManager->compile(subgraph, {}, request.activityStatus) : CompileResult{};
+
+            recordProcessTime(statistics, start);
+
+            if (result)
+            {
+                databasePager._finishRequest(plod);
+
+                // estimate the memory used by the subgraph so that updateSceneGraph() can keep the loaded subgraphs within the memory budgets
+                ComputeMemoryFootprint computeMemoryFootprint;
+                subgraph->accept(computeMemoryFootprint);
+                plod->highResCPUMemory = computeMemoryFootprint.cpuMemory;
+                plod->highResGPUMemory = computeMemoryFootprint.gpuMemory;
+
+                plod->requestStatus.exchange(PagedLOD::MergeRequest);
+                ++statistics.numProcessed;
+
+                // move to the merge queue;
+                databasePager._toMergeQueue->add(plod, result);
+            }
+            else
+            {
+                debug("Failed to compile ", plod, " ", plod->filename, " ", result.message);
+                databasePager.requestDiscarded(plod);
+                ++statistics.numDiscarded;
+            }
+        }
+        debug("Finished DatabasePager compile thread");
+    };
+
+    for (uint32_t i = 0; i < std::max(numReadThreads, 1u); ++i)
+    {
+        _readThreads.emplace_back(read, std::ref(_status), std::ref(*this), make_string("DatabasePager read thread ", i));
+    }
+
+    for (uint32_t i = 0; i < std::max(numDecodeThreads, 1u); ++i)
+    {
+        _decodeThreads.emplace_back(decode, std::ref(_status), std::ref(*this), make_string("DatabasePager decode thread ", i));
+    }
+
+    for (uint32_t i = 0; i < std::max(numCompileThreads, 1u); ++i)
+    {
+        _compileThreads.emplace_back(compile, std::ref(_status), std::ref(*this), make_string("DatabasePager compile thread ", i));
+    }
+
+    //
+    // release stage, destroys the subgraphs trimmed by updateSceneGraph()
+    //
+    auto release = [setUpThread](ref_ptr<ActivityStatus> status, DatabasePager& databasePager, const std::string& threadName) {
+        debug("Started DatabasePager release thread");
+        setUpThread(databasePager, threadName);
+
+        std::chrono::duration waitDuration = std::chrono::milliseconds(100);
+        std::vector<ref_ptr<Node>> nodes;
+        while (status->active())
+        {
+            {
+                std::unique_lock lock(databasePager._releaseMutex);
+                if (databasePager._toRelease.empty()) databasePager._releaseCondition.wait_for(lock, waitDuration);
+                nodes.swap(databasePager._toRelease);
+            }
+
+            if (!nodes.empty())
+            {
+                CPU_INSTRUMENTATION_L1_NC(databasePager.instrumentation, "DatabasePager release", COLOR_PAGER);
+                nodes.clear();
             }
         }
-        debug("Finished DatabaseThread read thread");
+        debug("Finished DatabasePager release thread");
     };
 
-    for (int i = 0; i < numReadThreads; ++i)
+    if (releaseOnBackgroundThread)
     {
-        _readThreads.emplace_back(read, std::ref(_requestQueue), std::ref(_status), std::ref(*this), make_string("DatabasePager thread ", i));
+        _releaseThread = std::thread(release, std::ref(_status), std::ref(*this), "DatabasePager release thread");
     }
 }
 
+void DatabasePager::_release(std::vector<ref_ptr<Node>>& nodes)
+{
+    if (nodes.empty() || !_releaseThread.joinable())
+    {
+        nodes.clear();
+        return;
+    }
+
+    std::scoped_lock lock(_releaseMutex);
+    _toRelease.insert(_toRelease.end(), nodes.begin(), nodes.end());
+
+    // clear the local references while holding the lock so the release thread holds the last references
+    nodes.clear();
+    _releaseCondition.notify_one();
+}
+
 void DatabasePager::request(ref_ptr<PagedLOD> plod)
 {
     ++numActiveRequests;
@@ -231,14 +713,37 @@ void DatabasePager::request(ref_ptr<PagedLOD> plod)
     }
 }
 
+void DatabasePager::updatePriority(const PagedLOD* plod)
+{
+    _requestQueue->updatePriority(plod);
+}
+
 void DatabasePager::requestDiscarded(PagedLOD* plod)
 {
     //std::scoped_lock<std::mutex> lock(pendingPagedLODMutex);
     //plod->pending = nullptr;
     plod->requestCount.exchange(0);
     plod->requestStatus.exchange(PagedLOD::NoRequest);
+    plod->prefetched.exchange(false);
     plod->pending = {};
     --numActiveRequests;
+
+    _finishRequest(plod);
+}
+
+ref_ptr<ActivityStatus> DatabasePager::_startRequest(const PagedLOD* plod)
+{
+    auto activityStatus = ActivityStatus::create();
+
+    std::scoped_lock lock(_inflightMutex);
+    _inflightRequests[plod] = activityStatus;
+    return activityStatus;
+}
+
+void DatabasePager::_finishRequest(const PagedLOD* plod)
+{
+    std::scoped_lock lock(_inflightMutex);
+    _inflightRequests.erase(plod);
 }
 
 void DatabasePager::updateSceneGraph(FrameStamp* frameStamp, CompileResult& cr)
@@ -247,7 +752,30 @@ void DatabasePager::updateSceneGraph(FrameStamp* frameStamp, CompileResult& cr)
 
     frameCount.exchange(frameStamp ? frameStamp->frameCount : 0);
 
-    auto nodes = _toMergeQueue->take_all(cr);
+    auto updateStart = std::chrono::steady_clock::now();
+    auto withinTimeBudget = [&]() {
+        return updateTimeBudget <= 0.0 || std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - updateStart).count() < updateTimeBudget;
+    };
+
+    // newly compiled subgraphs are merged after those carried over from previous frames
+    auto& nodes = _pendingMerges;
+    nodes.splice(nodes.end(), _toMergeQueue->take_all(cr));
+
+    // discard the queued read requests for PagedLOD that are no longer being traversed, in one pass rather than leaving the read threads to take them one at a time.
+    auto expired = _requestQueue->take_if([&](const PagedLOD& plod) { return requestExpired(&plod); });
+    for (auto& plod : expired)
+    {
+        requestDiscarded(plod);
+    }
+
+    // cancel the requests being read, decoded or compiled that are no longer required
+    {
+        std::scoped_lock lock(_inflightMutex);
+        for (auto& [plod, activityStatus] : _inflightRequests)
+        {
+            if (requestExpired(plod)) activityStatus->set(false);
+        }
+    }
 
     if (culledPagedLODs)
     {
@@ -296,30 +824,68 @@ void DatabasePager::updateSceneGraph(FrameStamp* frameStamp, CompileResult& cr)
 
         debug("DatabasePager : activeList.count = ", pagedLODContainer->activeList.count, ", inactiveList.count = ", pagedLODContainer->inactiveList.count, ", total = ", total);
 
+        uint32_t targetNumInactive = pagedLODContainer->inactiveList.count;
         if ((nodes.size() + total) > targetMaxNumPagedLODWithHighResSubgraphs)
         {
             uint32_t numPagedLODHighRestSubgraphsToRemove = (static_cast<uint32_t>(nodes.size()) + total) - targetMaxNumPagedLODWithHighResSubgraphs;
-            uint32_t targetNumInactive = (numPagedLODHighRestSubgraphsToRemove < pagedLODContainer->inactiveList.count) ? (pagedLODContainer->inactiveList.count - numPagedLODHighRestSubgraphsToRemove) : 0;
+            targetNumInactive = (numPagedLODHighRestSubgraphsToRemove < pagedLODContainer->inactiveList.count) ? (pagedLODContainer->inactiveList.count - numPagedLODHighRestSubgraphsToRemove) : 0;
 
             debug("Need to remove, inactive count = ", pagedLODContainer->inactiveList.count, ", target = ", targetNumInactive);
+        }
 
-            for (uint32_t index = pagedLODContainer->inactiveList.head; (index != 0) && (pagedLODContainer->inactiveList.count > targetNumInactive);)
-            {
-                auto& element = elements[index];
-                index = element.next;
+        // include the subgraphs about to be merged in the memory totals so room is made for them
+        uint64_t cpuMemory = totalCPUMemory;
+        uint64_t gpuMemory = totalGPUMemory;
+        for (auto& plod : nodes)
+        {
+            cpuMemory += plod->highResCPUMemory;
+            gpuMemory += plod->highResGPUMemory;
+        }
+
+        auto overBudget = [&]() {
+            return (cpuMemoryBudget > 0 && cpuMemory > cpuMemoryBudget) || (gpuMemoryBudget > 0 && gpuMemory > gpuMemoryBudget);
+        };
+
+        // trimmed subgraphs are passed to the release thread rather than destroyed here
+        std::vector<ref_ptr<Node>> trimmed;
+        uint32_t numTrimmed = 0;
+        auto withinTrimBudget = [&]() {
+            return (maxNumTrimsPerFrame == 0 || numTrimmed < maxNumTrimsPerFrame) && withinTimeBudget();
+        };
+
+        // inactive PagedLOD are appended to the end of the inactiveList so the head of the list is the least recently used.
+        for (uint32_t index = pagedLODContainer->inactiveList.head; (index != 0) && ((pagedLODContainer->inactiveList.count > targetNumInactive) || overBudget()) && withinTrimBudget();)
+        {
+            auto& element = elements[index];
+            index = element.next;
 
-                if (compare_exchange(element.plod->requestStatus, PagedLOD::NoRequest, PagedLOD::DeleteRequest))
+            if (compare_exchange(element.plod->requestStatus, PagedLOD::NoRequest, PagedLOD::DeleteRequest))
+            {
+                ref_ptr<PagedLOD> plod = element.plod;
+                if (plod->children[0].node)
                 {
-                    ref_ptr<PagedLOD> plod = element.plod;
-                    plod->children[0].node = nullptr;
-                    plod->requestCount.exchange(0);
-                    plod->requestStatus.exchange(PagedLOD::NoRequest);
-                    plod->pending = {};
-                    pagedLODContainer->remove(plod);
-                    debug("    trimming ", plod, " ", plod->filename);
+                    cpuMemory -= std::min(cpuMemory, plod->highResCPUMemory);
+                    gpuMemory -= std::min(gpuMemory, plod->highResGPUMemory);
+                    totalCPUMemory -= std::min(totalCPUMemory.load(), plod->highResCPUMemory);
+                    totalGPUMemory -= std::min(totalGPUMemory.load(), plod->highResGPUMemory);
                 }
+                plod->highResCPUMemory = 0;
+                plod->highResGPUMemory = 0;
+
+                if (plod->children[0].node) trimmed.push_back(plod->children[0].node);
+                ++numTrimmed;
+
+                plod->children[0].node = nullptr;
+                plod->requestCount.exchange(0);
+                plod->requestStatus.exchange(PagedLOD::NoRequest);
+                plod->prefetched.exchange(false);
+                plod->pending = {};
+                pagedLODContainer->remove(plod);
+                debug("    trimming ", plod, " ", plod->filename);
             }
         }
+
+        _release(trimmed);
     }
 
     if (!nodes.empty())
@@ -331,10 +897,20 @@ void DatabasePager::updateSceneGraph(FrameStamp* frameStamp, CompileResult& cr)
 #endif
 
         debug("DatabasePager::updateSceneGraph() nodes to merge : nodes.size() = ", nodes.size(), ", ", numActiveRequests.load());
-        for (auto& plod : nodes)
+
+        // merge at least one subgraph each frame so merging always progresses, the remainder are carried over to the next frame
+        uint32_t numMerged = 0;
+        auto start = std::chrono::steady_clock::now();
+        while (!nodes.empty() && (numMerged == 0 || ((maxNumMergesPerFrame == 0 || numMerged < maxNumMergesPerFrame) && withinTimeBudget())))
         {
+            auto plod = std::move(nodes.front());
+            nodes.pop_front();
+            ++numMerged;
+
             if (compare_exchange(plod->requestStatus, PagedLOD::MergeRequest, PagedLOD::Merging))
             {
+                ++mergeStatistics.numProcessed;
+
                 debug("   Merged ", plod->filename, " after ", plod->requestCount.load(), " priority ", plod->priority.load(), " ", frameCount - plod->frameHighResLastUsed.load(), " plod = ", plod);
                 {
 #if LOCAL_MUTEX
@@ -343,13 +919,28 @@ void DatabasePager::updateSceneGraph(FrameStamp* frameStamp, CompileResult& cr)
                     plod->children[0].node = plod->pending;
                 }
 
+                totalCPUMemory += plod->highResCPUMemory;
+                totalGPUMemory += plod->highResGPUMemory;
+
                 plod->requestStatus.exchange(PagedLOD::NoRequest);
             }
+            else
+            {
+                ++mergeStatistics.numDiscarded;
+            }
         }
-        numActiveRequests -= static_cast<uint32_t>(nodes.size());
+        auto mergeTime = nanoseconds(start, std::chrono::steady_clock::now());
+        mergeStatistics.totalProcessTime += mergeTime;
+        exchange_if_greater(mergeStatistics.maxProcessTime, mergeTime);
+
+        numActiveRequests -= numMerged;
+
+        if (!nodes.empty()) debug("DatabasePager::updateSceneGraph() carrying over ", nodes.size(), " nodes to merge");
     }
     else
     {
         debug("DatabasePager::updateSceneGraph() nothing to merge");
     }
+
+    _numPendingMerges = nodes.size();
 }
@@ -0,0 +1,57 @@
+/* <editor-fold desc="MIT License">
+
+Copyright(c) 2024 Robert Osfield
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"), to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+</editor-fold> */
+
+#include <vsg/io/FileReader.h>
+#include <vsg/io/FileSystem.h>
+
+#include <cstdio>
+
+using namespace vsg;
+
+FileReader::FileReader()
+{
+}
+
+FileReader::~FileReader()
+{
+}
+
+void FileReader::read(Requests& requests)
+{
+    for (auto& request : requests)
+    {
+        request.success = read(request.filename, request.buffer);
+    }
+}
+
+bool FileReader::read(const Path& filename, std::vector<uint8_t>& buffer)
+{
+    buffer.clear();
+
+    auto file = vsg::fopen(filename, "rb");
+    if (!file) return false;
+
+    bool success = false;
+    if (std::fseek(file, 0, SEEK_END) == 0)
+    {
+        auto size = std::ftell(file);
+        if (size >= 0 && std::fseek(file, 0, SEEK_SET) == 0)
+        {
+            buffer.resize(static_cast<size_t>(size));
+            success = std::fread(buffer.data(), 1, buffer.size(), file) == buffer.size();
+            if (!success) buffer.clear();
+        }
+    }
+
+    std::fclose(file);
+    return success;
+}
@@ -15,6 +15,7 @@ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLI
 #include <vsg/io/Options.h>
 #include <vsg/io/stream.h>
 
+#include <atomic>
 #include <cstdio>
 
 #if defined(WIN32) && !defined(__CYGWIN__)
@@ -288,6 +289,53 @@ FILE* vsg::fopen(const Path& path, const char* mode)
 #endif
 }
 
+bool vsg::renameFile(const Path& oldPath, const Path& newPath)
+{
+#if defined(_MSC_VER) || defined(__MINGW32__)
+    return MoveFileExW(oldPath.c_str(), newPath.c_str(), MOVEFILE_REPLACE_EXISTING) != 0;
+#else
+    return ::rename(oldPath.c_str(), newPath.c_str()) == 0;
+#endif
+}
+
+bool vsg::removeFile(const Path& path)
+{
+#if defined(_MSC_VER) || defined(__MINGW32__)
+    return DeleteFileW(path.c_str()) != 0;
+#else
+    return ::remove(path.c_str()) == 0;
+#endif
+}
+
+bool vsg::writeFileAtomically(const Path& path, const std::function<bool(FILE* file)>& writeFunction)
+{
+    makeDirectory(filePath(path));
+
+#if defined(_MSC_VER) || defined(__MINGW32__)
+    auto processID = static_cast<uint64_t>(GetCurrentProcessId());
+#else
+    auto processID = static_cast<uint64_t>(getpid());
+#endif
+
+    // the process ID distinguishes concurrent processes and the count concurrent threads within this process
+    static std::atomic_uint64_t s_count = 0;
+    Path tempPath = path;
+    tempPath.concat(make_string(".", processID, "_", s_count.fetch_add(1), ".tmp"));
+
+    auto file = vsg::fopen(tempPath, "wb");
+    if (!file) return false;
+
+    bool result = writeFunction(file);
+    result = (std::fclose(file) == 0) && result;
+
+    if (!result || !renameFile(tempPath, path))
+    {
+        removeFile(tempPath);
+        return false;
+    }
+    return true;
+}
+
 #if defined(_MSC_VER) || defined(__MINGW32__)
 // Microsoft API for reading directories
 Paths vsg::getDirectoryContents(const Path& directoryName)
@@ -10,8 +10,10 @@ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLI
 
 </editor-fold> */
 
+#include <vsg/core/Exception.h>
 #include <vsg/io/Input.h>
 #include <vsg/io/Options.h>
+#include <vsg/threading/ActivityStatus.h>
 
 using namespace vsg;
 
@@ -20,13 +22,36 @@ Input::Input(ref_ptr<ObjectFactory> in_objectFactory, ref_ptr<const Options> in_
     options(in_options),
     version{vsgGetVersion()}
 {
-    objectIDMap[0] = nullptr;
+    assignObjectID(0, {});
 }
 
 Input::~Input()
 {
 }
 
+void Input::assignObjectID(ObjectID id, ref_ptr<Object> object)
+{
+    if (id >= objectIDs.size())
+    {
+        if (static_cast<size_t>(id) > objectIDs.size() + maximumObjectIDGap) throw Exception{"Invalid ObjectID " + std::to_string(id) + " in " + filename.string()};
+        objectIDs.resize(static_cast<size_t>(id) + 1);
+    }
+
+    auto& entry = objectIDs[id];
+    entry.assigned = true;
+    entry.object = object;
+}
+
+void Input::reserveObjectIDs(ObjectID startID, ObjectID endID)
+{
+    if (static_cast<size_t>(startID) > objectIDs.size() + maximumObjectIDGap || endID < startID)
+    {
+        throw Exception{"Invalid ObjectID range " + std::to_string(startID) + " to " + std::to_string(endID) + " in " + filename.string()};
+    }
+
+    if (endID >= objectIDs.size()) objectIDs.resize(static_cast<size_t>(endID) + 1);
+}
+
 bool Input::version_less(uint32_t major, uint32_t minor, uint32_t patch, uint32_t soversion) const
 {
     return version < VsgVersion{major, minor, patch, soversion};
@@ -36,3 +61,8 @@ bool Input::version_greater_equal(uint32_t major, uint32_t minor, uint32_t patch
 {
     return !version_less(major, minor, patch, soversion);
 }
+
+bool Input::cancelled() const
+{
+    return options && options->activityStatus && options->activityStatus->cancel();
+}
@@ -0,0 +1,378 @@
+/* <editor-fold desc="MIT License">
+
+Copyright(c) 2024 Robert Osfield
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"), to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+</editor-fold> */
+
+#include <vsg/core/Version.h>
+#include <vsg/io/IoUringFileReader.h>
+#include <vsg/io/Logger.h>
+
+#include <algorithm>
+
+#if VSG_SUPPORTS_io_uring
+#    include <cerrno>
+#    include <cstring>
+#    include <deque>
+#    include <fcntl.h>
+#    include <linux/io_uring.h>
+#    include <sys/mman.h>
+#    include <sys/stat.h>
+#    include <sys/syscall.h>
+#    include <unistd.h>
+#endif
+
+using namespace vsg;
+
+#if VSG_SUPPORTS_io_uring
+
+// io_uring submission and completion rings set up with the raw system calls so that liburing isn't required.
+struct IoUringFileReader::Ring
+{
+    explicit Ring(uint32_t entries)
+    {
+        io_uring_params params;
+        std::memset(&params, 0, sizeof(params));
+
+        fd = static_cast<int>(syscall(__NR_io_uring_setup, entries, &params));
+        if (fd < 0) return;
+
+        // IORING_OP_READ was introduced alongside IORING_FEAT_RW_CUR_POS in Linux 5.6
+        if ((params.features & IORING_FEAT_RW_CUR_POS) == 0) return;
+
+        sqSize = params.sq_off.array + params.sq_entries * sizeof(unsigned);
+        cqSize = params.cq_off.cqes + params.cq_entries * sizeof(io_uring_cqe);
+        bool singleMmap = (params.features & IORING_FEAT_SINGLE_MMAP) != 0;
+        if (singleMmap) sqSize = cqSize = std::max(sqSize, cqSize);
+
+        sqPtr = mmap(nullptr, sqSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, fd, IORING_OFF_SQ_RING);
+        if (sqPtr == MAP_FAILED)
+        {
+            sqPtr = nullptr;
+            return;
+        }
+
+        if (singleMmap)
+        {
+            cqPtr = sqPtr;
+        }
+        else
+        {
+            cqPtr = mmap(nullptr, cqSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, fd, IORING_OFF_CQ_RING);
+            if (cqPtr == MAP_FAILED)
+            {
+                cqPtr = nullptr;
+                return;
+            }
+        }
+
+        sqesSize = params.sq_entries * sizeof(io_uring_sqe);
+        void* sqesPtr = mmap(nullptr, sqesSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, fd, IORING_OFF_SQES);
+        if (sqesPtr == MAP_FAILED) return;
+
+        auto sq = static_cast<uint8_t*>(sqPtr);
+        sqTail = reinterpret_cast<unsigned*>(sq + params.sq_off.tail);
+        sqMask = reinterpret_cast<unsigned*>(sq + params.sq_off.ring_mask);
+        sqArray = reinterpret_cast<unsigned*>(sq + params.sq_off.array);
+
+        auto cq = static_cast<uint8_t*>(cqPtr);
+        cqHead = reinterpret_cast<unsigned*>(cq + params.cq_off.head);
+        cqTail = reinterpret_cast<unsigned*>(cq + params.cq_off.tail);
+        cqMask = reinterpret_cast<unsigned*>(cq + params.cq_off.ring_mask);
+        cqes = reinterpret_cast<io_uring_cqe*>(cq + params.cq_off.cqes);
+
+        sqEntries = params.sq_entries;
+        sqes = static_cast<io_uring_sqe*>(sqesPtr);
+    }
+
+    ~Ring()
+    {
+        if (sqes) munmap(sqes, sqesSize);
+        if (cqPtr && cqPtr != sqPtr) munmap(cqPtr, cqSize);
+        if (sqPtr) munmap(sqPtr, sqSize);
+        if (fd >= 0) close(fd);
+    }
+
+    bool valid() const { return sqes != nullptr; }
+
+    // add a read to the submission queue, the caller must ensure that no more than sqEntries are queued or in flight.
+    void prepareRead(int file, void* buffer, uint32_t length, uint64_t offset, uint64_t userData)
+    {
+        unsigned tail = *sqTail;
+        unsigned index = tail & *sqMask;
+
+        auto& sqe = sqes[index];
+        std::memset(&sqe, 0, sizeof(sqe));
+        sqe.opcode = IORING_OP_READ;
+        sqe.fd = file;
+        sqe.addr = reinterpret_cast<uint64_t>(buffer);
+        sqe.len = length;
+        sqe.off = offset;
+        sqe.user_data = userData;
+
+        sqArray[index] = index;
+        __atomic_store_n(sqTail, tail + 1, __ATOMIC_RELEASE);
+    }
+
+    // submit the queued reads and wait for at least minComplete completions, returns the number of submissions consumed or -1 with errno set.
+    int enter(unsigned toSubmit, unsigned minComplete)
+    {
+        return static_cast<int>(syscall(__NR_io_uring_enter, fd, toSubmit, minComplete, IORING_ENTER_GETEVENTS, nullptr, 0));
+    }
+
+    // call the function for each of the completed reads
+    template<typename F>
+    void reap(F function)
+    {
+        unsigned head = *cqHead;
+        unsigned tail = __atomic_load_n(cqTail, __ATOMIC_ACQUIRE);
+        for (; head != tail; ++head)
+        {
+            const auto& cqe = cqes[head & *cqMask];
+            function(cqe.user_data, cqe.res);
+        }
+        __atomic_store_n(cqHead, head, __ATOMIC_RELEASE);
+    }
+
+    int fd = -1;
+    uint32_t sqEntries = 0;
+
+    void* sqPtr = nullptr;
+    size_t sqSize = 0;
+    void* cqPtr = nullptr;
+    size_t cqSize = 0;
+    io_uring_sqe* sqes = nullptr;
+    size_t sqesSize = 0;
+
+    unsigned* sqTail = nullptr;
+    unsigned* sqMask = nullptr;
+    unsigned* sqArray = nullptr;
+
+    unsigned* cqHead = nullptr;
+    unsigned* cqTail = nullptr;
+    unsigned* cqMask = nullptr;
+    io_uring_cqe* cqes = nullptr;
+};
+
+#else
+
+struct IoUringFileReader::Ring
+{
+};
+
+#endif
+
+IoUringFileReader::IoUringFileReader(uint32_t in_queueDepth) :
+    queueDepth(std::max(in_queueDepth, 1u))
+{
+#if VSG_SUPPORTS_io_uring
+    auto ring = new Ring(queueDepth);
+    if (ring->valid())
+    {
+        _supported = true;
+        _availableRings.push_back(ring);
+    }
+    else
+    {
+        info("IoUringFileReader : io_uring not available, falling back to blocking reads.");
+        delete ring;
+    }
+#endif
+}
+
+IoUringFileReader::~IoUringFileReader()
+{
+    for (auto ring : _availableRings) delete ring;
+}
+
+IoUringFileReader::Ring* IoUringFileReader::_takeRing()
+{
+    if (!_supported) return nullptr;
+
+    {
+        std::scoped_lock lock(_ringMutex);
+        if (!_availableRings.empty())
+        {
+            auto ring = _availableRings.back();
+            _availableRings.pop_back();
+            return ring;
+        }
+    }
+
+#if VSG_SUPPORTS_io_uring
+    auto ring = new Ring(queueDepth);
+    if (ring->valid()) return ring;
+    delete ring;
+#endif
+    return nullptr;
+}
+
+void IoUringFileReader::_returnRing(Ring* ring)
+{
+    std::scoped_lock lock(_ringMutex);
+    _availableRings.push_back(ring);
+}
+
+void IoUringFileReader::read(Requests& requests)
+{
+#if VSG_SUPPORTS_io_uring
+    auto ring = _takeRing();
+    if (!ring)
+    {
+        FileReader::read(requests);
+        return;
+    }
+
+    struct FileRead
+    {
+        int fd = -1;
+        size_t offset = 0;
+        bool complete = false;
+        bool queued = false; // a read into the buffer has been added to the ring and not yet reaped
+    };
+    std::vector<FileRead> reads(requests.size());
+    std::deque<size_t> pending;
+
+    auto finish = [&](size_t i, bool success) {
+        auto& fileRead = reads[i];
+        if (fileRead.fd >= 0) close(fileRead.fd);
+        fileRead.fd = -1;
+        fileRead.complete = true;
+
+        requests[i].success = success;
+        if (!success) requests[i].buffer.clear();
+    };
+
+    // open the files and allocate the buffers, the files are opened with blocking calls as opens are normally cheap compared to the reads.
+    for (size_t i = 0; i < requests.size(); ++i)
+    {
+        auto& request = requests[i];
+        request.buffer.clear();
+
+        auto& fileRead = reads[i];
+        fileRead.fd = open(request.filename.c_str(), O_RDONLY | O_CLOEXEC);
+
+        struct stat status;
+        if (fileRead.fd < 0 || fstat(fileRead.fd, &status) != 0 || !S_ISREG(status.st_mode))
+        {
+            finish(i, false);
+            continue;
+        }
+
+        request.buffer.resize(static_cast<size_t>(status.st_size));
+        if (request.buffer.empty())
+            finish(i, true);
+        else
+            pending.push_back(i);
+    }
+
+    // the length of an io_uring read is 32 bit so split larger files into multiple reads
+    const size_t maxReadLength = size_t(1) << 30;
+
+    uint32_t queued = 0;
+    uint32_t inflight = 0;
+    bool failed = false;
+    while (!pending.empty() || queued > 0 || inflight > 0)
+    {
+        while (!pending.empty() && (queued + inflight) < ring->sqEntries)
+        {
+            auto i = pending.front();
+            pending.pop_front();
+
+            auto& fileRead = reads[i];
+            auto& buffer = requests[i].buffer;
+            auto length = std::min(buffer.size() - fileRead.offset, maxReadLength);
+            ring->prepareRead(fileRead.fd, buffer.data() + fileRead.offset, static_cast<uint32_t>(length), fileRead.offset, i);
+            fileRead.queued = true;
+            ++queued;
+        }
+
+        int result = ring->enter(queued, 1);
+        if (result >= 0)
+        {
+            queued -= static_cast<uint32_t>(result);
+            inflight += static_cast<uint32_t>(result);
+        }
+        else if (errno != EINTR && errno != EAGAIN && errno != EBUSY)
+        {
+            warn("IoUringFileReader : io_uring_enter() failed with errno = ", errno, ", falling back to blocking reads.");
+            failed = true;
+            break;
+        }
+
+        ring->reap([&](uint64_t i, int res) {
+            --inflight;
+
+            auto& fileRead = reads[i];
+            fileRead.queued = false;
+            if (res == -EINTR || res == -EAGAIN)
+            {
+                pending.push_back(i);
+            }
+            else if (res <= 0)
+            {
+                // error or file truncated since it was opened
+                finish(i, false);
+            }
+            else
+            {
+                fileRead.offset += static_cast<size_t>(res);
+                if (fileRead.offset < requests[i].buffer.size())
+                    pending.push_back(i);
+                else
+                    finish(i, true);
+            }
+        });
+    }
+
+    if (failed)
+    {
+        // the kernel may still be writing into the buffers of submitted reads, so wait for them to complete before reusing the buffers or releasing the ring
+        while (inflight > 0)
+        {
+            if (ring->enter(0, inflight) < 0 && errno != EINTR && errno != EAGAIN && errno != EBUSY) break;
+
+            ring->reap([&](uint64_t i, int) {
+                --inflight;
+                reads[i].queued = false;
+            });
+        }
+
+        if (inflight == 0)
+        {
+            delete ring;
+        }
+        else
+        {
+            // unable to wait for the outstanding reads, so leak the ring and the buffers they read into rather than let the kernel write into freed memory
+            warn("IoUringFileReader : unable to wait for ", inflight, " outstanding reads, leaking their buffers.");
+            for (size_t i = 0; i < requests.size(); ++i)
+            {
+                if (reads[i].queued) new std::vector<uint8_t>(std::move(requests[i].buffer));
+            }
+        }
+
+        // the ring is no longer usable, so read the remaining files with blocking reads
+        _supported = false;
+
+        for (size_t i = 0; i < requests.size(); ++i)
+        {
+            if (reads[i].complete) continue;
+            if (reads[i].fd >= 0) close(reads[i].fd);
+            requests[i].success = FileReader::read(requests[i].filename, requests[i].buffer);
+        }
+    }
+    else
+    {
+        _returnRing(ring);
+    }
+#else
+    FileReader::read(requests);
+#endif
+}
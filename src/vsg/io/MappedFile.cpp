@@ -0,0 +1,131 @@
+/* <editor-fold desc="MIT License">
+
+Copyright(c) 2024 Robert Osfield
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"), to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+</editor-fold> */
+
+#include <vsg/io/Logger.h>
+#include <vsg/io/MappedFile.h>
+
+#include <map>
+#include <mutex>
+
+#if defined(WIN32) && !defined(__CYGWIN__)
+#    include <windows.h>
+#else
+#    include <fcntl.h>
+#    include <sys/mman.h>
+#    include <sys/stat.h>
+#    include <unistd.h>
+#endif
+
+using namespace vsg;
+
+// registry of the active mappings, keyed by the start address, so that release() can find the MappedFile that a Data's pointer belongs to.
+static std::mutex s_mappedFilesMutex;
+static std::map<const uint8_t*, MappedFile*> s_mappedFiles;
+
+MappedFile::MappedFile(const Path& in_filename) :
+    filename(in_filename)
+{
+#if defined(WIN32) && !defined(__CYGWIN__)
+    HANDLE file = CreateFileW(filename.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (file == INVALID_HANDLE_VALUE) return;
+
+    LARGE_INTEGER fileSize;
+    if (GetFileSizeEx(file, &fileSize) && fileSize.QuadPart > 0)
+    {
+        // FILE_MAP_COPY provides copy on write pages
+        _mapping = CreateFileMappingW(file, nullptr, PAGE_WRITECOPY, 0, 0, nullptr);
+        if (_mapping)
+        {
+            _data = static_cast<uint8_t*>(MapViewOfFile(_mapping, FILE_MAP_COPY, 0, 0, 0));
+            if (_data) _size = static_cast<size_t>(fileSize.QuadPart);
+        }
+    }
+    CloseHandle(file);
+#else
+    int file = open(filename.c_str(), O_RDONLY | O_CLOEXEC);
+    if (file < 0) return;
+
+    struct stat status;
+    if (fstat(file, &status) == 0 && S_ISREG(status.st_mode) && status.st_size > 0)
+    {
+        // MAP_PRIVATE provides copy on write pages
+        void* ptr = mmap(nullptr, static_cast<size_t>(status.st_size), PROT_READ | PROT_WRITE, MAP_PRIVATE, file, 0);
+        if (ptr != MAP_FAILED)
+        {
+            _data = static_cast<uint8_t*>(ptr);
+            _size = static_cast<size_t>(status.st_size);
+        }
+    }
+    close(file);
+#endif
+
+    if (_data)
+    {
+        std::scoped_lock lock(s_mappedFilesMutex);
+        s_mappedFiles[_data] = this;
+    }
+    else
+    {
+        debug("MappedFile::MappedFile(", filename, ") unable to map file.");
+    }
+}
+
+MappedFile::~MappedFile()
+{
+    if (_data)
+    {
+        std::scoped_lock lock(s_mappedFilesMutex);
+        s_mappedFiles.erase(_data);
+    }
+
+#if defined(WIN32) && !defined(__CYGWIN__)
+    if (_data) UnmapViewOfFile(_data);
+    if (_mapping) CloseHandle(_mapping);
+#else
+    if (_data) munmap(_data, _size);
+#endif
+}
+
+void* MappedFile::reference(size_t offset)
+{
+    if (!_data || offset >= _size) return nullptr;
+
+    ref();
+    return _data + offset;
+}
+
+bool MappedFile::release(const void* ptr)
+{
+    auto address = static_cast<const uint8_t*>(ptr);
+
+    MappedFile* mappedFile = nullptr;
+    {
+        std::scoped_lock lock(s_mappedFilesMutex);
+
+        auto itr = s_mappedFiles.upper_bound(address);
+        if (itr == s_mappedFiles.begin()) return false;
+        --itr;
+
+        if (address >= itr->first + itr->second->_size) return false;
+        mappedFile = itr->second;
+    }
+
+    // unref outside the lock as the destructor unregisters the MappedFile
+    mappedFile->unref();
+    return true;
+}
+
+void vsg::releaseMappedData(void* ptr)
+{
+    // copies of mapped Data inherit the allocatorType but allocate with vsg::allocate()
+    if (!MappedFile::release(ptr)) vsg::deallocate(ptr);
+}
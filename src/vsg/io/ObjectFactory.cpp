@@ -23,7 +23,7 @@ ref_ptr<ObjectFactory>& ObjectFactory::instance()
 
 ObjectFactory::ObjectFactory()
 {
-    _createMap["nullptr"] = []() { return ref_ptr<Object>(); };
+    add("nullptr", []() { return ref_ptr<Object>(); });
 
     // cores
     add<vsg::Object>();
@@ -106,6 +106,7 @@ ObjectFactory::ObjectFactory()
     add<vsg::PhongMaterialArray>();
     add<vsg::PbrMaterialArray>();
     add<vsg::DrawIndirectCommandArray>();
+    add<vsg::DrawIndexedIndirectCommandArray>();
 
     // array2Ds
     add<vsg::byteArray2D>();
@@ -169,9 +170,11 @@ ObjectFactory::ObjectFactory()
     add<vsg::Commands>();
     add<vsg::Group>();
     add<vsg::QuadGroup>();
+    add<vsg::PackedBounds>();
     add<vsg::StateGroup>();
     add<vsg::CullGroup>();
     add<vsg::CullNode>();
+    add<vsg::ParallelRecordGroup>();
     add<vsg::LOD>();
     add<vsg::PagedLOD>();
     add<vsg::AbsoluteTransform>();
@@ -179,6 +182,7 @@ ObjectFactory::ObjectFactory()
     add<vsg::Geometry>();
     add<vsg::VertexDraw>();
     add<vsg::VertexIndexDraw>();
+    add<vsg::CulledInstanceDraw>();
     add<vsg::Bin>();
     add<vsg::DepthSorted>();
     add<vsg::Layer>();
@@ -240,6 +244,7 @@ ObjectFactory::ObjectFactory()
     add<vsg::DrawIndirect>();
     add<vsg::DrawIndexed>();
     add<vsg::DrawIndexedIndirect>();
+    add<vsg::DrawIndexedIndirectCount>();
     add<vsg::CopyImage>();
     add<vsg::BlitImage>();
     add<vsg::QueryPool>();
@@ -323,6 +328,7 @@ ObjectFactory::ObjectFactory()
     add<vsg::BillboardArrayState>();
     add<vsg::SharedObjects>();
     add<vsg::ProfileLog>();
+    add<vsg::Occluder>();
 
     // application
     add<vsg::EllipsoidModel>();
@@ -332,6 +338,52 @@ ObjectFactory::~ObjectFactory()
 {
 }
 
+ObjectFactory::TypeID ObjectFactory::add(const std::string& className, CreateFunction createFunction)
+{
+    std::scoped_lock<std::mutex> lock(_typeIndexMutex);
+
+    _createMap[className] = createFunction;
+    _typeIndexDirty = true;
+
+    return typeID(className);
+}
+
+void ObjectFactory::_rebuildTypeIndex()
+{
+    _typeIndex.clear();
+    for (auto itr = _createMap.begin(); itr != _createMap.end(); ++itr)
+    {
+        auto [typeIndexItr, inserted] = _typeIndex.emplace(typeID(itr->first), itr);
+        if (!inserted)
+        {
+            warn("ObjectFactory TypeID of ", itr->first, " clashes with ", typeIndexItr->second->first, ", ", itr->first, " can only be created by name.");
+        }
+    }
+    _typeIndexDirty = false;
+}
+
+const ObjectFactory::CreateFunction* ObjectFactory::getCreateFunction(TypeID id)
+{
+    std::scoped_lock<std::mutex> lock(_typeIndexMutex);
+
+    if (_typeIndexDirty) _rebuildTypeIndex();
+
+    if (auto itr = _typeIndex.find(id); itr != _typeIndex.end()) return &(itr->second->second);
+    return nullptr;
+}
+
+const ObjectFactory::CreateFunction* ObjectFactory::getCreateFunction(const std::string& className)
+{
+    std::scoped_lock<std::mutex> lock(_typeIndexMutex);
+
+    if (_typeIndexDirty) _rebuildTypeIndex();
+
+    // check the name as well as the TypeID so a class whose TypeID clashes is still found by name
+    if (auto itr = _typeIndex.find(typeID(className)); itr != _typeIndex.end() && itr->second->first == className) return &(itr->second->second);
+    if (auto itr = _createMap.find(className); itr != _createMap.end()) return &(itr->second);
+    return nullptr;
+}
+
 vsg::ref_ptr<vsg::Object> ObjectFactory::create(const std::string& className)
 {
     if (auto itr = _createMap.find(className); itr != _createMap.end())
@@ -343,3 +395,14 @@ vsg::ref_ptr<vsg::Object> ObjectFactory::create(const std::string& className)
     warn("ObjectFactory::create(", className, ") failed to find means to create object.");
     return vsg::ref_ptr<vsg::Object>();
 }
+
+vsg::ref_ptr<vsg::Object> ObjectFactory::create(TypeID id)
+{
+    if (auto createFunction = getCreateFunction(id))
+    {
+        return (*createFunction)();
+    }
+
+    warn("ObjectFactory::create(", id, ") failed to find means to create object.");
+    return vsg::ref_ptr<vsg::Object>();
+}
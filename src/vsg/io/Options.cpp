@@ -10,9 +10,11 @@ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLI
 
 </editor-fold> */
 
+#include <vsg/io/FileReader.h>
 #include <vsg/io/Options.h>
 #include <vsg/io/ReaderWriter.h>
 #include <vsg/state/DescriptorSetLayout.h>
+#include <vsg/threading/ActivityStatus.h>
 #include <vsg/threading/OperationThreads.h>
 #include <vsg/utils/CommandLine.h>
 #include <vsg/utils/FindDynamicObjects.h>
@@ -53,7 +55,9 @@ Options::Options(const Options& options) :
     inheritedState(options.inheritedState),
     instrumentation(options.instrumentation),
     findDynamicObjects(options.findDynamicObjects),
-    propagateDynamicObjects(options.propagateDynamicObjects)
+    propagateDynamicObjects(options.propagateDynamicObjects),
+    activityStatus(options.activityStatus),
+    fileReader(options.fileReader)
 {
     getOrCreateAuxiliary();
     // copy any meta data.
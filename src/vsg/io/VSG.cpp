@@ -10,20 +10,90 @@ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLI
 
 </editor-fold> */
 
+#include <vsg/core/Exception.h>
 #include <vsg/core/Version.h>
 #include <vsg/io/AsciiInput.h>
 #include <vsg/io/AsciiOutput.h>
 #include <vsg/io/BinaryInput.h>
 #include <vsg/io/BinaryOutput.h>
+#include <vsg/io/FileReader.h>
 #include <vsg/io/Logger.h>
+#include <vsg/io/MappedFile.h>
 #include <vsg/io/VSG.h>
+#include <vsg/io/lz.h>
 #include <vsg/io/mem_stream.h>
+#include <vsg/threading/Latch.h>
+#include <vsg/threading/OperationThreads.h>
+#include <vsg/utils/CommandLine.h>
+
+#include <algorithm>
+#include <atomic>
+#include <cstring>
 
 using namespace vsg;
 
 // use a static handle that is initialized once at start up to avoid multi-threaded issues associated with calling std::locale::classic().
 auto s_class_locale = std::locale::classic();
 
+// read the root object, returning a ReadError if the read was cancelled via Options::activityStatus
+static ref_ptr<Object> readRootObject(Input& input)
+{
+    try
+    {
+        return input.readObject("Root");
+    }
+    catch (const Exception& exception)
+    {
+        if (!input.cancelled()) throw;
+        return ReadError::create(exception.message);
+    }
+}
+
+// call func(blockIndex) for each block, running the blocks in parallel when Options::operationThreads is assigned
+template<typename F>
+static void forEachBlock(uint32_t numBlocks, const Options* options, F func)
+{
+    ref_ptr<OperationThreads> operationThreads;
+    if (options) operationThreads = options->operationThreads;
+
+    if (!operationThreads || numBlocks < 2)
+    {
+        for (uint32_t i = 0; i < numBlocks; ++i) func(i);
+        return;
+    }
+
+    struct BlockOperation : public Operation
+    {
+        BlockOperation(F& f, uint32_t i, ref_ptr<Latch> l) :
+            func(f),
+            index(i),
+            latch(l) {}
+
+        void run() override
+        {
+            func(index);
+            latch->count_down();
+        }
+
+        F& func;
+        uint32_t index;
+        ref_ptr<Latch> latch;
+    };
+
+    // use latch to synchronize this thread with the block operations
+    auto latch = Latch::create(static_cast<int>(numBlocks));
+
+    for (uint32_t i = 0; i < numBlocks; ++i)
+    {
+        operationThreads->add(ref_ptr<Operation>(new BlockOperation(func, i, latch)));
+    }
+
+    // use this thread to process blocks as well
+    operationThreads->run();
+
+    latch->wait();
+}
+
 static VsgVersion parseVersion(std::string version_string)
 {
     VsgVersion version{0, 0, 0, 0};
@@ -43,6 +113,16 @@ static VsgVersion parseVersion(std::string version_string)
     return version;
 }
 
+// names of the FormatFeatures tokens that follow the version in the header line
+static const std::pair<const char*, uint32_t> s_formatFeatureNames[] = {
+    {"aligned_payloads", VSG::ALIGNED_PAYLOADS},
+    {"class_index", VSG::CLASS_INDEX},
+    {"child_bounds", VSG::CHILD_BOUNDS}};
+
+// FormatFeatures used when writing .vsgb and .vsgt files
+static constexpr uint32_t s_binaryFormatFeatures = VSG::ALIGNED_PAYLOADS | VSG::CLASS_INDEX | VSG::CHILD_BOUNDS;
+static constexpr uint32_t s_asciiFormatFeatures = VSG::CHILD_BOUNDS;
+
 VSG::VSG() :
     _objectFactory(ObjectFactory::instance())
 {
@@ -50,10 +130,19 @@ VSG::VSG() :
 
 VSG::FormatInfo VSG::readHeader(std::istream& fin) const
 {
+    uint32_t formatFeatures = NO_FORMAT_FEATURES;
+    return readHeader(fin, formatFeatures);
+}
+
+VSG::FormatInfo VSG::readHeader(std::istream& fin, uint32_t& formatFeatures) const
+{
+    formatFeatures = NO_FORMAT_FEATURES;
+
     fin.imbue(s_class_locale);
 
     const char* match_token_ascii = "#vsga";
     const char* match_token_binary = "#vsgb";
+    const char* match_token_binary_compressed = "#vsgz";
     char read_token[5];
     fin.read(read_token, 5);
 
@@ -62,6 +151,8 @@ VSG::FormatInfo VSG::readHeader(std::istream& fin) const
         type = ASCII;
     else if (std::strncmp(match_token_binary, read_token, 5) == 0)
         type = BINARY;
+    else if (std::strncmp(match_token_binary_compressed, read_token, 5) == 0)
+        type = BINARY_COMPRESSED;
 
     if (type == NOT_RECOGNIZED)
     {
@@ -69,81 +160,285 @@ VSG::FormatInfo VSG::readHeader(std::istream& fin) const
         return FormatInfo(NOT_RECOGNIZED, VsgVersion{0, 0, 0, 0});
     }
 
+    std::string header_line;
+    std::getline(fin, header_line);
+
+    std::istringstream header_str(header_line);
     std::string version_string;
-    std::getline(fin, version_string);
+    header_str >> version_string;
 
     auto version = parseVersion(version_string);
 
+    std::string feature_name;
+    while (header_str >> feature_name)
+    {
+        auto itr = std::find_if(std::begin(s_formatFeatureNames), std::end(s_formatFeatureNames), [&](const auto& entry) { return feature_name == entry.first; });
+        if (itr == std::end(s_formatFeatureNames))
+        {
+            error("Header feature not supported [", feature_name, "]");
+            return FormatInfo(NOT_RECOGNIZED, version);
+        }
+        formatFeatures |= itr->second;
+    }
+
     return FormatInfo(type, version);
 }
 
-void VSG::writeHeader(std::ostream& fout, const FormatInfo& formatInfo) const
+void VSG::writeHeader(std::ostream& fout, const FormatInfo& formatInfo, uint32_t formatFeatures) const
 {
     if (formatInfo.first == NOT_RECOGNIZED) return;
 
     fout.imbue(s_class_locale);
     if (formatInfo.first == BINARY)
         fout << "#vsgb";
+    else if (formatInfo.first == BINARY_COMPRESSED)
+        fout << "#vsgz";
     else
         fout << "#vsga";
 
     auto version = formatInfo.second;
-    fout << " " << version.major << "." << version.minor << "." << version.patch << "\n";
+    fout << " " << version.major << "." << version.minor << "." << version.patch;
+
+    for (auto& [name, feature] : s_formatFeatureNames)
+    {
+        if ((formatFeatures & feature) != 0) fout << " " << name;
+    }
+    fout << "\n";
 }
 
-vsg::ref_ptr<vsg::Object> VSG::read(const vsg::Path& filename, ref_ptr<const Options> options) const
+vsg::ref_ptr<vsg::Object> VSG::_read(std::istream& fin, const vsg::Path& filename, vsg::ref_ptr<const vsg::Options> options) const
 {
-    CPU_INSTRUMENTATION_L1_NC(options ? options->instrumentation.get() : nullptr, "VSG read", COLOR_READ);
-
-    if (!compatibleExtension(filename, options, ".vsgb", ".vsgt")) return {};
-
-    vsg::Path filenameToUse = findFile(filename, options);
-    if (!filenameToUse) return {};
-
-    std::ifstream fin(filenameToUse, std::ios::in | std::ios::binary);
-    if (!fin) return {};
-
-    auto [type, version] = readHeader(fin);
+    uint32_t formatFeatures = NO_FORMAT_FEATURES;
+    auto [type, version] = readHeader(fin, formatFeatures);
     if (type == BINARY)
     {
         vsg::BinaryInput input(fin, _objectFactory, options);
-        input.filename = filenameToUse;
+        input.filename = filename;
         input.version = version;
-        return input.readObject("Root");
+        input.formatFeatures = formatFeatures;
+        return readRootObject(input);
     }
     else if (type == ASCII)
     {
         vsg::AsciiInput input(fin, _objectFactory, options);
-        input.filename = filenameToUse;
+        input.filename = filename;
         input.version = version;
-        return input.readObject("Root");
+        input.formatFeatures = formatFeatures;
+        return readRootObject(input);
+    }
+    else if (type == BINARY_COMPRESSED)
+    {
+        return _readCompressed(fin, filename, version, formatFeatures, options);
     }
 
     // return null as no means for loading file has been found
     return {};
 }
 
-vsg::ref_ptr<vsg::Object> VSG::read(std::istream& fin, vsg::ref_ptr<const vsg::Options> options) const
+vsg::ref_ptr<vsg::Object> VSG::_readCompressed(std::istream& fin, const vsg::Path& filename, const VsgVersion& version, uint32_t formatFeatures, vsg::ref_ptr<const vsg::Options> options) const
+{
+    // the sizes in the block index are checked against the bytes remaining in the stream before allocating any buffers
+    auto position = fin.tellg();
+    fin.seekg(0, std::ios::end);
+    auto endPosition = fin.tellg();
+    fin.seekg(position);
+    if (!fin || position < 0 || endPosition < position)
+    {
+        error("VSG: unable to determine size of compressed data in ", filename);
+        return {};
+    }
+    uint64_t remaining = static_cast<uint64_t>(endPosition - position);
+
+    // block index
+    uint32_t blockSize = 0;
+    uint64_t size = 0;
+    uint32_t numBlocks = 0;
+    fin.read(reinterpret_cast<char*>(&blockSize), sizeof(blockSize));
+    fin.read(reinterpret_cast<char*>(&size), sizeof(size));
+    fin.read(reinterpret_cast<char*>(&numBlocks), sizeof(numBlocks));
+
+    const uint64_t indexHeaderSize = sizeof(blockSize) + sizeof(size) + sizeof(numBlocks);
+    if (!fin || blockSize == 0 || numBlocks != (size + blockSize - 1) / blockSize || remaining < indexHeaderSize || numBlocks > (remaining - indexHeaderSize) / sizeof(uint32_t))
+    {
+        error("VSG: invalid compressed block index in ", filename);
+        return {};
+    }
+    remaining -= indexHeaderSize + uint64_t(numBlocks) * sizeof(uint32_t);
+
+    std::vector<uint32_t> compressedSizes(numBlocks);
+    fin.read(reinterpret_cast<char*>(compressedSizes.data()), numBlocks * sizeof(uint32_t));
+    if (!fin)
+    {
+        error("VSG: compressed block index truncated in ", filename);
+        return {};
+    }
+
+    // offsets of the blocks in the compressed data, a block with a compressed size equal to its uncompressed size is stored uncompressed
+    std::vector<size_t> offsets(numBlocks + 1, 0);
+    for (uint32_t i = 0; i < numBlocks; ++i)
+    {
+        size_t uncompressedSize = static_cast<size_t>(std::min(uint64_t(blockSize), size - uint64_t(i) * blockSize));
+        if (compressedSizes[i] > uncompressedSize || uncompressedSize > lz_decompressBound(compressedSizes[i]))
+        {
+            error("VSG: invalid compressed block size in ", filename);
+            return {};
+        }
+        offsets[i + 1] = offsets[i] + compressedSizes[i];
+    }
+
+    // as each block's uncompressed size is bounded by its compressed size, checking the total compressed size also bounds the uncompressed size
+    if (offsets.back() > remaining)
+    {
+        error("VSG: compressed data truncated in ", filename);
+        return {};
+    }
+
+    std::vector<uint8_t> compressed(offsets.back());
+    fin.read(reinterpret_cast<char*>(compressed.data()), static_cast<std::streamsize>(compressed.size()));
+    if (!fin)
+    {
+        error("VSG: compressed data truncated in ", filename);
+        return {};
+    }
+
+    std::vector<uint8_t> data(static_cast<size_t>(size));
+    std::atomic_bool valid(true);
+    forEachBlock(numBlocks, options.get(), [&](uint32_t i) {
+        size_t offset = size_t(i) * blockSize;
+        size_t uncompressedSize = std::min(size_t(blockSize), data.size() - offset);
+        const uint8_t* src = compressed.data() + offsets[i];
+        if (compressedSizes[i] == uncompressedSize)
+            std::memcpy(data.data() + offset, src, uncompressedSize);
+        else if (!lz_decompress(src, compressedSizes[i], data.data() + offset, uncompressedSize))
+            valid = false;
+    });
+
+    if (!valid)
+    {
+        error("VSG: corrupt compressed block in ", filename);
+        return {};
+    }
+
+    // release the compressed data before reading the scene graph
+    std::vector<uint8_t>().swap(compressed);
+
+    mem_stream data_fin(data.data(), data.size());
+    vsg::BinaryInput input(data_fin, _objectFactory, options);
+    input.filename = filename;
+    input.version = version;
+    input.formatFeatures = formatFeatures;
+    return readRootObject(input);
+}
+
+bool VSG::_writeCompressed(const vsg::Object* object, std::ostream& fout, const VsgVersion& version, vsg::ref_ptr<const vsg::Options> options) const
+{
+    // write the binary stream to memory so it can be split into blocks
+    std::ostringstream str(std::ios::out | std::ios::binary);
+    {
+        vsg::BinaryOutput output(str, options);
+        output.version = version;
+        output.formatFeatures = s_binaryFormatFeatures;
+        output.writeObject("Root", object);
+    }
+    std::string data = str.str();
+    str.str({});
+
+    uint32_t blockSize = 262144;
+    if (options) options->getValue(VSG::compress_block_size, blockSize);
+    if (blockSize == 0) blockSize = 262144;
+
+    uint64_t size = data.size();
+    uint32_t numBlocks = static_cast<uint32_t>((size + blockSize - 1) / blockSize);
+
+    // compress each block, falling back to storing the block uncompressed when compression doesn't reduce its size
+    std::vector<std::vector<uint8_t>> blocks(numBlocks);
+    std::vector<uint32_t> compressedSizes(numBlocks);
+    forEachBlock(numBlocks, options.get(), [&](uint32_t i) {
+        size_t offset = size_t(i) * blockSize;
+        size_t uncompressedSize = std::min(size_t(blockSize), data.size() - offset);
+        const uint8_t* src = reinterpret_cast<const uint8_t*>(data.data()) + offset;
+
+        auto& block = blocks[i];
+        block.resize(uncompressedSize);
+        size_t compressedSize = lz_compress(src, uncompressedSize, block.data(), uncompressedSize - 1);
+        if (compressedSize > 0)
+            block.resize(compressedSize);
+        else
+            std::memcpy(block.data(), src, uncompressedSize);
+
+        compressedSizes[i] = static_cast<uint32_t>(block.size());
+    });
+
+    writeHeader(fout, FormatInfo{BINARY_COMPRESSED, version}, s_binaryFormatFeatures);
+
+    fout.write(reinterpret_cast<const char*>(&blockSize), sizeof(blockSize));
+    fout.write(reinterpret_cast<const char*>(&size), sizeof(size));
+    fout.write(reinterpret_cast<const char*>(&numBlocks), sizeof(numBlocks));
+    fout.write(reinterpret_cast<const char*>(compressedSizes.data()), numBlocks * sizeof(uint32_t));
+
+    for (auto& block : blocks)
+    {
+        fout.write(reinterpret_cast<const char*>(block.data()), static_cast<std::streamsize>(block.size()));
+    }
+
+    return fout.good();
+}
+
+vsg::ref_ptr<vsg::Object> VSG::read(const vsg::Path& filename, ref_ptr<const Options> options) const
 {
     CPU_INSTRUMENTATION_L1_NC(options ? options->instrumentation.get() : nullptr, "VSG read", COLOR_READ);
 
-    if (options && !compatibleExtension(options, ".vsgb", ".vsgt")) return {};
+    if (!compatibleExtension(filename, options, ".vsgb", ".vsgt")) return {};
 
-    auto [type, version] = readHeader(fin);
-    if (type == BINARY)
+    vsg::Path filenameToUse = findFile(filename, options);
+    if (!filenameToUse) return {};
+
+    bool memoryMap = false;
+    if (options && options->getValue(VSG::memory_map, memoryMap) && memoryMap && lowerCaseFileExtension(filenameToUse) == ".vsgb")
     {
-        vsg::BinaryInput input(fin, _objectFactory, options);
-        input.version = version;
-        return input.readObject("Root");
+        // reference large data payloads directly from the mapped file, falling back to a conventional read if the file can't be mapped
+        auto mappedFile = MappedFile::create(filenameToUse);
+        if (mappedFile->valid())
+        {
+            mem_stream fin(mappedFile->data(), mappedFile->size());
+
+            uint32_t formatFeatures = NO_FORMAT_FEATURES;
+            auto [type, version] = readHeader(fin, formatFeatures);
+            if (type == BINARY_COMPRESSED) return _readCompressed(fin, filenameToUse, version, formatFeatures, options);
+            if (type != BINARY) return {};
+
+            vsg::BinaryInput input(fin, _objectFactory, options);
+            input.filename = filenameToUse;
+            input.version = version;
+            input.formatFeatures = formatFeatures;
+            input.mappedFile = mappedFile;
+            return readRootObject(input);
+        }
     }
-    else if (type == ASCII)
+
+    if (options && options->fileReader)
     {
-        vsg::AsciiInput input(fin, _objectFactory, options);
-        input.version = version;
-        return input.readObject("Root");
+        // load the whole file with the FileReader and parse it from memory
+        std::vector<uint8_t> buffer;
+        if (!options->fileReader->read(filenameToUse, buffer)) return {};
+
+        mem_stream fin(buffer.data(), buffer.size());
+        return _read(fin, filenameToUse, options);
     }
 
-    return {};
+    std::ifstream fin(filenameToUse, std::ios::in | std::ios::binary);
+    if (!fin) return {};
+
+    return _read(fin, filenameToUse, options);
+}
+
+vsg::ref_ptr<vsg::Object> VSG::read(std::istream& fin, vsg::ref_ptr<const vsg::Options> options) const
+{
+    CPU_INSTRUMENTATION_L1_NC(options ? options->instrumentation.get() : nullptr, "VSG read", COLOR_READ);
+
+    if (options && !compatibleExtension(options, ".vsgb", ".vsgt")) return {};
+
+    return _read(fin, {}, options);
 }
 
 vsg::ref_ptr<vsg::Object> VSG::read(const uint8_t* ptr, size_t size, vsg::ref_ptr<const vsg::Options> options) const
@@ -171,24 +466,34 @@ bool VSG::write(const vsg::Object* object, const vsg::Path& filename, ref_ptr<co
         }
     }
 
+    bool compressed = false;
+    if (options) options->getValue(VSG::compress, compressed);
+
     auto ext = vsg::lowerCaseFileExtension(filename);
-    if (ext == ".vsgb")
+    if (ext == ".vsgb" && compressed)
+    {
+        std::ofstream fout(filename, std::ios::out | std::ios::binary);
+        return _writeCompressed(object, fout, version, options);
+    }
+    else if (ext == ".vsgb")
     {
         std::ofstream fout(filename, std::ios::out | std::ios::binary);
-        writeHeader(fout, FormatInfo{BINARY, version});
+        writeHeader(fout, FormatInfo{BINARY, version}, s_binaryFormatFeatures);
 
         vsg::BinaryOutput output(fout, options);
         output.version = version;
+        output.formatFeatures = s_binaryFormatFeatures;
         output.writeObject("Root", object);
         return true;
     }
     else if (ext == ".vsga" || ext == ".vsgt")
     {
         std::ofstream fout(filename);
-        writeHeader(fout, FormatInfo{ASCII, version});
+        writeHeader(fout, FormatInfo{ASCII, version}, s_asciiFormatFeatures);
 
         vsg::AsciiOutput output(fout, options);
         output.version = version;
+        output.formatFeatures = s_asciiFormatFeatures;
         output.writeObject("Root", object);
         return true;
     }
@@ -206,10 +511,12 @@ bool VSG::write(const vsg::Object* object, std::ostream& fout, ref_ptr<const Opt
 
     auto version = vsgGetVersion();
     bool asciiFormat = true;
+    bool compressed = false;
 
     if (options)
     {
         if (options->extensionHint && options->extensionHint == ".vsgb") asciiFormat = false;
+        options->getValue(VSG::compress, compressed);
 
         std::string version_string;
         if (options->getValue("version", version_string))
@@ -220,26 +527,44 @@ bool VSG::write(const vsg::Object* object, std::ostream& fout, ref_ptr<const Opt
 
     if (asciiFormat)
     {
-        writeHeader(fout, FormatInfo(ASCII, version));
+        writeHeader(fout, FormatInfo(ASCII, version), s_asciiFormatFeatures);
 
         vsg::AsciiOutput output(fout, options);
         output.version = version;
+        output.formatFeatures = s_asciiFormatFeatures;
         output.writeObject("Root", object);
         return true;
     }
+    else if (compressed)
+    {
+        return _writeCompressed(object, fout, version, options);
+    }
     else
     {
-        writeHeader(fout, FormatInfo(BINARY, version));
+        writeHeader(fout, FormatInfo(BINARY, version), s_binaryFormatFeatures);
 
         vsg::BinaryOutput output(fout, options);
         output.version = version;
+        output.formatFeatures = s_binaryFormatFeatures;
         output.writeObject("Root", object);
         return true;
     }
 }
 
+bool VSG::readOptions(Options& options, CommandLine& arguments) const
+{
+    bool result = arguments.readAndAssign<bool>(VSG::memory_map, &options);
+    result = arguments.readAndAssign<bool>(VSG::compress, &options) || result;
+    result = arguments.readAndAssign<uint32_t>(VSG::compress_block_size, &options) || result;
+    return result;
+}
+
 bool VSG::getFeatures(Features& features) const
 {
+    features.optionNameTypeMap[VSG::memory_map] = type_name<bool>();
+    features.optionNameTypeMap[VSG::compress] = type_name<bool>();
+    features.optionNameTypeMap[VSG::compress_block_size] = type_name<uint32_t>();
+
     features.extensionFeatureMap[".vsgb"] = static_cast<FeatureMask>(READ_FILENAME | READ_ISTREAM | READ_MEMORY | WRITE_FILENAME | WRITE_OSTREAM);
     features.extensionFeatureMap[".vsgt"] = static_cast<FeatureMask>(READ_FILENAME | READ_ISTREAM | READ_MEMORY | WRITE_FILENAME | WRITE_OSTREAM);
     return true;
@@ -0,0 +1,219 @@
+/* <editor-fold desc="MIT License">
+
+Copyright(c) 2024 Robert Osfield
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"), to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+</editor-fold> */
+
+#include <vsg/io/lz.h>
+
+#include <algorithm>
+#include <cstring>
+#include <vector>
+
+using namespace vsg;
+
+// Each sequence is a token byte, with the number of literals in the high nibble and the match length minus minMatch in the low nibble,
+// a nibble value of 15 is followed by extension bytes that are summed till a byte less than 255 is read.
+// The token is followed by the literals, then the match as a 16 bit little endian offset and the match length extension bytes.
+// The last sequence of a block contains just literals, the end of the input marks the end of the block.
+
+namespace
+{
+    constexpr size_t minMatch = 4;
+    constexpr size_t maxOffset = 65535;
+    constexpr uint32_t hashLog = 14;
+
+    inline uint32_t read32(const uint8_t* ptr)
+    {
+        uint32_t value;
+        std::memcpy(&value, ptr, sizeof(value));
+        return value;
+    }
+
+    inline uint32_t hash(uint32_t sequence, uint32_t tableLog)
+    {
+        return (sequence * 2654435761u) >> (32 - tableLog);
+    }
+
+    struct Writer
+    {
+        uint8_t* ptr;
+        uint8_t* end;
+
+        bool length(size_t value)
+        {
+            for (; value >= 255; value -= 255)
+            {
+                if (ptr == end) return false;
+                *(ptr++) = 255;
+            }
+            if (ptr == end) return false;
+            *(ptr++) = static_cast<uint8_t>(value);
+            return true;
+        }
+
+        bool sequence(const uint8_t* literals, size_t numLiterals, size_t offset, size_t matchLength)
+        {
+            if (ptr == end) return false;
+
+            size_t matchCode = matchLength > 0 ? matchLength - minMatch : 0;
+            *(ptr++) = static_cast<uint8_t>(((numLiterals < 15 ? numLiterals : 15) << 4) | (matchCode < 15 ? matchCode : 15));
+            if (numLiterals >= 15 && !length(numLiterals - 15)) return false;
+
+            if (static_cast<size_t>(end - ptr) < numLiterals) return false;
+            if (numLiterals > 0) std::memcpy(ptr, literals, numLiterals);
+            ptr += numLiterals;
+
+            if (matchLength == 0) return true;
+
+            if (end - ptr < 2) return false;
+            *(ptr++) = static_cast<uint8_t>(offset & 0xff);
+            *(ptr++) = static_cast<uint8_t>(offset >> 8);
+            return matchCode < 15 || length(matchCode - 15);
+        }
+    };
+
+    // copy in 16 byte chunks which may write up to 15 bytes past dst + size, so only use when the destination has room for the overrun
+    inline void wildCopy(uint8_t* dst, const uint8_t* src, size_t size)
+    {
+        uint8_t* end = dst + size;
+        do
+        {
+            std::memcpy(dst, src, 16);
+            dst += 16;
+            src += 16;
+        } while (dst < end);
+    }
+
+    bool readLength(const uint8_t*& ptr, const uint8_t* end, size_t& value)
+    {
+        uint8_t byte;
+        do
+        {
+            if (ptr == end) return false;
+            byte = *(ptr++);
+            value += byte;
+        } while (byte == 255);
+        return true;
+    }
+} // namespace
+
+size_t vsg::lz_compressBound(size_t srcSize)
+{
+    return srcSize + srcSize / 255 + 16;
+}
+
+size_t vsg::lz_decompressBound(size_t srcSize)
+{
+    // a match costs at least the token and 16 bit offset, and each length extension byte adds at most 255 bytes of output
+    return srcSize * 255;
+}
+
+size_t vsg::lz_compress(const uint8_t* src, size_t srcSize, uint8_t* dst, size_t dstCapacity)
+{
+    Writer writer{dst, dst + dstCapacity};
+
+    // positions of the most recent occurrence of each hashed 4 byte sequence, sized to the input so that small blocks don't pay for clearing a large table
+    uint32_t tableLog = 8;
+    while (tableLog < hashLog && (size_t(1) << tableLog) < srcSize) ++tableLog;
+    std::vector<uint32_t> table(size_t(1) << tableLog, 0);
+
+    size_t anchor = 0;
+    size_t pos = 1;
+    while (pos + minMatch <= srcSize)
+    {
+        uint32_t sequence = read32(src + pos);
+        uint32_t& entry = table[hash(sequence, tableLog)];
+        size_t candidate = entry;
+        entry = static_cast<uint32_t>(pos);
+
+        if (pos - candidate > maxOffset || read32(src + candidate) != sequence)
+        {
+            // step further the longer no match has been found so that incompressible data is skipped over quickly
+            pos += 1 + ((pos - anchor) >> 6);
+            continue;
+        }
+
+        size_t length = minMatch;
+        while (pos + length + sizeof(uint32_t) <= srcSize && read32(src + candidate + length) == read32(src + pos + length)) length += sizeof(uint32_t);
+        while (pos + length < srcSize && src[candidate + length] == src[pos + length]) ++length;
+
+        // extend the match backwards into the pending literals
+        while (pos > anchor && candidate > 0 && src[pos - 1] == src[candidate - 1])
+        {
+            --pos;
+            --candidate;
+            ++length;
+        }
+
+        if (!writer.sequence(src + anchor, pos - anchor, pos - candidate, length)) return 0;
+
+        pos += length;
+        anchor = pos;
+    }
+
+    if (!writer.sequence(src + anchor, srcSize - anchor, 0, 0)) return 0;
+
+    return static_cast<size_t>(writer.ptr - dst);
+}
+
+bool vsg::lz_decompress(const uint8_t* src, size_t srcSize, uint8_t* dst, size_t dstSize)
+{
+    const uint8_t* ptr = src;
+    const uint8_t* end = src + srcSize;
+    uint8_t* out = dst;
+    uint8_t* out_end = dst + dstSize;
+
+    while (ptr < end)
+    {
+        uint8_t token = *(ptr++);
+
+        size_t numLiterals = token >> 4;
+        if (numLiterals == 15 && !readLength(ptr, end, numLiterals)) return false;
+        if (static_cast<size_t>(end - ptr) < numLiterals || static_cast<size_t>(out_end - out) < numLiterals) return false;
+
+        if (static_cast<size_t>(end - ptr) >= numLiterals + 16 && static_cast<size_t>(out_end - out) >= numLiterals + 16)
+            wildCopy(out, ptr, numLiterals);
+        else if (numLiterals > 0)
+            std::memcpy(out, ptr, numLiterals);
+        ptr += numLiterals;
+        out += numLiterals;
+
+        // last sequence only has literals
+        if (ptr == end) break;
+
+        if (end - ptr < 2) return false;
+        size_t offset = size_t(ptr[0]) | (size_t(ptr[1]) << 8);
+        ptr += 2;
+
+        size_t length = token & 15;
+        if (length == 15 && !readLength(ptr, end, length)) return false;
+        length += minMatch;
+
+        if (offset == 0 || offset > static_cast<size_t>(out - dst) || static_cast<size_t>(out_end - out) < length) return false;
+
+        // an overlapping match repeats the pattern of the last offset bytes, so copy in non overlapping chunks that double in size each iteration
+        const uint8_t* match = out - offset;
+        if (offset >= 16 && static_cast<size_t>(out_end - out) >= length + 16)
+        {
+            wildCopy(out, match, length);
+            out += length;
+            continue;
+        }
+        while (length > 0)
+        {
+            size_t chunk = std::min(length, static_cast<size_t>(out - match));
+            std::memcpy(out, match, chunk);
+            out += chunk;
+            length -= chunk;
+        }
+    }
+
+    return out == out_end;
+}
@@ -41,3 +41,24 @@ mem_stream::mem_buffer::mem_buffer(const uint8_t* ptr, size_t length)
 {
     setg((char*)(ptr), (char*)(ptr), (char*)(ptr) + length);
 }
+
+mem_stream::mem_buffer::pos_type mem_stream::mem_buffer::seekoff(off_type off, std::ios_base::seekdir dir, std::ios_base::openmode which)
+{
+    if ((which & std::ios_base::in) == 0) return pos_type(off_type(-1));
+
+    off_type position = off;
+    if (dir == std::ios_base::cur)
+        position += gptr() - eback();
+    else if (dir == std::ios_base::end)
+        position += egptr() - eback();
+
+    if (position < 0 || position > (egptr() - eback())) return pos_type(off_type(-1));
+
+    setg(eback(), eback() + position, egptr());
+    return pos_type(position);
+}
+
+mem_stream::mem_buffer::pos_type mem_stream::mem_buffer::seekpos(pos_type pos, std::ios_base::openmode which)
+{
+    return seekoff(off_type(pos), std::ios_base::beg, which);
+}
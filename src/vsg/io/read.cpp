@@ -16,6 +16,7 @@ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLI
 #include <vsg/io/spirv.h>
 #include <vsg/io/tile.h>
 #include <vsg/io/txt.h>
+#include <vsg/threading/ActivityStatus.h>
 #include <vsg/threading/OperationThreads.h>
 #include <vsg/utils/FindDynamicObjects.h>
 #include <vsg/utils/PropagateDynamicObjects.h>
@@ -91,6 +92,13 @@ ref_ptr<Object> vsg::read(const Path& filename, ref_ptr<const Options> options)
             }
         });
 
+        // don't keep the ReadError of a cancelled read so that later reads of the file aren't given it
+        if (options->activityStatus && options->activityStatus->cancel() && loadedObject->object.cast<ReadError>())
+        {
+            options->sharedObjects->remove(filename, options);
+            return loadedObject->object;
+        }
+
         if (!loadedObject->dynamicObjects.empty())
         {
             vsg::CopyOp copyop;
@@ -16,6 +16,7 @@ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLI
 #include <vsg/vk/State.h>
 
 #include <algorithm>
+#include <limits>
 
 using namespace vsg;
 
@@ -107,6 +108,28 @@ void Bin::add(State* state, double value, const Node* node)
     _elements.push_back(element);
 }
 
+void Bin::add(const Bin& rhs)
+{
+    auto matrixOffset = static_cast<uint32_t>(_matrices.size());
+    auto stateCommandOffset = static_cast<uint32_t>(_stateCommands.size());
+    auto elementOffset = static_cast<uint32_t>(_elements.size());
+
+    _matrices.insert(_matrices.end(), rhs._matrices.begin(), rhs._matrices.end());
+    _stateCommands.insert(_stateCommands.end(), rhs._stateCommands.begin(), rhs._stateCommands.end());
+
+    for (auto element : rhs._elements)
+    {
+        element.matrixIndex += matrixOffset;
+        element.stateCommandIndex += stateCommandOffset;
+        _elements.push_back(element);
+    }
+
+    for (auto& keyElement : rhs._binElements)
+    {
+        _binElements.emplace_back(keyElement.first, keyElement.second + elementOffset);
+    }
+}
+
 void Bin::traverse(RecordTraversal& rt) const
 {
     //debug("Bin::traverse(RecordTraversal& visitor) ", sortOrder, " ", _binElements.size());
@@ -121,6 +144,9 @@ void Bin::traverse(RecordTraversal& rt) const
     case (DESCENDING):
         std::sort(_binElements.begin(), _binElements.end(), [](const KeyIndex& lhs, const KeyIndex& rhs) { return rhs.first < lhs.first; });
         break;
+    case (STATE_SORT):
+        _sortByState();
+        break;
     case (NO_SORT):
         break;
     }
@@ -175,6 +201,70 @@ void Bin::traverse(RecordTraversal& rt) const
     state->dirty = true;
 }
 
+void Bin::_sortByState() const
+{
+    // the key is packed as { slot 0 : 16 bits, slot 1 : 12 bits, slot 2 : 12 bits, value : 24 bits }
+    // with the StateCommand for each slot mapped to its index in the sorted list of unique StateCommand used in that slot in the bin.
+    constexpr uint32_t numSlots = numStateSortSlots;
+    constexpr uint32_t slotBits[numSlots] = {16, 12, 12};
+    constexpr uint32_t valueBits = 24;
+
+    for (auto& sortedStateCommands : _sortedStateCommands) sortedStateCommands.clear();
+    for (auto& element : _elements)
+    {
+        uint32_t endIndex = element.stateCommandIndex + element.stateCommandCount;
+        for (uint32_t i = element.stateCommandIndex; i < endIndex; ++i)
+        {
+            auto command = _stateCommands[i];
+            if (command->slot < numSlots) _sortedStateCommands[command->slot].push_back(command);
+        }
+    }
+    for (auto& sortedStateCommands : _sortedStateCommands)
+    {
+        std::sort(sortedStateCommands.begin(), sortedStateCommands.end());
+        sortedStateCommands.erase(std::unique(sortedStateCommands.begin(), sortedStateCommands.end()), sortedStateCommands.end());
+    }
+
+    float minValue = std::numeric_limits<float>::max();
+    float maxValue = std::numeric_limits<float>::lowest();
+    for (auto& keyElement : _binElements)
+    {
+        minValue = std::min(minValue, keyElement.first);
+        maxValue = std::max(maxValue, keyElement.first);
+    }
+    const uint64_t maxValueKey = (uint64_t(1) << valueBits) - 1;
+    double valueScale = (maxValue > minValue) ? static_cast<double>(maxValueKey) / (static_cast<double>(maxValue) - static_cast<double>(minValue)) : 0.0;
+
+    _stateSortKeys.resize(_elements.size());
+    for (auto& keyElement : _binElements)
+    {
+        auto& element = _elements[keyElement.second];
+
+        uint64_t key = 0;
+        uint32_t endIndex = element.stateCommandIndex + element.stateCommandCount;
+        for (uint32_t i = element.stateCommandIndex; i < endIndex; ++i)
+        {
+            auto command = _stateCommands[i];
+            if (command->slot >= numSlots) continue;
+
+            uint32_t shift = 64;
+            for (uint32_t slot = 0; slot <= command->slot; ++slot) shift -= slotBits[slot];
+
+            // index 0 is reserved for no StateCommand assigned to the slot, saturating the index if there are too many StateCommand to fit.
+            uint64_t maxIndex = (uint64_t(1) << slotBits[command->slot]) - 1;
+            auto& sortedStateCommands = _sortedStateCommands[command->slot];
+            uint64_t index = static_cast<uint64_t>(std::lower_bound(sortedStateCommands.begin(), sortedStateCommands.end(), command) - sortedStateCommands.begin()) + 1;
+            key |= std::min(index, maxIndex) << shift;
+        }
+
+        key |= std::min(static_cast<uint64_t>((static_cast<double>(keyElement.first) - static_cast<double>(minValue)) * valueScale), maxValueKey);
+
+        _stateSortKeys[keyElement.second] = key;
+    }
+
+    std::sort(_binElements.begin(), _binElements.end(), [this](const KeyIndex& lhs, const KeyIndex& rhs) { return _stateSortKeys[lhs.second] < _stateSortKeys[rhs.second]; });
+}
+
 void Bin::read(Input& input)
 {
     Node::read(input);
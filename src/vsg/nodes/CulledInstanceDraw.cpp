@@ -0,0 +1,476 @@
+/* <editor-fold desc="MIT License">
+
+Copyright(c) 2024 Robert Osfield
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"), to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+</editor-fold> */
+
+#include <vsg/commands/BindIndexBuffer.h>
+#include <vsg/commands/DrawIndexedIndirectCommand.h>
+#include <vsg/io/Logger.h>
+#include <vsg/io/Options.h>
+#include <vsg/nodes/CulledInstanceDraw.h>
+#include <vsg/state/DescriptorBuffer.h>
+#include <vsg/ui/FrameStamp.h>
+#include <vsg/vk/Context.h>
+#include <vsg/vk/State.h>
+
+#include <cstring>
+#include <limits>
+
+using namespace vsg;
+
+const char* CulledInstanceDraw::cullShaderSource()
+{
+    return R"(
+#version 450
+
+layout(local_size_x = 64) in;
+
+struct DrawIndexedIndirectCommand
+{
+    uint indexCount;
+    uint instanceCount;
+    uint firstIndex;
+    int vertexOffset;
+    uint firstInstance;
+};
+
+layout(std430, set = 0, binding = 0) readonly buffer InstanceBounds { vec4 bounds[]; };
+layout(std430, set = 0, binding = 1) readonly buffer InstanceTransforms { mat4 transforms[]; };
+layout(std430, set = 0, binding = 2) readonly buffer Levels { uvec4 levels[]; };
+layout(std430, set = 1, binding = 0) readonly buffer Parameters { vec4 parameters[]; };
+layout(std430, set = 1, binding = 1) writeonly buffer DrawCommands { DrawIndexedIndirectCommand drawCommands[]; };
+layout(std430, set = 1, binding = 2) buffer DrawCount { uint drawCount; };
+
+void main()
+{
+    uint instance = gl_GlobalInvocationID.x;
+    if (instance >= uint(bounds.length())) return;
+
+    // transform the bounding sphere into the local coordinate frame of the CulledInstanceDraw
+    mat4 m = transforms[instance];
+    vec4 bound = bounds[instance];
+    vec3 center = (m * vec4(bound.xyz, 1.0)).xyz;
+    float radius = bound.w * sqrt(max(max(dot(m[0].xyz, m[0].xyz), dot(m[1].xyz, m[1].xyz)), dot(m[2].xyz, m[2].xyz)));
+
+    // view frustum planes followed by the lodScale
+    int numPlanes = parameters.length() - 1;
+    for (int i = 0; i < numPlanes; ++i)
+    {
+        if (dot(parameters[i].xyz, center) + parameters[i].w < -radius) return;
+    }
+
+    vec4 lodScale = parameters[numPlanes];
+    float lodDistance = abs(dot(lodScale.xyz, center) + lodScale.w);
+
+    for (int i = 0; i < levels.length(); ++i)
+    {
+        uvec4 level = levels[i];
+        if (radius > lodDistance * uintBitsToFloat(level.w))
+        {
+            uint index = atomicAdd(drawCount, 1);
+            drawCommands[index].indexCount = level.x;
+            drawCommands[index].instanceCount = 1;
+            drawCommands[index].firstIndex = level.y;
+            drawCommands[index].vertexOffset = int(level.z);
+            drawCommands[index].firstInstance = instance;
+            return;
+        }
+    }
+}
+)";
+}
+
+CulledInstanceDraw::CulledInstanceDraw() :
+    instanceBounds(BufferInfo::create()),
+    instanceTransforms(BufferInfo::create()),
+    _levels(BufferInfo::create())
+{
+    auto storageBufferBindings = []() {
+        DescriptorSetLayoutBindings bindings;
+        for (uint32_t binding = 0; binding < 3; ++binding)
+        {
+            bindings.push_back(VkDescriptorSetLayoutBinding{binding, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, 1, VK_SHADER_STAGE_COMPUTE_BIT, nullptr});
+        }
+        return bindings;
+    };
+
+    // set 0 is shared by all Views, set 1 with the frustum parameters and draw buffers is assigned per View by compile()
+    Descriptors descriptors;
+    uint32_t binding = 0;
+    for (auto& bufferInfo : {instanceBounds, instanceTransforms, _levels})
+    {
+        descriptors.push_back(DescriptorBuffer::create(BufferInfoList{bufferInfo}, binding++, 0, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER));
+    }
+
+    auto descriptorSetLayout = DescriptorSetLayout::create(storageBufferBindings());
+    _viewDescriptorSetLayout = DescriptorSetLayout::create(storageBufferBindings());
+
+    auto pipelineLayout = PipelineLayout::create(DescriptorSetLayouts{descriptorSetLayout, _viewDescriptorSetLayout}, PushConstantRanges{});
+    auto computeShader = ShaderStage::create(VK_SHADER_STAGE_COMPUTE_BIT, "main", cullShaderSource());
+
+    bindComputePipeline = BindComputePipeline::create(ComputePipeline::create(pipelineLayout, computeShader));
+    bindDescriptorSet = BindDescriptorSet::create(VK_PIPELINE_BIND_POINT_COMPUTE, pipelineLayout, 0, DescriptorSet::create(descriptorSetLayout, descriptors));
+
+    // wait for the View's previous culling and indirect draws to finish with the draw buffers before they are reset and overwritten
+    auto preCullMemoryBarrier = MemoryBarrier::create(VK_ACCESS_SHADER_WRITE_BIT, VK_ACCESS_TRANSFER_WRITE_BIT | VK_ACCESS_SHADER_READ_BIT | VK_ACCESS_SHADER_WRITE_BIT);
+    _preCullBarrier = PipelineBarrier::create(VK_PIPELINE_STAGE_DRAW_INDIRECT_BIT | VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, VK_PIPELINE_STAGE_TRANSFER_BIT | VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, 0, preCullMemoryBarrier);
+
+    // make the updated frustum parameters and reset draw count visible to the culling
+    auto transferMemoryBarrier = MemoryBarrier::create(VK_ACCESS_TRANSFER_WRITE_BIT, VK_ACCESS_SHADER_READ_BIT | VK_ACCESS_SHADER_WRITE_BIT);
+    _transferBarrier = PipelineBarrier::create(VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, 0, transferMemoryBarrier);
+
+    _dispatch = Dispatch::create(0, 1, 1);
+
+    // make the culling results visible to the indirect draw
+    auto postCullMemoryBarrier = MemoryBarrier::create(VK_ACCESS_SHADER_WRITE_BIT, VK_ACCESS_INDIRECT_COMMAND_READ_BIT);
+    _postCullBarrier = PipelineBarrier::create(VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, VK_PIPELINE_STAGE_DRAW_INDIRECT_BIT, 0, postCullMemoryBarrier);
+}
+
+CulledInstanceDraw::~CulledInstanceDraw()
+{
+}
+
+void CulledInstanceDraw::assignArrays(const DataList& arrayData)
+{
+    arrays.clear();
+    arrays.reserve(arrayData.size());
+    for (auto& data : arrayData)
+    {
+        arrays.push_back(BufferInfo::create(data));
+    }
+}
+
+void CulledInstanceDraw::assignIndices(ref_ptr<vsg::Data> indexData)
+{
+    if (indexData)
+    {
+        indices = BufferInfo::create(indexData);
+        _indexType = computeIndexType(indices->data);
+    }
+    else
+    {
+        indices = {};
+    }
+}
+
+void CulledInstanceDraw::assignInstances(ref_ptr<vec4Array> in_bounds, ref_ptr<mat4Array> in_transforms)
+{
+    if (in_bounds && in_transforms && in_bounds->size() != in_transforms->size())
+    {
+        warn("CulledInstanceDraw::assignInstances(..) number of bounds ", in_bounds->size(), " does not match number of transforms ", in_transforms->size());
+    }
+
+    // the BufferInfo are shared with the DescriptorBuffer so assign the data rather than replace the BufferInfo.
+    instanceBounds->data = in_bounds;
+    instanceTransforms->data = in_transforms;
+}
+
+void CulledInstanceDraw::read(Input& input)
+{
+    _vulkanData.clear();
+
+    Command::read(input);
+
+    input.read("firstBinding", firstBinding);
+
+    DataList dataList;
+    dataList.resize(input.readValue<uint32_t>("NumArrays"));
+    for (auto& array : dataList)
+    {
+        input.readObject("Array", array);
+    }
+    assignArrays(dataList);
+
+    ref_ptr<vsg::Data> indices_data;
+    input.readObject("Indices", indices_data);
+    assignIndices(indices_data);
+
+    levels.resize(input.readValue<uint32_t>("NumLevels"));
+    for (auto& level : levels)
+    {
+        input.read("indexCount", level.indexCount);
+        input.read("firstIndex", level.firstIndex);
+        input.read("vertexOffset", level.vertexOffset);
+        input.read("minimumScreenHeightRatio", level.minimumScreenHeightRatio);
+    }
+
+    auto bounds = input.readObject<vec4Array>("InstanceBounds");
+    auto transforms = input.readObject<mat4Array>("InstanceTransforms");
+    assignInstances(bounds, transforms);
+}
+
+void CulledInstanceDraw::write(Output& output) const
+{
+    Command::write(output);
+
+    output.write("firstBinding", firstBinding);
+    output.writeValue<uint32_t>("NumArrays", arrays.size());
+    for (auto& array : arrays)
+    {
+        if (array)
+            output.writeObject("Array", array->data.get());
+        else
+            output.writeObject("Array", nullptr);
+    }
+
+    if (indices)
+        output.writeObject("Indices", indices->data.get());
+    else
+        output.writeObject("Indices", nullptr);
+
+    output.writeValue<uint32_t>("NumLevels", levels.size());
+    for (auto& level : levels)
+    {
+        output.write("indexCount", level.indexCount);
+        output.write("firstIndex", level.firstIndex);
+        output.write("vertexOffset", level.vertexOffset);
+        output.write("minimumScreenHeightRatio", level.minimumScreenHeightRatio);
+    }
+
+    output.writeObject("InstanceBounds", instanceBounds->data.get());
+    output.writeObject("InstanceTransforms", instanceTransforms->data.get());
+}
+
+void CulledInstanceDraw::compile(Context& context)
+{
+    if (arrays.empty() || !indices || levels.empty() || !instanceBounds->data || !instanceTransforms->data)
+    {
+        // CulledInstanceDraw does not contain required arrays, indices, levels and instances
+        return;
+    }
+
+    auto deviceID = context.deviceID;
+    auto numInstances = static_cast<uint32_t>(instanceBounds->data->valueCount());
+
+    // pack the levels into uvec4 with the screen height ratio stored as the bits of the float, only replacing the levels data when the levels have changed
+    auto levelData = uivec4Array::create(static_cast<uint32_t>(levels.size()));
+    for (size_t i = 0; i < levels.size(); ++i)
+    {
+        auto& level = levels[i];
+        uint32_t ratio = 0;
+        std::memcpy(&ratio, &level.minimumScreenHeightRatio, sizeof(ratio));
+        levelData->set(i, uivec4(level.indexCount, level.firstIndex, static_cast<uint32_t>(level.vertexOffset), ratio));
+    }
+
+    if (!_levels->data || _levels->data->dataSize() != levelData->dataSize() || std::memcmp(_levels->data->dataPointer(), levelData->dataPointer(), levelData->dataSize()) != 0)
+    {
+        _levels->data = levelData;
+    }
+
+    // new buffers are created when the levels or instances are modified, so the shared descriptor set has to be recreated to refer to them
+    bool sharedBuffersChanged = false;
+    if (_levels->requiresCopy(deviceID))
+    {
+        createBufferAndTransferData(context, {_levels}, VK_BUFFER_USAGE_STORAGE_BUFFER_BIT, VK_SHARING_MODE_EXCLUSIVE);
+        sharedBuffersChanged = true;
+    }
+
+    if (instanceBounds->requiresCopy(deviceID) || instanceTransforms->requiresCopy(deviceID))
+    {
+        createBufferAndTransferData(context, {instanceBounds, instanceTransforms}, VK_BUFFER_USAGE_STORAGE_BUFFER_BIT, VK_SHARING_MODE_EXCLUSIVE);
+        sharedBuffersChanged = true;
+    }
+
+    bindComputePipeline->compile(context);
+
+    {
+        std::scoped_lock<std::mutex> lock(_dispatchMutex);
+
+        if (sharedBuffersChanged)
+        {
+            auto descriptorSet = bindDescriptorSet->descriptorSet;
+            bindDescriptorSet = BindDescriptorSet::create(VK_PIPELINE_BIND_POINT_COMPUTE, bindDescriptorSet->layout, 0, DescriptorSet::create(descriptorSet->setLayout, descriptorSet->descriptors));
+        }
+        bindDescriptorSet->compile(context);
+
+        if (numInstances != _numInstances)
+        {
+            // the per View draw buffers hold a draw command for every instance, so are recreated for the new number of instances when compiled for each View
+            for (auto& viewData : _viewData) viewData = {};
+
+            _numInstances = numInstances;
+            _dispatch->groupCountX = (numInstances + workgroupSize - 1) / workgroupSize;
+        }
+
+        if (context.viewID >= _viewData.size()) _viewData.resize(context.viewID + 1);
+
+        auto& viewData = _viewData[context.viewID];
+        if (!viewData.bindDescriptorSet)
+        {
+            // frustum parameters and draw count are updated by the View's culling CommandBuffer, the draw commands hold the worst case of every instance being visible
+            viewData.parameters = BufferInfo::create(vec4Array::create(POLYTOPE_SIZE + 1));
+            viewData.drawCommands = BufferInfo::create(DrawIndexedIndirectCommandArray::create(numInstances));
+            viewData.drawCount = BufferInfo::create(uintArray::create(1, 0u));
+
+            createBufferAndTransferData(context, {viewData.parameters}, VK_BUFFER_USAGE_STORAGE_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT, VK_SHARING_MODE_EXCLUSIVE);
+            createBufferAndTransferData(context, {viewData.drawCommands, viewData.drawCount}, VK_BUFFER_USAGE_STORAGE_BUFFER_BIT | VK_BUFFER_USAGE_INDIRECT_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT, VK_SHARING_MODE_EXCLUSIVE);
+
+            Descriptors descriptors;
+            uint32_t binding = 0;
+            for (auto& bufferInfo : {viewData.parameters, viewData.drawCommands, viewData.drawCount})
+            {
+                descriptors.push_back(DescriptorBuffer::create(BufferInfoList{bufferInfo}, binding++, 0, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER));
+            }
+            viewData.bindDescriptorSet = BindDescriptorSet::create(VK_PIPELINE_BIND_POINT_COMPUTE, bindComputePipeline->pipeline->layout, 1, DescriptorSet::create(_viewDescriptorSetLayout, descriptors));
+
+            viewData.drawIndexedIndirectCount = DrawIndexedIndirectCount::create();
+            viewData.drawIndexedIndirectCount->drawParameters = viewData.drawCommands;
+            viewData.drawIndexedIndirectCount->drawCount = viewData.drawCount;
+            viewData.drawIndexedIndirectCount->maxDrawCount = numInstances;
+            viewData.drawIndexedIndirectCount->stride = sizeof(VkDrawIndexedIndirectCommand);
+        }
+
+        viewData.bindDescriptorSet->compile(context);
+    }
+
+    bool requiresCreateAndCopy = indices->requiresCopy(deviceID);
+    for (auto& array : arrays)
+    {
+        if (array->requiresCopy(deviceID)) requiresCreateAndCopy = true;
+    }
+
+    if (requiresCreateAndCopy)
+    {
+        BufferInfoList combinedBufferInfos(arrays);
+        combinedBufferInfos.push_back(indices);
+        createBufferAndTransferData(context, combinedBufferInfos, VK_BUFFER_USAGE_VERTEX_BUFFER_BIT | VK_BUFFER_USAGE_INDEX_BUFFER_BIT, VK_SHARING_MODE_EXCLUSIVE);
+    }
+
+    assignVulkanArrayData(deviceID, arrays, _vulkanData[deviceID]);
+}
+
+void CulledInstanceDraw::dispatch(State& state, const FrameStamp* frameStamp, RecordedCommandBuffers& recordedCommandBuffers) const
+{
+    auto parentCommandBuffer = state._commandBuffer;
+    auto viewID = parentCommandBuffer->viewID;
+
+    std::scoped_lock<std::mutex> lock(_dispatchMutex);
+
+    if (_dispatch->groupCountX == 0) return;
+
+    // Views that haven't been compiled have no draw buffers, record() draws all their instances
+    if (viewID >= _viewData.size() || !_viewData[viewID].bindDescriptorSet) return;
+
+    // only cull once per frame for each View
+    auto& viewData = _viewData[viewID];
+    if (frameStamp)
+    {
+        if (viewData.dispatched && viewData.dispatchedFrameCount == frameStamp->frameCount)
+        {
+            // a further path to this CulledInstanceDraw in the same View, its frustum differs from the one culled against so draw all the instances
+            if (!viewData.drawAllInstances && !_multiplePathsReported)
+            {
+                warn("CulledInstanceDraw::dispatch(..) ", this, " has multiple paths in View ", viewID, ", only the first path is culled, the others draw all instances.");
+                _multiplePathsReported = true;
+            }
+            viewData.drawAllInstances = true;
+            return;
+        }
+        viewData.dispatchedFrameCount = frameStamp->frameCount;
+    }
+    viewData.dispatched = true;
+    viewData.drawAllInstances = false;
+
+    auto device = parentCommandBuffer->getDevice();
+    auto deviceID = parentCommandBuffer->deviceID;
+
+    ref_ptr<CommandBuffer> commandBuffer;
+    for (auto& cb : _commandBuffers)
+    {
+        if (cb->numDependentSubmissions() == 0 && cb->getDevice() == device)
+        {
+            commandBuffer = cb;
+            break;
+        }
+    }
+    if (!commandBuffer)
+    {
+        // each CommandBuffer has its own CommandPool as CommandBuffer::reset() resets the CommandPool.
+        auto commandPool = CommandPool::create(device, parentCommandBuffer->getCommandPool()->queueFamilyIndex);
+        commandBuffer = commandPool->allocate(VK_COMMAND_BUFFER_LEVEL_PRIMARY);
+        _commandBuffers.push_back(commandBuffer);
+    }
+    else
+    {
+        commandBuffer->reset();
+    }
+
+    commandBuffer->numDependentSubmissions().fetch_add(1);
+    commandBuffer->viewID = viewID;
+
+    // frustum planes and lodScale in the local coordinate frame, recorded into the CommandBuffer so that each View's culling uses its own frustum
+    const auto& frustum = state._frustumStack.top();
+    vec4 parameters[POLYTOPE_SIZE + 1];
+    for (size_t i = 0; i < POLYTOPE_SIZE; ++i)
+    {
+        const auto& face = frustum.face[i];
+        parameters[i] = vec4(static_cast<float>(face[0]), static_cast<float>(face[1]), static_cast<float>(face[2]), static_cast<float>(face[3]));
+    }
+    const auto& lodScale = frustum.lodScale;
+    parameters[POLYTOPE_SIZE] = vec4(static_cast<float>(lodScale[0]), static_cast<float>(lodScale[1]), static_cast<float>(lodScale[2]), static_cast<float>(lodScale[3]));
+
+    VkCommandBufferBeginInfo beginInfo = {};
+    beginInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
+    beginInfo.flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT;
+
+    VkCommandBuffer cmdBuffer{*commandBuffer};
+    vkBeginCommandBuffer(cmdBuffer, &beginInfo);
+
+    _preCullBarrier->record(*commandBuffer);
+
+    auto& parametersInfo = viewData.parameters;
+    auto& drawCountInfo = viewData.drawCount;
+    vkCmdUpdateBuffer(cmdBuffer, parametersInfo->buffer->vk(deviceID), parametersInfo->offset, sizeof(parameters), parameters);
+    vkCmdFillBuffer(cmdBuffer, drawCountInfo->buffer->vk(deviceID), drawCountInfo->offset, sizeof(uint32_t), 0);
+
+    _transferBarrier->record(*commandBuffer);
+    bindComputePipeline->record(*commandBuffer);
+    bindDescriptorSet->record(*commandBuffer);
+    viewData.bindDescriptorSet->record(*commandBuffer);
+    _dispatch->record(*commandBuffer);
+    _postCullBarrier->record(*commandBuffer);
+
+    vkEndCommandBuffer(cmdBuffer);
+
+    // submit ahead of all other CommandBuffers so the draw buffers are filled in before the render passes that draw them.
+    recordedCommandBuffers.add(std::numeric_limits<int>::min(), commandBuffer);
+}
+
+void CulledInstanceDraw::record(CommandBuffer& commandBuffer) const
+{
+    ref_ptr<DrawIndexedIndirectCount> drawIndexedIndirectCount;
+    uint32_t numInstances = 0;
+    {
+        std::scoped_lock<std::mutex> lock(_dispatchMutex);
+        numInstances = _numInstances;
+        if (commandBuffer.viewID < _viewData.size() && !_viewData[commandBuffer.viewID].drawAllInstances) drawIndexedIndirectCount = _viewData[commandBuffer.viewID].drawIndexedIndirectCount;
+    }
+
+    if (numInstances == 0) return;
+
+    auto& vkd = _vulkanData[commandBuffer.deviceID];
+
+    VkCommandBuffer cmdBuffer{commandBuffer};
+
+    vkCmdBindVertexBuffers(cmdBuffer, firstBinding, static_cast<uint32_t>(vkd.vkBuffers.size()), vkd.vkBuffers.data(), vkd.offsets.data());
+
+    vkCmdBindIndexBuffer(cmdBuffer, indices->buffer->vk(commandBuffer.deviceID), indices->offset, _indexType);
+
+    if (drawIndexedIndirectCount)
+    {
+        drawIndexedIndirectCount->record(commandBuffer);
+    }
+    else
+    {
+        // no culling results for this View, or for a further path in this View, so draw all the instances at the highest level of detail
+        const auto& level = levels.front();
+        vkCmdDrawIndexed(cmdBuffer, level.indexCount, numInstances, level.firstIndex, level.vertexOffset, 0);
+    }
+}
@@ -14,6 +14,7 @@ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLI
 #include <vsg/io/Input.h>
 #include <vsg/io/Options.h>
 #include <vsg/io/Output.h>
+#include <vsg/io/VSG.h>
 #include <vsg/nodes/Group.h>
 
 using namespace vsg;
@@ -25,7 +26,8 @@ Group::Group(size_t numChildren) :
 
 Group::Group(const Group& rhs, const CopyOp& copyop) :
     Inherit(rhs, copyop),
-    children(copyop(rhs.children))
+    children(copyop(rhs.children)),
+    childBounds(rhs.childBounds)
 {
 }
 
@@ -39,7 +41,8 @@ int Group::compare(const Object& rhs_object) const
     if (result != 0) return result;
 
     auto& rhs = static_cast<decltype(*this)>(rhs_object);
-    return compare_pointer_container(children, rhs.children);
+    if ((result = compare_pointer_container(children, rhs.children)) != 0) return result;
+    return compare_pointer(childBounds, rhs.childBounds);
 }
 
 void Group::read(Input& input)
@@ -47,6 +50,8 @@ void Group::read(Input& input)
     Node::read(input);
 
     input.readObjects("children", children);
+
+    if ((input.formatFeatures & VSG::CHILD_BOUNDS) != 0) input.read("childBounds", childBounds);
 }
 
 void Group::write(Output& output) const
@@ -54,4 +59,6 @@ void Group::write(Output& output) const
     Node::write(output);
 
     output.writeObjects("children", children);
+
+    if ((output.formatFeatures & VSG::CHILD_BOUNDS) != 0) output.write("childBounds", childBounds);
 }
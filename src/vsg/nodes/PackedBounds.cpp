@@ -0,0 +1,290 @@
+/* <editor-fold desc="MIT License">
+
+Copyright(c) 2024 Robert Osfield
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"), to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+</editor-fold> */
+
+#include <vsg/core/compare.h>
+#include <vsg/io/Input.h>
+#include <vsg/io/Output.h>
+#include <vsg/nodes/CullGroup.h>
+#include <vsg/nodes/CullNode.h>
+#include <vsg/nodes/DepthSorted.h>
+#include <vsg/nodes/LOD.h>
+#include <vsg/nodes/PackedBounds.h>
+#include <vsg/nodes/QuadGroup.h>
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+#if defined(__AVX__)
+#    include <immintrin.h>
+#    define VSG_PACKEDBOUNDS_AVX 1
+#elif defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#    include <emmintrin.h>
+#    define VSG_PACKEDBOUNDS_SSE 1
+#endif
+
+using namespace vsg;
+
+namespace
+{
+    // planes transformed to the PackedBounds origin and converted to float
+    struct FloatPlanes
+    {
+        size_t count = 0;
+        float nx[PackedBounds::maxNumPlanes];
+        float ny[PackedBounds::maxNumPlanes];
+        float nz[PackedBounds::maxNumPlanes];
+        float p[PackedBounds::maxNumPlanes];
+
+        FloatPlanes(const dplane* planes, size_t numPlanes, const dvec3& origin)
+        {
+            count = std::min(numPlanes, PackedBounds::maxNumPlanes);
+            for (size_t i = 0; i < count; ++i)
+            {
+                const auto& plane = planes[i];
+                nx[i] = static_cast<float>(plane[0]);
+                ny[i] = static_cast<float>(plane[1]);
+                nz[i] = static_cast<float>(plane[2]);
+                p[i] = static_cast<float>(plane[3] + plane[0] * origin.x + plane[1] * origin.y + plane[2] * origin.z);
+            }
+        }
+    };
+} // namespace
+
+PackedBounds::PackedBounds()
+{
+}
+
+PackedBounds::PackedBounds(const Group& group)
+{
+    std::vector<dsphere> spheres;
+    spheres.reserve(group.children.size());
+    for (auto& child : group.children) spheres.push_back(bound(child));
+
+    set(spheres.data(), spheres.size());
+}
+
+PackedBounds::PackedBounds(const QuadGroup& quadGroup)
+{
+    dsphere spheres[4];
+    for (size_t i = 0; i < 4; ++i) spheres[i] = bound(quadGroup.children[i]);
+
+    set(spheres, 4);
+}
+
+PackedBounds::~PackedBounds()
+{
+}
+
+int PackedBounds::compare(const Object& rhs_object) const
+{
+    int result = Object::compare(rhs_object);
+    if (result != 0) return result;
+
+    auto& rhs = static_cast<decltype(*this)>(rhs_object);
+    if ((result = compare_value(origin, rhs.origin)) != 0) return result;
+    if ((result = compare_value(count, rhs.count)) != 0) return result;
+    if ((result = compare_value_container(x, rhs.x)) != 0) return result;
+    if ((result = compare_value_container(y, rhs.y)) != 0) return result;
+    if ((result = compare_value_container(z, rhs.z)) != 0) return result;
+    return compare_value_container(radius, rhs.radius);
+}
+
+void PackedBounds::read(Input& input)
+{
+    Object::read(input);
+
+    std::vector<vec4> spheres;
+    input.read("origin", origin);
+    input.readValues("spheres", spheres);
+
+    count = spheres.size();
+    size_t paddedCount = (count + 7) & ~size_t(7);
+    x.assign(paddedCount, 0.0f);
+    y.assign(paddedCount, 0.0f);
+    z.assign(paddedCount, 0.0f);
+    radius.assign(paddedCount, 0.0f);
+
+    for (size_t i = 0; i < count; ++i)
+    {
+        const auto& sphere = spheres[i];
+        x[i] = sphere.x;
+        y[i] = sphere.y;
+        z[i] = sphere.z;
+        radius[i] = sphere.w < 0.0f ? std::numeric_limits<float>::infinity() : sphere.w;
+    }
+}
+
+void PackedBounds::write(Output& output) const
+{
+    Object::write(output);
+
+    // write the spheres without the padding, with the infinite radius used for spheres that are always visible written as -1
+    std::vector<vec4> spheres(count);
+    for (size_t i = 0; i < count; ++i)
+    {
+        spheres[i].set(x[i], y[i], z[i], std::isinf(radius[i]) ? -1.0f : radius[i]);
+    }
+
+    output.write("origin", origin);
+    output.writeValues("spheres", spheres);
+}
+
+dsphere PackedBounds::bound(const Node* node)
+{
+    // PagedLOD isn't included as it needs to be visited when culled to track which high resolution children can be released.
+    if (!node) return {};
+
+    const auto& type = node->type_info();
+    if (type == typeid(CullGroup)) return static_cast<const CullGroup*>(node)->bound;
+    if (type == typeid(CullNode)) return static_cast<const CullNode*>(node)->bound;
+    if (type == typeid(LOD)) return static_cast<const LOD*>(node)->bound;
+    if (type == typeid(DepthSorted)) return static_cast<const DepthSorted*>(node)->bound;
+    return {};
+}
+
+void PackedBounds::set(const dsphere* spheres, size_t numSpheres)
+{
+    count = numSpheres;
+
+    // use the center of the extents of the valid spheres as the origin to minimize the magnitude of the float coordinates
+    dvec3 minimum(std::numeric_limits<double>::max(), std::numeric_limits<double>::max(), std::numeric_limits<double>::max());
+    dvec3 maximum(-std::numeric_limits<double>::max(), -std::numeric_limits<double>::max(), -std::numeric_limits<double>::max());
+    bool hasValid = false;
+    for (size_t i = 0; i < numSpheres; ++i)
+    {
+        const auto& sphere = spheres[i];
+        if (!sphere.valid()) continue;
+
+        for (int c = 0; c < 3; ++c)
+        {
+            minimum[c] = std::min(minimum[c], sphere.center[c]);
+            maximum[c] = std::max(maximum[c], sphere.center[c]);
+        }
+        hasValid = true;
+    }
+    origin = hasValid ? (minimum + maximum) * 0.5 : dvec3();
+
+    size_t paddedCount = (numSpheres + 7) & ~size_t(7);
+    x.assign(paddedCount, 0.0f);
+    y.assign(paddedCount, 0.0f);
+    z.assign(paddedCount, 0.0f);
+    radius.assign(paddedCount, 0.0f);
+
+    for (size_t i = 0; i < numSpheres; ++i)
+    {
+        const auto& sphere = spheres[i];
+        if (sphere.valid())
+        {
+            dvec3 center = sphere.center - origin;
+            x[i] = static_cast<float>(center.x);
+            y[i] = static_cast<float>(center.y);
+            z[i] = static_cast<float>(center.z);
+
+            // pad the radius so that float rounding errors don't cull spheres that the double precision test would keep
+            double tolerance = (std::abs(center.x) + std::abs(center.y) + std::abs(center.z) + sphere.radius) * 1e-5;
+            radius[i] = static_cast<float>(sphere.radius + tolerance);
+        }
+        else
+        {
+            radius[i] = std::numeric_limits<float>::infinity();
+        }
+    }
+}
+
+size_t PackedBounds::intersect_scalar(const dplane* planes, size_t numPlanes, uint8_t* visible) const
+{
+    FloatPlanes fp(planes, numPlanes, origin);
+
+    size_t numVisible = 0;
+    for (size_t i = 0; i < count; ++i)
+    {
+        float negative_radius = -radius[i];
+        uint8_t inside = 1;
+        for (size_t pi = 0; pi < fp.count; ++pi)
+        {
+            if (((fp.nx[pi] * x[i] + fp.ny[pi] * y[i]) + (fp.nz[pi] * z[i] + fp.p[pi])) < negative_radius)
+            {
+                inside = 0;
+                break;
+            }
+        }
+        visible[i] = inside;
+        numVisible += inside;
+    }
+    return numVisible;
+}
+
+size_t PackedBounds::intersect(const dplane* planes, size_t numPlanes, uint8_t* visible) const
+{
+#if defined(VSG_PACKEDBOUNDS_AVX)
+    FloatPlanes fp(planes, numPlanes, origin);
+
+    size_t numVisible = 0;
+    for (size_t i = 0; i < count; i += 8)
+    {
+        __m256 cx = _mm256_loadu_ps(x.data() + i);
+        __m256 cy = _mm256_loadu_ps(y.data() + i);
+        __m256 cz = _mm256_loadu_ps(z.data() + i);
+        __m256 negative_radius = _mm256_sub_ps(_mm256_setzero_ps(), _mm256_loadu_ps(radius.data() + i));
+
+        __m256 inside = _mm256_castsi256_ps(_mm256_set1_epi32(-1));
+        for (size_t pi = 0; pi < fp.count; ++pi)
+        {
+            __m256 d = _mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(_mm256_set1_ps(fp.nx[pi]), cx), _mm256_mul_ps(_mm256_set1_ps(fp.ny[pi]), cy)),
+                                     _mm256_add_ps(_mm256_mul_ps(_mm256_set1_ps(fp.nz[pi]), cz), _mm256_set1_ps(fp.p[pi])));
+            inside = _mm256_and_ps(inside, _mm256_cmp_ps(d, negative_radius, _CMP_GE_OQ));
+        }
+
+        int mask = _mm256_movemask_ps(inside);
+        size_t n = std::min(count - i, size_t(8));
+        for (size_t j = 0; j < n; ++j)
+        {
+            uint8_t v = static_cast<uint8_t>((mask >> j) & 1);
+            visible[i + j] = v;
+            numVisible += v;
+        }
+    }
+    return numVisible;
+#elif defined(VSG_PACKEDBOUNDS_SSE)
+    FloatPlanes fp(planes, numPlanes, origin);
+
+    size_t numVisible = 0;
+    for (size_t i = 0; i < count; i += 4)
+    {
+        __m128 cx = _mm_loadu_ps(x.data() + i);
+        __m128 cy = _mm_loadu_ps(y.data() + i);
+        __m128 cz = _mm_loadu_ps(z.data() + i);
+        __m128 negative_radius = _mm_sub_ps(_mm_setzero_ps(), _mm_loadu_ps(radius.data() + i));
+
+        __m128 inside = _mm_castsi128_ps(_mm_set1_epi32(-1));
+        for (size_t pi = 0; pi < fp.count; ++pi)
+        {
+            __m128 d = _mm_add_ps(_mm_add_ps(_mm_mul_ps(_mm_set1_ps(fp.nx[pi]), cx), _mm_mul_ps(_mm_set1_ps(fp.ny[pi]), cy)),
+                                  _mm_add_ps(_mm_mul_ps(_mm_set1_ps(fp.nz[pi]), cz), _mm_set1_ps(fp.p[pi])));
+            inside = _mm_and_ps(inside, _mm_cmpge_ps(d, negative_radius));
+        }
+
+        int mask = _mm_movemask_ps(inside);
+        size_t n = std::min(count - i, size_t(4));
+        for (size_t j = 0; j < n; ++j)
+        {
+            uint8_t v = static_cast<uint8_t>((mask >> j) & 1);
+            visible[i + j] = v;
+            numVisible += v;
+        }
+    }
+    return numVisible;
+#else
+    return intersect_scalar(planes, numPlanes, visible);
+#endif
+}
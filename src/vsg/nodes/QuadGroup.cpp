@@ -15,6 +15,7 @@ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLI
 #include <vsg/io/Input.h>
 #include <vsg/io/Options.h>
 #include <vsg/io/Output.h>
+#include <vsg/io/VSG.h>
 
 using namespace vsg;
 
@@ -23,7 +24,8 @@ QuadGroup::QuadGroup()
 }
 
 QuadGroup::QuadGroup(const QuadGroup& rhs, const CopyOp& copyop) :
-    Inherit(rhs, copyop)
+    Inherit(rhs, copyop),
+    childBounds(rhs.childBounds)
 {
     children[0] = copyop(rhs.children[0]);
     children[1] = copyop(rhs.children[1]);
@@ -41,7 +43,8 @@ int QuadGroup::compare(const Object& rhs_object) const
     if (result != 0) return result;
 
     auto& rhs = static_cast<decltype(*this)>(rhs_object);
-    return compare_pointer_container(children, rhs.children);
+    if ((result = compare_pointer_container(children, rhs.children)) != 0) return result;
+    return compare_pointer(childBounds, rhs.childBounds);
 }
 
 void QuadGroup::read(Input& input)
@@ -52,6 +55,8 @@ void QuadGroup::read(Input& input)
     {
         input.readObject("Child", child);
     }
+
+    if ((input.formatFeatures & VSG::CHILD_BOUNDS) != 0) input.read("childBounds", childBounds);
 }
 
 void QuadGroup::write(Output& output) const
@@ -62,4 +67,6 @@ void QuadGroup::write(Output& output) const
     {
         output.writeObject("Child", child.get());
     }
+
+    if ((output.formatFeatures & VSG::CHILD_BOUNDS) != 0) output.write("childBounds", childBounds);
 }
@@ -17,6 +17,8 @@ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLI
 #include <vsg/state/BufferInfo.h>
 #include <vsg/vk/Context.h>
 
+#include <algorithm>
+
 using namespace vsg;
 
 /////////////////////////////////////////////////////////////////////////////////////////
@@ -213,11 +215,12 @@ bool vsg::createBufferAndTransferData(Context& context, const BufferInfoList& bu
 
     Device* device = context.device;
 
+    // usage may combine STORAGE with other flags such as INDIRECT, so respect the offset alignment of each descriptor usage present.
     VkDeviceSize alignment = 4;
-    if (usage == VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT)
-        alignment = device->getPhysicalDevice()->getProperties().limits.minUniformBufferOffsetAlignment;
-    else if (usage == VK_BUFFER_USAGE_STORAGE_BUFFER_BIT)
-        alignment = device->getPhysicalDevice()->getProperties().limits.minStorageBufferOffsetAlignment;
+    if ((usage & VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT) != 0)
+        alignment = std::max(alignment, device->getPhysicalDevice()->getProperties().limits.minUniformBufferOffsetAlignment);
+    if ((usage & VK_BUFFER_USAGE_STORAGE_BUFFER_BIT) != 0)
+        alignment = std::max(alignment, device->getPhysicalDevice()->getProperties().limits.minStorageBufferOffsetAlignment);
 
     VkDeviceSize totalSize = 0;
     VkDeviceSize offset = 0;
@@ -321,11 +324,12 @@ BufferInfoList vsg::createHostVisibleBuffer(Device* device, const DataList& data
 
     BufferInfoList bufferInfoList;
 
+    // usage may combine STORAGE with other flags such as INDIRECT, so respect the offset alignment of each descriptor usage present.
     VkDeviceSize alignment = 4;
-    if (usage == VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT)
-        alignment = device->getPhysicalDevice()->getProperties().limits.minUniformBufferOffsetAlignment;
-    else if (usage == VK_BUFFER_USAGE_STORAGE_BUFFER_BIT)
-        alignment = device->getPhysicalDevice()->getProperties().limits.minStorageBufferOffsetAlignment;
+    if ((usage & VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT) != 0)
+        alignment = std::max(alignment, device->getPhysicalDevice()->getProperties().limits.minUniformBufferOffsetAlignment);
+    if ((usage & VK_BUFFER_USAGE_STORAGE_BUFFER_BIT) != 0)
+        alignment = std::max(alignment, device->getPhysicalDevice()->getProperties().limits.minStorageBufferOffsetAlignment);
 
     VkDeviceSize totalSize = 0;
     VkDeviceSize offset = 0;
@@ -221,7 +221,8 @@ GraphicsPipeline::Implementation::Implementation(Context& context, Device* devic
         pipelineState->apply(context, pipelineInfo);
     }
 
-    VkResult result = vkCreateGraphicsPipelines(*device, VK_NULL_HANDLE, 1, &pipelineInfo, _device->getAllocationCallbacks(), &_pipeline);
+    VkPipelineCache pipelineCache = context.pipelineCache ? context.pipelineCache->vk() : VK_NULL_HANDLE;
+    VkResult result = vkCreateGraphicsPipelines(*device, pipelineCache, 1, &pipelineInfo, _device->getAllocationCallbacks(), &_pipeline);
 
     context.scratchMemory->release();
 
@@ -0,0 +1,129 @@
+/* <editor-fold desc="MIT License">
+
+Copyright(c) 2024 Robert Osfield
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"), to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+</editor-fold> */
+
+#include <vsg/commands/BindIndexBuffer.h>
+#include <vsg/commands/BindVertexBuffers.h>
+#include <vsg/nodes/Geometry.h>
+#include <vsg/nodes/VertexDraw.h>
+#include <vsg/nodes/VertexIndexDraw.h>
+#include <vsg/state/DescriptorBuffer.h>
+#include <vsg/state/DescriptorImage.h>
+#include <vsg/utils/ComputeMemoryFootprint.h>
+
+using namespace vsg;
+
+ComputeMemoryFootprint::ComputeMemoryFootprint(uint32_t in_deviceID) :
+    deviceID(in_deviceID)
+{
+}
+
+void ComputeMemoryFootprint::reset()
+{
+    cpuMemory = 0;
+    gpuMemory = 0;
+    _visited.clear();
+}
+
+void ComputeMemoryFootprint::apply(const Object& object)
+{
+    object.traverse(*this);
+}
+
+void ComputeMemoryFootprint::apply(const Data& data)
+{
+    if (_visit(&data)) cpuMemory += data.dataSize();
+}
+
+void ComputeMemoryFootprint::apply(const BufferInfo& info)
+{
+    if (!_visit(&info)) return;
+
+    if (info.buffer && info.buffer->getDeviceMemory(deviceID)) gpuMemory += info.range;
+    if (info.data) info.data->accept(*this);
+}
+
+void ComputeMemoryFootprint::apply(const Image& image)
+{
+    if (!_visit(&image)) return;
+
+    if (image.getDeviceMemory(deviceID)) gpuMemory += image.getMemoryRequirements(deviceID).size;
+    if (image.data) image.data->accept(*this);
+}
+
+void ComputeMemoryFootprint::apply(const ImageView& imageView)
+{
+    if (imageView.image) imageView.image->accept(*this);
+}
+
+void ComputeMemoryFootprint::apply(const ImageInfo& info)
+{
+    if (info.imageView) info.imageView->accept(*this);
+}
+
+void ComputeMemoryFootprint::apply(const DescriptorBuffer& db)
+{
+    for (auto info : db.bufferInfoList)
+    {
+        if (info) info->accept(*this);
+    }
+}
+
+void ComputeMemoryFootprint::apply(const DescriptorImage& di)
+{
+    for (auto info : di.imageInfoList)
+    {
+        if (info) info->accept(*this);
+    }
+}
+
+void ComputeMemoryFootprint::apply(const BindIndexBuffer& bib)
+{
+    if (bib.indices) bib.indices->accept(*this);
+}
+
+void ComputeMemoryFootprint::apply(const BindVertexBuffers& bvb)
+{
+    for (auto info : bvb.arrays)
+    {
+        if (info) info->accept(*this);
+    }
+}
+
+void ComputeMemoryFootprint::apply(const VertexDraw& vd)
+{
+    for (auto info : vd.arrays)
+    {
+        if (info) info->accept(*this);
+    }
+}
+
+void ComputeMemoryFootprint::apply(const VertexIndexDraw& vid)
+{
+    if (vid.indices) vid.indices->accept(*this);
+    for (auto info : vid.arrays)
+    {
+        if (info) info->accept(*this);
+    }
+}
+
+void ComputeMemoryFootprint::apply(const Geometry& geom)
+{
+    if (geom.indices) geom.indices->accept(*this);
+    for (auto info : geom.arrays)
+    {
+        if (info) info->accept(*this);
+    }
+    for (auto command : geom.commands)
+    {
+        if (command) command->accept(*this);
+    }
+}
@@ -0,0 +1,533 @@
+/* <editor-fold desc="MIT License">
+
+Copyright(c) 2024 Robert Osfield
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"), to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+</editor-fold> */
+
+#include <vsg/io/Options.h>
+#include <vsg/io/stream.h>
+#include <vsg/threading/Latch.h>
+#include <vsg/utils/OcclusionBuffer.h>
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#    include <emmintrin.h>
+#    define VSG_OCCLUSIONBUFFER_SSE 1
+#endif
+
+using namespace vsg;
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+//
+// Occluder
+//
+Occluder::Occluder()
+{
+}
+
+Occluder::Occluder(ref_ptr<vec3Array> in_vertices, ref_ptr<uintArray> in_indices, const dmat4& in_matrix) :
+    vertices(in_vertices),
+    indices(in_indices),
+    matrix(in_matrix)
+{
+}
+
+Occluder::~Occluder()
+{
+}
+
+void Occluder::read(Input& input)
+{
+    Object::read(input);
+
+    input.read("vertices", vertices);
+    input.read("indices", indices);
+    input.read("matrix", matrix);
+}
+
+void Occluder::write(Output& output) const
+{
+    Object::write(output);
+
+    output.write("vertices", vertices);
+    output.write("indices", indices);
+    output.write("matrix", matrix);
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+//
+// OcclusionBuffer
+//
+struct OcclusionBuffer::RasterizeOperation : public Inherit<Operation, RasterizeOperation>
+{
+    RasterizeOperation(OcclusionBuffer* in_buffer, ViewData* in_viewData, uint32_t in_y_begin, uint32_t in_y_end, ref_ptr<Latch> in_latch) :
+        buffer(in_buffer),
+        viewData(in_viewData),
+        y_begin(in_y_begin),
+        y_end(in_y_end),
+        latch(in_latch) {}
+
+    OcclusionBuffer* buffer;
+    ViewData* viewData;
+    uint32_t y_begin;
+    uint32_t y_end;
+    ref_ptr<Latch> latch;
+
+    void run() override
+    {
+        buffer->_rasterizeBand(*viewData, y_begin, y_end);
+        latch->count_down();
+    }
+};
+
+OcclusionBuffer::OcclusionBuffer(uint32_t in_width, uint32_t in_height) :
+    width(((std::max(in_width, 1u) + tileSize - 1) / tileSize) * tileSize),
+    height(((std::max(in_height, 1u) + tileSize - 1) / tileSize) * tileSize)
+{
+}
+
+OcclusionBuffer::~OcclusionBuffer()
+{
+}
+
+double OcclusionBuffer::_nearPlaneDistance(const ViewData& viewData, const dvec4& c)
+{
+    // the near plane is at depth 0 when depth increases with distance, or at depth 1 for reverse depth projections
+    return (viewData.depthSign > 0.0f) ? c.z : (c.w - c.z);
+}
+
+OcclusionBuffer::ViewData* OcclusionBuffer::_getViewData(uint32_t viewID) const
+{
+    std::scoped_lock lock(_viewDataMutex);
+    return (viewID < _viewData.size()) ? _viewData[viewID].get() : nullptr;
+}
+
+void OcclusionBuffer::rasterize(const dmat4& projection, const dmat4& view, uint32_t viewID)
+{
+    ref_ptr<OperationThreads> threads;
+    ViewData* viewData = nullptr;
+    {
+        std::scoped_lock lock(_viewDataMutex);
+        if (viewID >= _viewData.size()) _viewData.resize(viewID + 1);
+        if (!_viewData[viewID]) _viewData[viewID] = std::make_unique<ViewData>();
+        viewData = _viewData[viewID].get();
+
+        threads = operationThreads;
+        if (!threads && numThreads > 1)
+        {
+            if (!_operationThreads) _operationThreads = OperationThreads::create(numThreads - 1);
+            threads = _operationThreads;
+        }
+    }
+
+    auto& vd = *viewData;
+    vd.projection = projection;
+
+    // determine whether the projection maps increasing distance from the eye point to increasing or decreasing depth
+    dvec4 near_point = projection * dvec4(0.0, 0.0, -1.0, 1.0);
+    dvec4 far_point = projection * dvec4(0.0, 0.0, -2.0, 1.0);
+    vd.depthSign = ((far_point.z / far_point.w) >= (near_point.z / near_point.w)) ? 1.0f : -1.0f;
+
+    vd.depth.assign(static_cast<size_t>(width) * height, std::numeric_limits<float>::max());
+    vd.tileDepth.assign(static_cast<size_t>(width / tileSize) * (height / tileSize), std::numeric_limits<float>::max());
+    vd.partialDepth.resize(static_cast<size_t>(width) * height);
+    vd.partialEdge.assign(static_cast<size_t>(width) * height, 0);
+    vd.triangles.clear();
+
+    auto edgeKey = [](uint32_t a, uint32_t b) { return (static_cast<uint64_t>(std::min(a, b)) << 32) | std::max(a, b); };
+
+    // transform the occluders into clip space and clip against the near plane
+    auto projectionView = projection * view;
+    uint32_t vertexBase = 0;
+    for (auto& occluder : occluders)
+    {
+        if (!occluder || !occluder->vertices || !occluder->indices) continue;
+
+        auto mvp = projectionView * occluder->matrix;
+
+        vd.clipVertices.clear();
+        for (auto& v : *occluder->vertices)
+        {
+            vd.clipVertices.push_back(mvp * dvec4(v.x, v.y, v.z, 1.0));
+        }
+
+        auto& indices = *occluder->indices;
+        auto validTriangle = [&](size_t i) { return indices[i] < vd.clipVertices.size() && indices[i + 1] < vd.clipVertices.size() && indices[i + 2] < vd.clipVertices.size(); };
+
+        // count the triangles using each edge, pixels straddling an edge shared by two triangles are covered by the pair of triangles rather than either alone
+        vd.edgeCounts.clear();
+        for (size_t i = 0; i + 2 < indices.size(); i += 3)
+        {
+            if (!validTriangle(i)) continue;
+            for (size_t e = 0; e < 3; ++e) ++vd.edgeCounts[edgeKey(indices[i + e], indices[i + (e + 1) % 3])];
+        }
+
+        for (size_t i = 0; i + 2 < indices.size(); i += 3)
+        {
+            if (!validTriangle(i)) continue;
+
+            uint32_t vertexIDs[3];
+            uint32_t sharedEdges = 0;
+            for (size_t e = 0; e < 3; ++e)
+            {
+                vertexIDs[e] = vertexBase + indices[i + e];
+                if (vd.edgeCounts[edgeKey(indices[i + e], indices[i + (e + 1) % 3])] == 2) sharedEdges |= (1u << e);
+            }
+
+            _clipAndAddTriangle(vd, vd.clipVertices[indices[i]], vd.clipVertices[indices[i + 1]], vd.clipVertices[indices[i + 2]], vertexIDs, sharedEdges);
+        }
+
+        vertexBase += static_cast<uint32_t>(vd.clipVertices.size());
+    }
+
+    numTrianglesRasterized = vd.triangles.size();
+
+    // split the depth buffer into bands of tile rows, rasterizing each band in parallel
+    uint32_t numTileRows = height / tileSize;
+    uint32_t numBands = std::min(std::max(numThreads, 1u), numTileRows);
+    if (numBands <= 1 || !threads || vd.triangles.empty())
+    {
+        _rasterizeBand(vd, 0, height);
+        return;
+    }
+
+    auto latch = Latch::create(static_cast<int>(numBands - 1));
+    for (uint32_t band = 1; band < numBands; ++band)
+    {
+        uint32_t y_begin = ((band * numTileRows) / numBands) * tileSize;
+        uint32_t y_end = (((band + 1) * numTileRows) / numBands) * tileSize;
+        threads->add(RasterizeOperation::create(this, viewData, y_begin, y_end, latch));
+    }
+
+    _rasterizeBand(vd, 0, (numTileRows / numBands) * tileSize);
+
+    latch->wait();
+}
+
+void OcclusionBuffer::_clipAndAddTriangle(ViewData& viewData, const dvec4& c0, const dvec4& c1, const dvec4& c2, const uint32_t* vertexIDs, uint32_t sharedEdges)
+{
+    const dvec4* input[3] = {&c0, &c1, &c2};
+    double d[3] = {_nearPlaneDistance(viewData, c0), _nearPlaneDistance(viewData, c1), _nearPlaneDistance(viewData, c2)};
+
+    if (d[0] >= 0.0 && d[1] >= 0.0 && d[2] >= 0.0)
+    {
+        _addTriangle(viewData, c0, c1, c2, vertexIDs, sharedEdges);
+        return;
+    }
+
+    if (d[0] < 0.0 && d[1] < 0.0 && d[2] < 0.0) return;
+
+    // Sutherland-Hodgman clipping against the near plane, giving a polygon of 3 or 4 vertices
+    dvec4 polygon[4];
+    size_t numVertices = 0;
+    for (size_t i = 0; i < 3; ++i)
+    {
+        size_t j = (i + 1) % 3;
+        if (d[i] >= 0.0) polygon[numVertices++] = *input[i];
+        if ((d[i] >= 0.0) != (d[j] >= 0.0))
+        {
+            double r = d[i] / (d[i] - d[j]);
+            polygon[numVertices++] = *input[i] + (*input[j] - *input[i]) * r;
+        }
+    }
+
+    // the edges of the clipped polygon no longer match those of the neighbouring triangles so are all treated as unshared
+    for (size_t i = 2; i < numVertices; ++i)
+    {
+        _addTriangle(viewData, polygon[0], polygon[i - 1], polygon[i], vertexIDs, 0);
+    }
+}
+
+void OcclusionBuffer::_addTriangle(ViewData& viewData, const dvec4& c0, const dvec4& c1, const dvec4& c2, const uint32_t* vertexIDs, uint32_t sharedEdges)
+{
+    const dvec4* clip[3] = {&c0, &c1, &c2};
+
+    Triangle triangle;
+    for (size_t i = 0; i < 3; ++i)
+    {
+        const auto& c = *clip[i];
+        if (c.w <= 0.0) return;
+
+        double inv_w = 1.0 / c.w;
+        triangle.x[i] = static_cast<float>((c.x * inv_w * 0.5 + 0.5) * width);
+        triangle.y[i] = static_cast<float>((c.y * inv_w * 0.5 + 0.5) * height);
+        triangle.z[i] = viewData.depthSign * static_cast<float>(c.z * inv_w);
+        triangle.vertexIDs[i] = vertexIDs[i];
+    }
+    triangle.sharedEdges = sharedEdges;
+
+    // discard triangles entirely off screen
+    float fwidth = static_cast<float>(width);
+    float fheight = static_cast<float>(height);
+    if (triangle.x[0] < 0.0f && triangle.x[1] < 0.0f && triangle.x[2] < 0.0f) return;
+    if (triangle.y[0] < 0.0f && triangle.y[1] < 0.0f && triangle.y[2] < 0.0f) return;
+    if (triangle.x[0] > fwidth && triangle.x[1] > fwidth && triangle.x[2] > fwidth) return;
+    if (triangle.y[0] > fheight && triangle.y[1] > fheight && triangle.y[2] > fheight) return;
+
+    viewData.triangles.push_back(triangle);
+}
+
+void OcclusionBuffer::_rasterizeBand(ViewData& viewData, uint32_t y_begin, uint32_t y_end)
+{
+    for (auto& triangle : viewData.triangles)
+    {
+        _rasterizeTriangle(viewData, triangle, y_begin, y_end);
+    }
+
+    // update the farthest depth of each tile in the band
+    uint32_t numTileColumns = width / tileSize;
+    for (uint32_t ty = y_begin / tileSize; ty < y_end / tileSize; ++ty)
+    {
+        for (uint32_t tx = 0; tx < numTileColumns; ++tx)
+        {
+            float farthest = -std::numeric_limits<float>::max();
+            for (uint32_t y = ty * tileSize; y < (ty + 1) * tileSize; ++y)
+            {
+                const float* row = viewData.depth.data() + static_cast<size_t>(y) * width + tx * tileSize;
+                for (uint32_t x = 0; x < tileSize; ++x) farthest = std::max(farthest, row[x]);
+            }
+            viewData.tileDepth[static_cast<size_t>(ty) * numTileColumns + tx] = farthest;
+        }
+    }
+}
+
+void OcclusionBuffer::_rasterizeTriangle(ViewData& viewData, const Triangle& triangle, uint32_t y_begin, uint32_t y_end)
+{
+    float x0 = triangle.x[0], y0 = triangle.y[0], z0 = triangle.z[0];
+    float x1 = triangle.x[1], y1 = triangle.y[1], z1 = triangle.z[1];
+    float x2 = triangle.x[2], y2 = triangle.y[2], z2 = triangle.z[2];
+    uint32_t v0 = triangle.vertexIDs[0], v1 = triangle.vertexIDs[1], v2 = triangle.vertexIDs[2];
+    bool shared01 = (triangle.sharedEdges & 1) != 0, shared12 = (triangle.sharedEdges & 2) != 0, shared20 = (triangle.sharedEdges & 4) != 0;
+
+    // make the winding counter clockwise so that inside is where all edge functions are positive, occluders are double sided.
+    float area = (x1 - x0) * (y2 - y0) - (x2 - x0) * (y1 - y0);
+    if (area == 0.0f) return;
+    if (area < 0.0f)
+    {
+        std::swap(x1, x2);
+        std::swap(y1, y2);
+        std::swap(z1, z2);
+        std::swap(v1, v2);
+        std::swap(shared01, shared20);
+        area = -area;
+    }
+
+    int min_x = std::max(0, static_cast<int>(std::floor(std::min({x0, x1, x2}))));
+    int max_x = std::min(static_cast<int>(width) - 1, static_cast<int>(std::ceil(std::max({x0, x1, x2}))));
+    int min_y = std::max(static_cast<int>(y_begin), static_cast<int>(std::floor(std::min({y0, y1, y2}))));
+    int max_y = std::min(static_cast<int>(y_end) - 1, static_cast<int>(std::ceil(std::max({y0, y1, y2}))));
+    if (min_x > max_x || min_y > max_y) return;
+
+    // edge functions E(x, y) = A * x + B * y + C, each is zero on its edge and equal to the area at the opposite vertex
+    float A01 = y0 - y1, B01 = x1 - x0, C01 = x0 * y1 - x1 * y0;
+    float A12 = y1 - y2, B12 = x2 - x1, C12 = x1 * y2 - x2 * y1;
+    float A20 = y2 - y0, B20 = x0 - x2, C20 = x2 * y0 - x0 * y2;
+
+    // depth plane from the barycentric weights, z = zA * x + zB * y + zC
+    float inv_area = 1.0f / area;
+    float zA = (A12 * z0 + A20 * z1 + A01 * z2) * inv_area;
+    float zB = (B12 * z0 + B20 * z1 + B01 * z2) * inv_area;
+    float zC = (C12 * z0 + C20 * z1 + C01 * z2) * inv_area;
+
+    // rasterize conservatively so that occluded() never hides visible objects, the edge functions and depth are evaluated at the pixel centers
+    // but offset to the pixel corner furthest from each edge, so only pixels entirely covered by the triangle are written, with the farthest depth over the pixel.
+    float h01 = 0.5f * (std::abs(A01) + std::abs(B01));
+    float h12 = 0.5f * (std::abs(A12) + std::abs(B12));
+    float h20 = 0.5f * (std::abs(A20) + std::abs(B20));
+    C01 -= h01;
+    C12 -= h12;
+    C20 -= h20;
+    zC += 0.5f * (std::abs(zA) + std::abs(zB));
+
+    // pixels that straddle a shared edge, while entirely inside the other two edges, are recorded as partially covered against the directed edge,
+    // the triangle on the other side of the edge traverses it in the opposite direction so when it also partially covers the pixel
+    // the two triangles together cover the whole pixel and the farther of their depths is written.
+    float t01 = shared01 ? -2.0f * h01 : 0.0f;
+    float t12 = shared12 ? -2.0f * h12 : 0.0f;
+    float t20 = shared20 ? -2.0f * h20 : 0.0f;
+    bool hasSharedEdges = shared01 || shared12 || shared20;
+
+    auto partiallyCovered = [&](size_t index, float fx, float fy) {
+        float e01 = A01 * fx + B01 * fy + C01, e12 = A12 * fx + B12 * fy + C12, e20 = A20 * fx + B20 * fy + C20;
+        if (e01 < t01 || e12 < t12 || e20 < t20) return;
+        if ((e01 < 0.0f) + (e12 < 0.0f) + (e20 < 0.0f) != 1) return;
+
+        uint64_t edge = (e01 < 0.0f) ? ((static_cast<uint64_t>(v0) << 32) | v1) : (e12 < 0.0f) ? ((static_cast<uint64_t>(v1) << 32) | v2) : ((static_cast<uint64_t>(v2) << 32) | v0);
+
+        float depth = zA * fx + zB * fy + zC;
+        uint64_t oppositeEdge = (edge << 32) | (edge >> 32);
+        if (viewData.partialEdge[index] == oppositeEdge)
+        {
+            depth = std::max(depth, viewData.partialDepth[index]);
+            if (depth < viewData.depth[index]) viewData.depth[index] = depth;
+            viewData.partialEdge[index] = 0;
+        }
+        else if (viewData.partialEdge[index] == 0)
+        {
+            viewData.partialEdge[index] = edge;
+            viewData.partialDepth[index] = depth;
+        }
+    };
+
+#if defined(VSG_OCCLUSIONBUFFER_SSE)
+    const __m128 offsets = _mm_set_ps(3.0f, 2.0f, 1.0f, 0.0f);
+    const __m128 zero = _mm_setzero_ps();
+    const __m128 A01_4 = _mm_set1_ps(A01 * 4.0f), A12_4 = _mm_set1_ps(A12 * 4.0f), A20_4 = _mm_set1_ps(A20 * 4.0f), zA_4 = _mm_set1_ps(zA * 4.0f);
+    const __m128 t01_v = _mm_set1_ps(t01), t12_v = _mm_set1_ps(t12), t20_v = _mm_set1_ps(t20);
+#endif
+
+    for (int y = min_y; y <= max_y; ++y)
+    {
+        float py = static_cast<float>(y) + 0.5f;
+        float px = static_cast<float>(min_x) + 0.5f;
+        size_t rowIndex = static_cast<size_t>(y) * width;
+        float* row = viewData.depth.data() + rowIndex;
+
+        int x = min_x;
+
+#if defined(VSG_OCCLUSIONBUFFER_SSE)
+        __m128 vpx = _mm_add_ps(_mm_set1_ps(px), offsets);
+        __m128 e01 = _mm_add_ps(_mm_mul_ps(_mm_set1_ps(A01), vpx), _mm_set1_ps(B01 * py + C01));
+        __m128 e12 = _mm_add_ps(_mm_mul_ps(_mm_set1_ps(A12), vpx), _mm_set1_ps(B12 * py + C12));
+        __m128 e20 = _mm_add_ps(_mm_mul_ps(_mm_set1_ps(A20), vpx), _mm_set1_ps(B20 * py + C20));
+        __m128 z = _mm_add_ps(_mm_mul_ps(_mm_set1_ps(zA), vpx), _mm_set1_ps(zB * py + zC));
+
+        for (; x + 3 <= max_x; x += 4)
+        {
+            __m128 inside = _mm_and_ps(_mm_and_ps(_mm_cmpge_ps(e01, zero), _mm_cmpge_ps(e12, zero)), _mm_cmpge_ps(e20, zero));
+            int insideMask = _mm_movemask_ps(inside);
+            if (insideMask != 0)
+            {
+                __m128 current = _mm_loadu_ps(row + x);
+                __m128 nearest = _mm_min_ps(current, z);
+                _mm_storeu_ps(row + x, _mm_or_ps(_mm_and_ps(inside, nearest), _mm_andnot_ps(inside, current)));
+            }
+
+            if (hasSharedEdges && insideMask != 0xf)
+            {
+                __m128 candidate = _mm_and_ps(_mm_and_ps(_mm_cmpge_ps(e01, t01_v), _mm_cmpge_ps(e12, t12_v)), _mm_cmpge_ps(e20, t20_v));
+                int candidateMask = _mm_movemask_ps(candidate) & ~insideMask;
+                for (int i = 0; candidateMask != 0; ++i, candidateMask >>= 1)
+                {
+                    if (candidateMask & 1) partiallyCovered(rowIndex + x + i, static_cast<float>(x + i) + 0.5f, py);
+                }
+            }
+
+            e01 = _mm_add_ps(e01, A01_4);
+            e12 = _mm_add_ps(e12, A12_4);
+            e20 = _mm_add_ps(e20, A20_4);
+            z = _mm_add_ps(z, zA_4);
+        }
+#endif
+
+        for (; x <= max_x; ++x)
+        {
+            float fx = static_cast<float>(x) + 0.5f;
+            if ((A01 * fx + B01 * py + C01) >= 0.0f && (A12 * fx + B12 * py + C12) >= 0.0f && (A20 * fx + B20 * py + C20) >= 0.0f)
+            {
+                float depth = zA * fx + zB * py + zC;
+                if (depth < row[x]) row[x] = depth;
+            }
+            else if (hasSharedEdges)
+            {
+                partiallyCovered(rowIndex + x, fx, py);
+            }
+        }
+    }
+}
+
+const std::vector<float>& OcclusionBuffer::depth(uint32_t viewID) const
+{
+    static const std::vector<float> s_empty;
+    auto viewData = _getViewData(viewID);
+    return viewData ? viewData->depth : s_empty;
+}
+
+bool OcclusionBuffer::occluded(const dsphere& sphere, uint32_t viewID) const
+{
+    ++numTests;
+
+    auto viewData = _getViewData(viewID);
+    if (!viewData || viewData->triangles.empty() || viewData->depth.empty()) return false;
+
+    const auto& vd = *viewData;
+
+    const auto& center = sphere.center;
+    double radius = sphere.radius;
+
+    // nearest point of the sphere to the eye, if it's in front of the near plane the sphere can't be occluded
+    dvec4 nearest = vd.projection * dvec4(center.x, center.y, center.z + radius, 1.0);
+    if (nearest.w <= 0.0 || _nearPlaneDistance(vd, nearest) <= 0.0) return false;
+
+    float nearestDepth = vd.depthSign * static_cast<float>(nearest.z / nearest.w);
+
+    // screen space extents of the box around the sphere
+    double min_x = std::numeric_limits<double>::max(), max_x = -std::numeric_limits<double>::max();
+    double min_y = std::numeric_limits<double>::max(), max_y = -std::numeric_limits<double>::max();
+    for (int i = 0; i < 8; ++i)
+    {
+        dvec4 corner = vd.projection * dvec4(center.x + ((i & 1) ? radius : -radius), center.y + ((i & 2) ? radius : -radius), center.z + ((i & 4) ? radius : -radius), 1.0);
+        if (corner.w <= 0.0) return false;
+
+        double sx = (corner.x / corner.w * 0.5 + 0.5) * width;
+        double sy = (corner.y / corner.w * 0.5 + 0.5) * height;
+        min_x = std::min(min_x, sx);
+        max_x = std::max(max_x, sx);
+        min_y = std::min(min_y, sy);
+        max_y = std::max(max_y, sy);
+    }
+
+    if (max_x < 0.0 || max_y < 0.0 || min_x >= width || min_y >= height) return false;
+
+    int x0 = std::max(0, static_cast<int>(std::floor(min_x)));
+    int x1 = std::min(static_cast<int>(width) - 1, static_cast<int>(std::floor(max_x)));
+    int y0 = std::max(0, static_cast<int>(std::floor(min_y)));
+    int y1 = std::min(static_cast<int>(height) - 1, static_cast<int>(std::floor(max_y)));
+
+    // check tiles first, tiles that are entirely nearer than the sphere don't need their pixels checking
+    int numTileColumns = static_cast<int>(width / tileSize);
+    int ts = static_cast<int>(tileSize);
+    for (int ty = y0 / ts; ty <= y1 / ts; ++ty)
+    {
+        for (int tx = x0 / ts; tx <= x1 / ts; ++tx)
+        {
+            if (vd.tileDepth[static_cast<size_t>(ty) * numTileColumns + tx] < nearestDepth) continue;
+
+            int py_end = std::min(y1, ty * ts + ts - 1);
+            int px_begin = std::max(x0, tx * ts);
+            int px_end = std::min(x1, tx * ts + ts - 1);
+            for (int py = std::max(y0, ty * ts); py <= py_end; ++py)
+            {
+                const float* row = vd.depth.data() + static_cast<size_t>(py) * width;
+                for (int px = px_begin; px <= px_end; ++px)
+                {
+                    if (row[px] >= nearestDepth) return false;
+                }
+            }
+        }
+    }
+
+    ++numOccluded;
+    return true;
+}
+
+bool OcclusionBuffer::occluded(const dsphere& sphere, const dmat4& modelview, uint32_t viewID) const
+{
+    dvec3 center = modelview * sphere.center;
+
+    // scale the radius by the largest scale of the modelview matrix
+    double scale2 = std::max({length2(dvec3(modelview[0][0], modelview[0][1], modelview[0][2])),
+                              length2(dvec3(modelview[1][0], modelview[1][1], modelview[1][2])),
+                              length2(dvec3(modelview[2][0], modelview[2][1], modelview[2][2]))});
+
+    return occluded(dsphere(center, sphere.radius * std::sqrt(scale2)), viewID);
+}
@@ -0,0 +1,110 @@
+/* <editor-fold desc="MIT License">
+
+Copyright(c) 2024 Robert Osfield
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"), to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+</editor-fold> */
+
+#include <vsg/maths/transform.h>
+#include <vsg/utils/PagedLODPrefetch.h>
+
+#include <algorithm>
+
+using namespace vsg;
+
+PagedLODPrefetch::PagedLODPrefetch()
+{
+}
+
+PagedLODPrefetch::~PagedLODPrefetch()
+{
+}
+
+bool PagedLODPrefetch::update(uint64_t frameCount, double time, const dmat4& projectionMatrix, const dmat4& viewMatrix)
+{
+    // the View has already been recorded this frame, such as when it's shared between CommandGraphs, so keep the existing prediction
+    if (!_samples.empty() && _samples.back().frameCount == frameCount) return _active;
+
+    _active = false;
+
+    // discard the samples if the View wasn't rendered in the previous frame as the camera path is no longer continuous
+    if (!_samples.empty() && (frameCount - _samples.back().frameCount) > 1) _samples.clear();
+
+    Sample sample;
+    sample.frameCount = frameCount;
+    sample.time = time;
+    dvec3 scale;
+    if (!decompose(inverse(viewMatrix), sample.position, sample.rotation, scale))
+    {
+        _samples.clear();
+        return false;
+    }
+
+    _samples.push_back(sample);
+    while (_samples.size() > std::max(maxNumSamples, 2u)) _samples.pop_front();
+
+    if (_samples.size() < 2) return false;
+
+    // extrapolate the camera position and orientation using the average velocity over the samples
+    const auto& first = _samples.front();
+    const auto& last = _samples.back();
+    double duration = last.time - first.time;
+    if (duration <= 0.0) return false;
+    if (first.position == last.position && first.rotation == last.rotation) return false;
+
+    double r = (duration + predictionTime) / duration;
+    dvec3 position = first.position + (last.position - first.position) * r;
+    dquat rotation = normalize(mix(first.rotation, last.rotation, r));
+
+    _predictedViewMatrix = inverse(translate(position) * rotate(rotation) * vsg::scale(scale));
+    _predictedFromCurrent = _predictedViewMatrix * inverse(viewMatrix);
+
+    // frustum planes in eye coordinates, matching the frustum set up by vsg::State
+    const dplane unit[5] = {
+        {1.0, 0.0, 0.0, 1.0},  // left plane
+        {-1.0, 0.0, 0.0, 1.0}, // right plane
+        {0.0, -1.0, 0.0, 1.0}, // bottom plane
+        {0.0, 1.0, 0.0, 1.0},  // top plane
+        {0.0, 0.0, 1.0, 0.0}   // far plane
+    };
+    for (size_t i = 0; i < 5; ++i) _frustum[i] = unit[i] * projectionMatrix;
+
+    _lodScale = -projectionMatrix[1][1] * 0.5;
+    _active = true;
+
+    return true;
+}
+
+double PagedLODPrefetch::lodDistance(const dsphere& sphere, const dmat4& modelview) const
+{
+    const auto& mv = modelview;
+    double matrixScale = std::sqrt(square(mv[0][0]) + square(mv[1][0]) + square(mv[2][0]) + square(mv[0][1]) + square(mv[1][1]) + square(mv[2][1]));
+
+    dvec3 center = _predictedFromCurrent * (modelview * sphere.center);
+    double negative_radius = -sphere.radius * matrixScale * sqrt(0.5);
+    for (auto& plane : _frustum)
+    {
+        if (distance(plane, center) < negative_radius) return -1.0;
+    }
+
+    return std::abs(center.z / (_lodScale * matrixScale));
+}
+
+uint64_t PagedLODPrefetch::numMisses() const
+{
+    uint64_t used = numHits + numLate;
+    uint64_t requests = numRequests;
+    return requests > used ? requests - used : 0;
+}
+
+void PagedLODPrefetch::resetStatistics()
+{
+    numRequests = 0;
+    numHits = 0;
+    numLate = 0;
+}
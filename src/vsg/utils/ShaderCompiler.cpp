@@ -11,6 +11,7 @@ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLI
 </editor-fold> */
 
 #include <vsg/core/Version.h>
+#include <vsg/core/compare.h>
 #include <vsg/io/Logger.h>
 #include <vsg/io/Options.h>
 #include <vsg/nodes/StateGroup.h>
@@ -54,6 +55,120 @@ static void s_finalizeProcess()
     }
 }
 
+// SPIR-V cache file layout: signature, number of stages, then for each stage its VkShaderStageFlagBits, number of SPIR-V words and the words.
+static const char s_spirvCacheSignature[8] = {'v', 's', 'g', 's', 'p', 'v', '0', '1'};
+
+static std::string s_spirvCacheKey(const ShaderStages& shaders, const std::vector<std::string>& finalShaderSources, const ref_ptr<ShaderCompileSettings>& defaults)
+{
+    // two hashes with different seeds so that the key has at least 64 bits even where std::size_t is 32 bits
+    std::size_t hashes[2] = {0, 0x9e3779b9};
+    auto add = [&hashes](const void* ptr, size_t size) {
+        for (auto& hash : hashes) hash = hash_memory(ptr, size, hash);
+    };
+    auto add_value = [&add](auto value) {
+        add(&value, sizeof(value));
+    };
+    auto add_string = [&add](const std::string& str) {
+        add(str.data(), str.size());
+    };
+
+    auto version = glslang::GetVersion();
+    add_value(version.major);
+    add_value(version.minor);
+    add_value(version.patch);
+    add_string(version.flavor ? version.flavor : "");
+
+    for (size_t i = 0; i < shaders.size(); ++i)
+    {
+        auto& vsg_shader = shaders[i];
+        auto settings = vsg_shader->module->hints ? vsg_shader->module->hints : defaults;
+
+        add_value(vsg_shader->stage);
+        add_value(settings->vulkanVersion);
+        add_value(settings->clientInputVersion);
+        add_value(settings->language);
+        add_value(settings->defaultVersion);
+        add_value(settings->target);
+        add_value(settings->forwardCompatible);
+        add_value(settings->generateDebugInfo);
+        add_string(finalShaderSources[i]);
+    }
+
+    std::ostringstream str;
+    str << std::hex << std::setfill('0');
+    for (auto& hash : hashes) str << std::setw(sizeof(hash) * 2) << hash;
+    str << ".spv";
+    return str.str();
+}
+
+static bool s_readSpirvCache(const Path& filename, ShaderStages& shaders)
+{
+    auto file = vsg::fopen(filename, "rb");
+    if (!file) return false;
+
+    // the sizes recorded in the file are checked against the bytes remaining in it before allocating, so a truncated or corrupt file is treated as a cache miss
+    bool result = std::fseek(file, 0, SEEK_END) == 0;
+    long fileSize = result ? std::ftell(file) : -1L;
+    result = fileSize >= 0 && std::fseek(file, 0, SEEK_SET) == 0;
+
+    char signature[sizeof(s_spirvCacheSignature)];
+    uint32_t numStages = 0;
+    result = result && std::fread(signature, sizeof(signature), 1, file) == 1 && std::memcmp(signature, s_spirvCacheSignature, sizeof(signature)) == 0 &&
+             std::fread(&numStages, sizeof(numStages), 1, file) == 1 && numStages == shaders.size();
+
+    const uint32_t spirvMagicNumber = 0x07230203;
+
+    std::vector<ShaderModule::SPIRV> codes(shaders.size());
+    for (size_t i = 0; result && i < shaders.size(); ++i)
+    {
+        uint32_t stageAndSize[2];
+        result = std::fread(stageAndSize, sizeof(stageAndSize), 1, file) == 1 && stageAndSize[0] == static_cast<uint32_t>(shaders[i]->stage) && stageAndSize[1] > 0;
+        if (result)
+        {
+            long position = std::ftell(file);
+            result = position >= 0 && position <= fileSize && stageAndSize[1] <= static_cast<uint64_t>(fileSize - position) / sizeof(uint32_t);
+        }
+        if (result)
+        {
+            codes[i].resize(stageAndSize[1]);
+            result = std::fread(codes[i].data(), sizeof(uint32_t), codes[i].size(), file) == codes[i].size() && codes[i].front() == spirvMagicNumber;
+        }
+    }
+
+    std::fclose(file);
+
+    if (!result)
+    {
+        debug("ShaderCompiler : ignoring invalid SPIR-V cache file ", filename);
+        return false;
+    }
+
+    for (size_t i = 0; i < shaders.size(); ++i)
+    {
+        shaders[i]->module->code.swap(codes[i]);
+    }
+
+    debug("ShaderCompiler : read SPIR-V from cache file ", filename);
+    return true;
+}
+
+static void s_writeSpirvCache(const Path& filename, const ShaderStages& shaders)
+{
+    bool result = writeFileAtomically(filename, [&](FILE* file) {
+        uint32_t numStages = static_cast<uint32_t>(shaders.size());
+        bool written = std::fwrite(s_spirvCacheSignature, sizeof(s_spirvCacheSignature), 1, file) == 1 && std::fwrite(&numStages, sizeof(numStages), 1, file) == 1;
+        for (auto& vsg_shader : shaders)
+        {
+            auto& code = vsg_shader->module->code;
+            uint32_t stageAndSize[2] = {static_cast<uint32_t>(vsg_shader->stage), static_cast<uint32_t>(code.size())};
+            written = written && std::fwrite(stageAndSize, sizeof(stageAndSize), 1, file) == 1 && std::fwrite(code.data(), sizeof(uint32_t), code.size(), file) == code.size();
+        }
+        return written;
+    });
+
+    if (!result) debug("ShaderCompiler : unable to write SPIR-V cache file ", filename);
+}
+
 #endif
 
 std::string debugFormatShaderSource(const std::string& source)
@@ -121,6 +236,30 @@ bool ShaderCompiler::compile(ShaderStages& shaders, const std::vector<std::strin
         return "";
     };
 
+    // prepare the final source of each stage, used both as part of the cache key and as the input to glslang
+    std::vector<std::string> finalShaderSources;
+    finalShaderSources.reserve(shaders.size());
+    for (auto& vsg_shader : shaders)
+    {
+        auto settings = vsg_shader->module->hints ? vsg_shader->module->hints : defaults;
+
+        std::string finalShaderSource = vsg::insertIncludes(vsg_shader->module->source, options);
+
+        std::vector<std::string> combinedDefines(defines);
+        for (auto& define : settings->defines) combinedDefines.push_back(define);
+        if (!combinedDefines.empty()) finalShaderSource = combineSourceAndDefines(finalShaderSource, combinedDefines);
+
+        finalShaderSources.push_back(std::move(finalShaderSource));
+    }
+
+    // use previously compiled SPIR-V from the file cache when available
+    Path cacheFilename;
+    if (auto& cacheDirectory = (options && options->fileCache) ? options->fileCache : fileCache)
+    {
+        cacheFilename = cacheDirectory / "spirv" / s_spirvCacheKey(shaders, finalShaderSources, defaults);
+        if (s_readSpirvCache(cacheFilename, shaders)) return true;
+    }
+
     using StageShaderMap = std::map<EShLanguage, ref_ptr<ShaderStage>>;
     using TShaders = std::list<std::unique_ptr<glslang::TShader>>;
     TShaders tshaders;
@@ -130,8 +269,9 @@ bool ShaderCompiler::compile(ShaderStages& shaders, const std::vector<std::strin
     StageShaderMap stageShaderMap;
     std::unique_ptr<glslang::TProgram> program(new glslang::TProgram);
 
-    for (auto& vsg_shader : shaders)
+    for (size_t i = 0; i < shaders.size(); ++i)
     {
+        auto& vsg_shader = shaders[i];
         EShLanguage envStage = EShLangCount;
 
         glslang::EShTargetLanguageVersion minTargetLanguageVersion = glslang::EShTargetSpv_1_0;
@@ -202,11 +342,7 @@ bool ShaderCompiler::compile(ShaderStages& shaders, const std::vector<std::strin
         shader->setEnvClient(glslang::EShClientVulkan, targetClientVersion);
         shader->setEnvTarget(glslang::EShTargetSpv, targetLanguageVersion);
 
-        std::string finalShaderSource = vsg::insertIncludes(vsg_shader->module->source, options);
-
-        std::vector<std::string> combinedDefines(defines);
-        for (auto& define : settings->defines) combinedDefines.push_back(define);
-        if (!combinedDefines.empty()) finalShaderSource = combineSourceAndDefines(finalShaderSource, combinedDefines);
+        const std::string& finalShaderSource = finalShaderSources[i];
 
         const char* str = finalShaderSource.c_str();
         shader->setStrings(&str, 1);
@@ -288,6 +424,8 @@ bool ShaderCompiler::compile(ShaderStages& shaders, const std::vector<std::strin
         }
     }
 
+    if (cacheFilename) s_writeSpirvCache(cacheFilename, shaders);
+
     return true;
 }
 #else
@@ -19,25 +19,67 @@ bool SharedObjects::suitable(const Path& filename) const
     return excludedExtensions.count(vsg::lowerCaseFileExtension(filename)) == 0;
 }
 
-bool SharedObjects::contains(const Path& filename, ref_ptr<const Options> options) const
+Object* SharedObjects::_find(const TypedObjects& objects, const ref_ptr<Object>& object, std::size_t hash)
 {
-    std::scoped_lock<std::recursive_mutex> lock(_mutex);
+    if (hash != 0)
+    {
+        // compare() is only needed to confirm a match, or to resolve a hash collision
+        auto [begin, end] = objects.hashed.equal_range(hash);
+        for (auto itr = begin; itr != end; ++itr)
+        {
+            if (itr->second->compare(*object) == 0) return itr->second.get();
+        }
+        return nullptr;
+    }
+
+    if (auto itr = objects.ordered.find(object); itr != objects.ordered.end()) return itr->get();
+    return nullptr;
+}
 
+void SharedObjects::_insert(TypedObjects& objects, const ref_ptr<Object>& object, std::size_t hash)
+{
+    if (hash != 0)
+    {
+        if (!_find(objects, object, hash)) objects.hashed.emplace(hash, object);
+    }
+    else
+    {
+        objects.ordered.insert(object);
+    }
+}
+
+bool SharedObjects::_suitable(const Object* object)
+{
+    if (!suitableForSharing) return true;
+
+    // SuitableForSharing records its result in a member so serialize access to it
+    std::scoped_lock<std::mutex> lock(_suitableForSharingMutex);
+    return suitableForSharing->suitable(object);
+}
+
+bool SharedObjects::contains(const Path& filename, ref_ptr<const Options> options) const
+{
     auto loadedObject_id = std::type_index(typeid(LoadedObject));
-    auto itr = _sharedObjects.find(loadedObject_id);
-    if (itr == _sharedObjects.end()) return false;
+    auto& stripe = _stripe(loadedObject_id);
 
-    auto& loadedObjects = itr->second;
+    std::scoped_lock<std::recursive_mutex> lock(stripe.mutex);
+
+    auto itr = stripe.sharedObjects.find(loadedObject_id);
+    if (itr == stripe.sharedObjects.end()) return false;
+
+    auto& loadedObjects = itr->second.ordered;
     auto key = LoadedObject::create(filename, options);
     return loadedObjects.find(key) != loadedObjects.end();
 }
 
 void SharedObjects::add(ref_ptr<Object> object, const Path& filename, ref_ptr<const Options> options)
 {
-    std::scoped_lock<std::recursive_mutex> lock(_mutex);
-
     auto loadedObject_id = std::type_index(typeid(LoadedObject));
-    auto& loadedObjects = _sharedObjects[loadedObject_id];
+    auto& stripe = _stripe(loadedObject_id);
+
+    std::scoped_lock<std::recursive_mutex> lock(stripe.mutex);
+
+    auto& loadedObjects = stripe.sharedObjects[loadedObject_id].ordered;
 
     auto key = LoadedObject::create(filename, options, object);
     loadedObjects.insert(key);
@@ -45,13 +87,15 @@ void SharedObjects::add(ref_ptr<Object> object, const Path& filename, ref_ptr<co
 
 bool SharedObjects::remove(const Path& filename, ref_ptr<const Options> options)
 {
-    std::scoped_lock<std::recursive_mutex> lock(_mutex);
-
     auto loadedObject_id = std::type_index(typeid(LoadedObject));
-    auto itr = _sharedObjects.find(loadedObject_id);
-    if (itr == _sharedObjects.end()) return false;
+    auto& stripe = _stripe(loadedObject_id);
 
-    auto& loadedObjects = itr->second;
+    std::scoped_lock<std::recursive_mutex> lock(stripe.mutex);
+
+    auto itr = stripe.sharedObjects.find(loadedObject_id);
+    if (itr == stripe.sharedObjects.end()) return false;
+
+    auto& loadedObjects = itr->second.ordered;
 
     auto key = LoadedObject::create(filename, options);
     if (auto lo_itr = loadedObjects.find(key); lo_itr != loadedObjects.end())
@@ -67,19 +111,25 @@ bool SharedObjects::remove(const Path& filename, ref_ptr<const Options> options)
 
 void SharedObjects::clear()
 {
-    std::scoped_lock<std::recursive_mutex> lock(_mutex);
-    _defaults.clear();
-    _sharedObjects.clear();
+    for (auto& stripe : _stripes)
+    {
+        std::scoped_lock<std::recursive_mutex> lock(stripe.mutex);
+        stripe.defaults.clear();
+        stripe.sharedObjects.clear();
+    }
 }
 
 void SharedObjects::prune()
 {
-    std::scoped_lock<std::recursive_mutex> lock(_mutex);
+    // pruning follows references between objects of different types so lock all the stripes, always in the same order to avoid deadlocks
+    std::vector<std::unique_lock<std::recursive_mutex>> locks;
+    locks.reserve(numStripes);
+    for (auto& stripe : _stripes) locks.emplace_back(stripe.mutex);
 
     auto loadedObject_id = std::type_index(typeid(LoadedObject));
 
     // record observer pointers for each LoadedObject object so we can clear them to prevent local references keeping them from being pruned
-    auto& loadedObjects = _sharedObjects[loadedObject_id];
+    auto& loadedObjects = _stripe(loadedObject_id).sharedObjects[loadedObject_id].ordered;
     std::vector<observer_ptr<Object>> observedLoadedObjects(loadedObjects.size());
     auto observedLoadedObject_itr = observedLoadedObjects.begin();
     for (auto& object : loadedObjects)
@@ -90,30 +140,45 @@ void SharedObjects::prune()
     }
 
     // record observer pointers for each shared default object so we can clear them to prevent local references keeping them from being pruned
-    std::vector<observer_ptr<Object>> observedDefaults(_defaults.size());
-    auto observedDefaults_itr = observedDefaults.begin();
-    for (auto defaults_itr = _defaults.begin(); defaults_itr != _defaults.end(); ++defaults_itr)
+    std::vector<observer_ptr<Object>> observedDefaults;
+    for (auto& stripe : _stripes)
     {
-        *(observedDefaults_itr++) = defaults_itr->second;
+        for (auto& [id, object] : stripe.defaults)
+        {
+            observedDefaults.emplace_back(object);
+        }
+        stripe.defaults.clear();
     }
-    _defaults.clear();
 
     // prune SharedObjects that don't have external references (referenceCount == 1)
     bool prunedObjects = false;
     do
     {
         prunedObjects = false;
-        for (auto itr = _sharedObjects.begin(); itr != _sharedObjects.end(); ++itr)
+        for (auto& stripe : _stripes)
         {
-            auto id = itr->first;
-            if (id != loadedObject_id)
+            for (auto& [id, objects] : stripe.sharedObjects)
             {
-                auto& objects = itr->second;
-                for (auto object_itr = itr->second.begin(); object_itr != itr->second.end();)
+                if (id == loadedObject_id) continue;
+
+                for (auto object_itr = objects.ordered.begin(); object_itr != objects.ordered.end();)
                 {
                     if ((*object_itr)->referenceCount() == 1)
                     {
-                        object_itr = objects.erase(object_itr);
+                        object_itr = objects.ordered.erase(object_itr);
+                        prunedObjects = true;
+                    }
+                    else
+                    {
+                        ++object_itr;
+                    }
+                }
+
+                for (auto object_itr = objects.hashed.begin(); object_itr != objects.hashed.end();)
+                {
+                    if (object_itr->second->referenceCount() == 1)
+                    {
+                        object_itr = objects.hashed.erase(object_itr);
                         prunedObjects = true;
                     }
                     else
@@ -147,29 +212,51 @@ void SharedObjects::prune()
         if (defaultObject)
         {
             auto& object = *defaultObject;
-            _defaults[std::type_index(typeid(object))] = defaultObject;
+            auto id = std::type_index(typeid(object));
+            _stripe(id).defaults[id] = defaultObject;
         }
     }
 }
 
 void SharedObjects::report(std::ostream& out)
 {
-    std::scoped_lock<std::recursive_mutex> lock(_mutex);
+    std::vector<std::unique_lock<std::recursive_mutex>> locks;
+    locks.reserve(numStripes);
+    for (auto& stripe : _stripes) locks.emplace_back(stripe.mutex);
+
     out << "SharedObjects::report(..) " << this << std::endl;
-    out << "SharedObjects::_defaults " << _defaults.size() << std::endl;
-    for (auto& [type, object] : _defaults)
+
+    size_t numDefaults = 0;
+    for (auto& stripe : _stripes) numDefaults += stripe.defaults.size();
+
+    out << "SharedObjects::_defaults " << numDefaults << std::endl;
+    for (auto& stripe : _stripes)
     {
-        out << "    " << type.name() << ", object = " << object << " " << object->referenceCount() << std::endl;
+        for (auto& [type, object] : stripe.defaults)
+        {
+            out << "    " << type.name() << ", object = " << object << " " << object->referenceCount() << std::endl;
+        }
     }
 
-    out << "SharedObjects::_sharedObjects " << SharedObjects::_sharedObjects.size() << std::endl;
-    for (auto& [type, objects] : _sharedObjects)
+    size_t numTypes = 0;
+    for (auto& stripe : _stripes) numTypes += stripe.sharedObjects.size();
+
+    out << "SharedObjects::_sharedObjects " << numTypes << std::endl;
+    for (auto& stripe : _stripes)
     {
-        out << "    " << type.name() << ", objects = " << objects.size() << std::endl;
-        for (auto& object : objects)
+        for (auto& [type, objects] : stripe.sharedObjects)
         {
-            out << "        object = " << object << " "
-                << " " << object->referenceCount() << std::endl;
+            out << "    " << type.name() << ", objects = " << objects.ordered.size() + objects.hashed.size() << std::endl;
+            for (auto& object : objects.ordered)
+            {
+                out << "        object = " << object << " "
+                    << " " << object->referenceCount() << std::endl;
+            }
+            for (auto& [hash, object] : objects.hashed)
+            {
+                out << "        object = " << object << " "
+                    << " " << object->referenceCount() << std::endl;
+            }
         }
     }
 }
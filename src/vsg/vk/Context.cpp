@@ -129,6 +129,19 @@ Context::Context(Device* in_device, const ResourceRequirements& in_resourceRequi
     {
         vsg::debug("Context::Context() reusing descriptorPools = ", descriptorPools);
     }
+
+    pipelineCache = device->pipelineCache.ref_ptr();
+    if (!pipelineCache)
+    {
+        Path pipelineCacheFilename;
+        if (in_resourceRequirements.pipelineCacheDirectory) pipelineCacheFilename = PipelineCache::cacheFilename(in_resourceRequirements.pipelineCacheDirectory, device->getPhysicalDevice());
+        device->pipelineCache = pipelineCache = PipelineCache::create(device, pipelineCacheFilename);
+        vsg::debug("Context::Context() creating new pipelineCache = ", pipelineCache);
+    }
+    else
+    {
+        vsg::debug("Context::Context() reusing pipelineCache = ", pipelineCache);
+    }
 }
 
 Context::Context(const Context& context) :
@@ -143,6 +156,7 @@ Context::Context(const Context& context) :
     defaultPipelineStates(context.defaultPipelineStates),
     overridePipelineStates(context.overridePipelineStates),
     descriptorPools(context.descriptorPools),
+    pipelineCache(context.pipelineCache),
     graphicsQueue(context.graphicsQueue),
     commandPool(context.commandPool),
     deviceMemoryBufferPools(context.deviceMemoryBufferPools),
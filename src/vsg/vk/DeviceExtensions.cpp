@@ -42,6 +42,12 @@ DeviceExtensions::DeviceExtensions(Device* device)
 
     device->getProcAddr(vkGetBufferDeviceAddressKHR, "vkGetBufferDeviceAddressKHR");
 
+    // VK_KHR_draw_indirect_count
+    if (device->supportsApiVersion(VK_API_VERSION_1_2))
+        device->getProcAddr(vkCmdDrawIndexedIndirectCount, "vkCmdDrawIndexedIndirectCount");
+    else if (device->getPhysicalDevice()->supportsDeviceExtension(VK_KHR_DRAW_INDIRECT_COUNT_EXTENSION_NAME))
+        device->getProcAddr(vkCmdDrawIndexedIndirectCount, "vkCmdDrawIndexedIndirectCountKHR");
+
     // VK_EXT_mesh_shader
     device->getProcAddr(vkCmdDrawMeshTasksEXT, "vkCmdDrawMeshTasksEXT");
     device->getProcAddr(vkCmdDrawMeshTasksIndirectEXT, "vkCmdDrawMeshTasksIndirectEXT");
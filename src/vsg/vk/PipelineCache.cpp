@@ -0,0 +1,176 @@
+/* <editor-fold desc="MIT License">
+
+Copyright(c) 2024 Robert Osfield
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"), to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+</editor-fold> */
+
+#include <vsg/core/Exception.h>
+#include <vsg/core/compare.h>
+#include <vsg/io/FileSystem.h>
+#include <vsg/io/Logger.h>
+#include <vsg/vk/PipelineCache.h>
+
+#include <cstring>
+#include <iomanip>
+#include <sstream>
+
+using namespace vsg;
+
+namespace
+{
+    // file layout: Header followed by the data returned by vkGetPipelineCacheData
+    struct Header
+    {
+        char signature[8] = {'v', 's', 'g', 'p', 'c', '0', '0', '1'};
+        uint32_t driverVersion = 0;
+        uint32_t reserved = 0;
+        uint64_t dataSize = 0;
+        uint64_t dataHash = 0;
+    };
+} // namespace
+
+PipelineCache::PipelineCache(Device* device, const Path& in_filename) :
+    filename(in_filename),
+    _device(device)
+{
+    std::vector<uint8_t> initialData;
+    if (filename && !_read(initialData)) initialData.clear();
+
+    VkPipelineCacheCreateInfo createInfo = {};
+    createInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_CACHE_CREATE_INFO;
+    createInfo.pNext = nullptr;
+    createInfo.flags = 0;
+    createInfo.initialDataSize = initialData.size();
+    createInfo.pInitialData = initialData.empty() ? nullptr : initialData.data();
+
+    if (VkResult result = vkCreatePipelineCache(*device, &createInfo, _device->getAllocationCallbacks(), &_pipelineCache); result != VK_SUCCESS)
+    {
+        throw Exception{"Error: Failed to create PipelineCache.", result};
+    }
+}
+
+PipelineCache::~PipelineCache()
+{
+    if (_pipelineCache)
+    {
+        if (filename) write();
+
+        vkDestroyPipelineCache(*_device, _pipelineCache, _device->getAllocationCallbacks());
+    }
+}
+
+Path PipelineCache::cacheFilename(const Path& directory, const PhysicalDevice* physicalDevice)
+{
+    auto& properties = physicalDevice->getProperties();
+
+    std::ostringstream str;
+    str << std::hex << std::setfill('0');
+    for (auto value : properties.pipelineCacheUUID) str << std::setw(2) << static_cast<uint32_t>(value);
+    str << "_" << std::setw(8) << properties.driverVersion << ".bin";
+
+    return directory / "pipelines" / str.str();
+}
+
+bool PipelineCache::_read(std::vector<uint8_t>& data) const
+{
+    auto file = vsg::fopen(filename, "rb");
+    if (!file) return false;
+
+    Header header;
+    Header expected;
+    bool result = std::fread(&header, sizeof(header), 1, file) == 1 && std::memcmp(header.signature, expected.signature, sizeof(header.signature)) == 0;
+
+    auto& properties = _device->getPhysicalDevice()->getProperties();
+    result = result && header.driverVersion == properties.driverVersion;
+
+    // check the data size against the size of the file before allocating, so a corrupt header can't request an arbitrarily large allocation
+    if (result)
+    {
+        result = std::fseek(file, 0, SEEK_END) == 0;
+        auto fileSize = result ? std::ftell(file) : -1L;
+        result = fileSize >= static_cast<long>(sizeof(header)) && header.dataSize == static_cast<uint64_t>(fileSize) - sizeof(header) &&
+                 std::fseek(file, static_cast<long>(sizeof(header)), SEEK_SET) == 0;
+    }
+
+    if (result)
+    {
+        data.resize(static_cast<size_t>(header.dataSize));
+        result = std::fread(data.data(), 1, data.size(), file) == data.size() && static_cast<uint64_t>(hash_memory(data.data(), data.size())) == header.dataHash;
+    }
+
+    std::fclose(file);
+
+    // check the header written by the driver, see VkPipelineCacheHeaderVersionOne
+    if (result)
+    {
+        uint32_t headerSize = 0, headerVersion = 0, vendorID = 0, deviceID = 0;
+        result = data.size() >= 16 + VK_UUID_SIZE;
+        if (result)
+        {
+            std::memcpy(&headerSize, data.data(), 4);
+            std::memcpy(&headerVersion, data.data() + 4, 4);
+            std::memcpy(&vendorID, data.data() + 8, 4);
+            std::memcpy(&deviceID, data.data() + 12, 4);
+            result = headerSize >= 16 + VK_UUID_SIZE && headerSize <= data.size() && headerVersion == VK_PIPELINE_CACHE_HEADER_VERSION_ONE &&
+                     vendorID == properties.vendorID && deviceID == properties.deviceID &&
+                     std::memcmp(data.data() + 16, properties.pipelineCacheUUID, VK_UUID_SIZE) == 0;
+        }
+    }
+
+    if (result)
+    {
+        debug("PipelineCache : read ", data.size(), " bytes from ", filename);
+    }
+    else
+    {
+        info("PipelineCache : ignoring invalid or incompatible pipeline cache file ", filename);
+    }
+
+    return result;
+}
+
+std::vector<uint8_t> PipelineCache::getData() const
+{
+    std::vector<uint8_t> data;
+
+    size_t dataSize = 0;
+    if (vkGetPipelineCacheData(*_device, _pipelineCache, &dataSize, nullptr) != VK_SUCCESS) return data;
+
+    data.resize(dataSize);
+    if (dataSize > 0 && vkGetPipelineCacheData(*_device, _pipelineCache, &dataSize, data.data()) != VK_SUCCESS) data.clear();
+    data.resize(dataSize);
+
+    return data;
+}
+
+bool PipelineCache::write() const
+{
+    if (!filename) return false;
+
+    auto data = getData();
+    if (data.empty()) return false;
+
+    Header header;
+    header.driverVersion = _device->getPhysicalDevice()->getProperties().driverVersion;
+    header.dataSize = data.size();
+    header.dataHash = hash_memory(data.data(), data.size());
+
+    bool result = writeFileAtomically(filename, [&](FILE* file) {
+        return std::fwrite(&header, sizeof(header), 1, file) == 1 && std::fwrite(data.data(), 1, data.size(), file) == data.size();
+    });
+
+    if (!result)
+    {
+        warn("PipelineCache : unable to write ", filename);
+        return false;
+    }
+
+    debug("PipelineCache : written ", data.size(), " bytes to ", filename);
+    return true;
+}
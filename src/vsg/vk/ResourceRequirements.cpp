@@ -14,6 +14,7 @@ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLI
 #include <vsg/commands/BindIndexBuffer.h>
 #include <vsg/commands/BindVertexBuffers.h>
 #include <vsg/nodes/Bin.h>
+#include <vsg/nodes/CulledInstanceDraw.h>
 #include <vsg/nodes/DepthSorted.h>
 #include <vsg/nodes/Geometry.h>
 #include <vsg/nodes/Group.h>
@@ -74,6 +75,8 @@ void ResourceRequirements::apply(const ResourceHints& resourceHints)
     numLightsRange = resourceHints.numLightsRange;
     numShadowMapsRange = resourceHints.numShadowMapsRange;
     shadowMapSize = resourceHints.shadowMapSize;
+
+    if (resourceHints.pipelineCacheDirectory) pipelineCacheDirectory = resourceHints.pipelineCacheDirectory;
 }
 
 //////////////////////////////////////////////////////////////////////
@@ -272,6 +275,13 @@ void CollectResourceRequirements::apply(const VertexIndexDraw& vid)
     apply(vid.indices);
 }
 
+void CollectResourceRequirements::apply(const CulledInstanceDraw& cid)
+{
+    cid.bindDescriptorSet->accept(*this);
+    for (auto& bufferInfo : cid.arrays) apply(bufferInfo);
+    apply(cid.indices);
+}
+
 void CollectResourceRequirements::apply(const BindVertexBuffers& bvb)
 {
     for (auto& bufferInfo : bvb.arrays) apply(bufferInfo);